@@ -21,7 +21,8 @@ if not exist "build" mkdir build
 if not exist "bin" mkdir bin
 
 echo [2/3] Compiling...
-g++ -std=c++11 -Wall -Iinclude -o bin\fast-scorebook.exe src\main.cpp
+g++ -std=c++11 -Wall -pthread -Iinclude -o bin\fast-scorebook.exe src\main.cpp
+if %ERRORLEVEL% EQU 0 g++ -std=c++11 -Wall -pthread -Iinclude -O2 -o bin\fast-scorebook-import.exe src\import.cpp
 
 if %ERRORLEVEL% NEQ 0 (
     echo.
@@ -0,0 +1,149 @@
+#ifndef ADMISSIONCONTROL_H
+#define ADMISSIONCONTROL_H
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+enum class AdmissionVerdict {
+    ADMITTED,
+    SCORER_LIMITED,     // This scorer is over their own rate
+    GLOBAL_LIMITED      // The scorebook is over its total ingest budget
+};
+
+// Rates in entries per second; bursts in entries
+struct AdmissionPolicy {
+    double scorerRate;
+    double scorerBurst;
+    double globalRate;
+    double globalBurst;
+
+    // A ball every few seconds is brisk scoring; corrections and catch-up come in bursts
+    AdmissionPolicy(double sRate = 20, double sBurst = 60, double gRate = 2000, double gBurst = 4000)
+        : scorerRate(sRate), scorerBurst(sBurst), globalRate(gRate), globalBurst(gBurst) {}
+};
+
+struct TokenBucket {
+    double tokens;
+    int64_t lastMicros;
+
+    TokenBucket() : tokens(0), lastMicros(0) {}
+
+    void refill(double rate, double burst, int64_t nowMicros) {
+        if(nowMicros > lastMicros) {
+            tokens += (nowMicros - lastMicros) * rate / 1e6;
+            if(tokens > burst) tokens = burst;
+            lastMicros = nowMicros;
+        }
+    }
+
+    // Milliseconds until a whole token is back
+    uint32_t waitMs(double rate) const {
+        if(tokens >= 1 || rate <= 0) return 0;
+        return (uint32_t)((1 - tokens) * 1000 / rate) + 1;
+    }
+};
+
+struct ScorerAdmission {
+    TokenBucket bucket;
+    uint64_t admitted;
+    uint64_t throttled;
+
+    ScorerAdmission() : admitted(0), throttled(0) {}
+};
+
+// Token-bucket rate limits on scorer entries: one bucket per scorer and
+// one for the whole scorebook. An entry takes a token from both, and a
+// scorer over their own limit is refused before touching the shared
+// budget, so a flooding scorer can use at most their own rate of it.
+// Refusals say how long to back off. Used from the scoring thread only.
+class AdmissionControl {
+private:
+    AdmissionPolicy policy;
+    TokenBucket global;
+    unordered_map<string, ScorerAdmission> scorers;
+    chrono::steady_clock::time_point epoch;
+    uint32_t retryAfterMs;
+
+    uint64_t admitted;
+    uint64_t scorerLimited;
+    uint64_t globalLimited;
+
+public:
+    AdmissionControl(const AdmissionPolicy& p = AdmissionPolicy())
+        : policy(p), epoch(chrono::steady_clock::now()), retryAfterMs(0), admitted(0),
+          scorerLimited(0), globalLimited(0) {
+        global.tokens = policy.globalBurst;
+    }
+
+    int64_t nowMicros() const {
+        return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - epoch).count();
+    }
+
+    AdmissionVerdict admit(const string& userId) { return admit(userId, nowMicros()); }
+
+    AdmissionVerdict admit(const string& userId, int64_t now) {
+        auto it = scorers.find(userId);
+        if(it == scorers.end()) {
+            it = scorers.insert(make_pair(userId, ScorerAdmission())).first;
+            it->second.bucket.tokens = policy.scorerBurst;
+            it->second.bucket.lastMicros = now;
+        }
+        ScorerAdmission& s = it->second;
+        s.bucket.refill(policy.scorerRate, policy.scorerBurst, now);
+        global.refill(policy.globalRate, policy.globalBurst, now);
+
+        if(s.bucket.tokens < 1) {
+            retryAfterMs = s.bucket.waitMs(policy.scorerRate);
+            s.throttled++;
+            scorerLimited++;
+            return AdmissionVerdict::SCORER_LIMITED;
+        }
+        if(global.tokens < 1) {
+            retryAfterMs = global.waitMs(policy.globalRate);
+            s.throttled++;
+            globalLimited++;
+            return AdmissionVerdict::GLOBAL_LIMITED;
+        }
+        s.bucket.tokens -= 1;
+        global.tokens -= 1;
+        s.admitted++;
+        admitted++;
+        retryAfterMs = 0;
+        return AdmissionVerdict::ADMITTED;
+    }
+
+    // Back-off for the last refused entry
+    uint32_t getRetryAfterMs() const { return retryAfterMs; }
+
+    void setPolicy(const AdmissionPolicy& p) { policy = p; }
+    const AdmissionPolicy& getPolicy() const { return policy; }
+
+    uint64_t getAdmitted() const { return admitted; }
+    uint64_t getScorerLimited() const { return scorerLimited; }
+    uint64_t getGlobalLimited() const { return globalLimited; }
+
+    uint64_t getThrottled(const string& userId) const {
+        auto it = scorers.find(userId);
+        return it == scorers.end() ? 0 : it->second.throttled;
+    }
+
+    void displayStats() const {
+        cout << "Admission control: " << admitted << " admitted, " << scorerLimited
+             << " over a scorer's limit, " << globalLimited << " over the ingest budget ("
+             << policy.scorerRate << "/s per scorer, " << policy.globalRate << "/s in all)" << endl;
+        map<string, ScorerAdmission> sorted(scorers.begin(), scorers.end());
+        for(const auto& s : sorted) {
+            if(s.second.throttled == 0) continue;
+            cout << "  " << s.first << ": " << s.second.admitted << " admitted, "
+                 << s.second.throttled << " throttled" << endl;
+        }
+    }
+};
+
+#endif
@@ -37,6 +37,21 @@ enum class WicketType {
     TIMED_OUT
 };
 
+// Dismissals credited to the bowler; run outs, obstructing the field,
+// hitting the ball twice and timed out are not
+inline bool isBowlerWicket(WicketType type) {
+    switch(type) {
+        case WicketType::NONE:
+        case WicketType::RUN_OUT:
+        case WicketType::OBSTRUCTING_FIELD:
+        case WicketType::HIT_BALL_TWICE:
+        case WicketType::TIMED_OUT:
+            return false;
+        default:
+            return true;
+    }
+}
+
 class Ball {
 private:
     int overNumber;
@@ -49,21 +64,32 @@ private:
     BallOutcome outcome;
     WicketType wicketType;
     Player* fielderInvolved; // For catches, run-outs
+    PlayerId bowlerId;
+    PlayerId batsmanId;
+    PlayerId nonStrikerId;
+    PlayerId fielderId;
     bool isValid; // false for wides, no-balls
     string commentary;
     time_t timestamp;
     
+    static PlayerId idOf(const Player* p) {
+        return p ? p->getRegistryId() : INVALID_PLAYER_ID;
+    }
+    
 public:
     Ball() : overNumber(0), ballNumber(0), bowler(nullptr), batsman(nullptr),
              nonStriker(nullptr), runs(0), extras(0), outcome(BallOutcome::DOT_BALL),
-             wicketType(WicketType::NONE), fielderInvolved(nullptr), 
+             wicketType(WicketType::NONE), fielderInvolved(nullptr),
+             bowlerId(INVALID_PLAYER_ID), batsmanId(INVALID_PLAYER_ID),
+             nonStrikerId(INVALID_PLAYER_ID), fielderId(INVALID_PLAYER_ID),
              isValid(true), commentary(""), timestamp(time(0)) {}
     
     Ball(int over, int ball, Player* bow, Player* bat, Player* nonStrk)
         : overNumber(over), ballNumber(ball), bowler(bow), batsman(bat),
           nonStriker(nonStrk), runs(0), extras(0), outcome(BallOutcome::DOT_BALL),
           wicketType(WicketType::NONE), fielderInvolved(nullptr),
-          isValid(true), commentary(""), timestamp(time(0)) {}
+          bowlerId(idOf(bow)), batsmanId(idOf(bat)), nonStrikerId(idOf(nonStrk)),
+          fielderId(INVALID_PLAYER_ID), isValid(true), commentary(""), timestamp(time(0)) {}
     
     void recordBall(BallOutcome out, int r, int ext = 0) {
         outcome = out;
@@ -79,10 +105,19 @@ public:
     void recordWicket(WicketType type, Player* fielder = nullptr) {
         wicketType = type;
         fielderInvolved = fielder;
+        fielderId = idOf(fielder);
         outcome = BallOutcome::WICKET;
     }
     
     string getOutcomeString() const {
+        return outcomeToString(outcome);
+    }
+    
+    string getWicketTypeString() const {
+        return wicketTypeToString(wicketType);
+    }
+    
+    static string outcomeToString(BallOutcome outcome) {
         switch(outcome) {
             case BallOutcome::DOT_BALL: return "Dot Ball";
             case BallOutcome::SINGLE: return "1 Run";
@@ -100,7 +135,7 @@ public:
         }
     }
     
-    string getWicketTypeString() const {
+    static string wicketTypeToString(WicketType wicketType) {
         switch(wicketType) {
             case WicketType::NONE: return "Not Out";
             case WicketType::BOWLED: return "Bowled";
@@ -144,6 +179,12 @@ public:
     int getBallNumber() const { return ballNumber; }
     Player* getBowler() const { return bowler; }
     Player* getBatsman() const { return batsman; }
+    Player* getNonStriker() const { return nonStriker; }
+    Player* getFielder() const { return fielderInvolved; }
+    PlayerId getBowlerId() const { return bowlerId; }
+    PlayerId getBatsmanId() const { return batsmanId; }
+    PlayerId getNonStrikerId() const { return nonStrikerId; }
+    PlayerId getFielderId() const { return fielderId; }
     int getRuns() const { return runs; }
     int getExtras() const { return extras; }
     int getTotalRuns() const { return runs + extras; }
@@ -151,9 +192,11 @@ public:
     WicketType getWicketType() const { return wicketType; }
     bool getIsValid() const { return isValid; }
     time_t getTimestamp() const { return timestamp; }
+    string getCommentary() const { return commentary; }
     
     // Setters
     void setCommentary(string comm) { commentary = comm; }
+    void setTimestamp(time_t t) { timestamp = t; }
 };
 
 #endif
@@ -0,0 +1,196 @@
+#ifndef CAREERSTATS_H
+#define CAREERSTATS_H
+
+#include "DeliveryQuery.h"
+#include "DeliveryKernels.h"
+#include "PlayerRegistry.h"
+
+// Career figures recomputed from raw deliveries
+struct CareerLine {
+    // Batting
+    uint64_t runsScored;
+    uint64_t ballsFaced;
+    uint64_t fours;
+    uint64_t sixes;
+    uint64_t dotsFaced;
+    uint64_t dismissals;
+    // Bowling
+    uint64_t ballsBowled;
+    uint64_t runsConceded;
+    uint64_t wicketsTaken;
+    uint64_t dotsBowled;
+
+    CareerLine() : runsScored(0), ballsFaced(0), fours(0), sixes(0), dotsFaced(0), dismissals(0),
+                   ballsBowled(0), runsConceded(0), wicketsTaken(0), dotsBowled(0) {}
+
+    double getStrikeRate() const { return ballsFaced ? runsScored * 100.0 / ballsFaced : 0.0; }
+    double getBattingAverage() const { return dismissals ? runsScored / (double)dismissals : 0.0; }
+    double getEconomy() const { return ballsBowled ? runsConceded * 6.0 / ballsBowled : 0.0; }
+    double getBowlingAverage() const { return wicketsTaken ? runsConceded / (double)wicketsTaken : 0.0; }
+
+    // Share of balls faced that went for four or six
+    double getBoundaryPercentage() const {
+        return ballsFaced ? (fours + sixes) * 100.0 / ballsFaced : 0.0;
+    }
+
+    // Overwrite the running totals in PlayerStats with these figures
+    void applyTo(PlayerStats& stats) const {
+        stats.runsScored = (int)runsScored;
+        stats.ballsFaced = (int)ballsFaced;
+        stats.fours = (int)fours;
+        stats.sixes = (int)sixes;
+        stats.ballsBowled = (int)ballsBowled;
+        stats.runsConceded = (int)runsConceded;
+        stats.wicketsTaken = (int)wicketsTaken;
+        stats.strikeRate = getStrikeRate();
+        stats.battingAverage = getBattingAverage();
+        stats.economy = getEconomy();
+        stats.bowlingAverage = getBowlingAverage();
+    }
+};
+
+// Recomputes every player's career line from delivery partitions.
+//
+// build() lays the deliveries out twice with a counting sort: once grouped
+// by batter and once by bowler, keeping only the byte columns the stats
+// need. After that each player's deliveries are one contiguous range, and
+// compute() reduces each range with the DeliveryKernels.
+class CareerStatsBuilder {
+private:
+    static const int OUTCOME_BINS = 12;
+    static const int WICKET_BINS = 12;
+
+    size_t playerCount;
+
+    // Batting layout, grouped by batter
+    vector<size_t> batStart;     // playerCount + 1 offsets
+    vector<uint8_t> batRuns;     // Runs off the bat
+    vector<uint8_t> batOutcome;
+    vector<uint8_t> batWicket;
+
+    // Bowling layout, grouped by bowler
+    vector<size_t> bowlStart;
+    vector<uint8_t> bowlConceded; // Bat runs plus wides and no-balls
+    vector<uint8_t> bowlOutcome;
+    vector<uint8_t> bowlWicket;
+    vector<uint8_t> bowlFlags;
+
+    static bool isBye(uint8_t outcome) {
+        return outcome == (uint8_t)BallOutcome::BYE || outcome == (uint8_t)BallOutcome::LEG_BYE;
+    }
+
+    // Turn per-player counts into start offsets; returns the total
+    static size_t prefixSum(vector<size_t>& start) {
+        size_t total = 0;
+        for(size_t p = 0; p < start.size(); p++) {
+            size_t count = start[p];
+            start[p] = total;
+            total += count;
+        }
+        return total;
+    }
+
+public:
+    CareerStatsBuilder() : playerCount(0) {}
+
+    void build(const vector<DeliveryColumns>& partitions, size_t players) {
+        playerCount = players;
+        batStart.assign(playerCount + 1, 0);
+        bowlStart.assign(playerCount + 1, 0);
+
+        for(const auto& cols : partitions) {
+            for(size_t i = 0; i < cols.size(); i++) {
+                if(cols.batter[i] < playerCount) batStart[cols.batter[i]]++;
+                if(cols.bowler[i] < playerCount) bowlStart[cols.bowler[i]]++;
+            }
+        }
+        size_t batTotal = prefixSum(batStart);
+        size_t bowlTotal = prefixSum(bowlStart);
+
+        batRuns.resize(batTotal);
+        batOutcome.resize(batTotal);
+        batWicket.resize(batTotal);
+        bowlConceded.resize(bowlTotal);
+        bowlOutcome.resize(bowlTotal);
+        bowlWicket.resize(bowlTotal);
+        bowlFlags.resize(bowlTotal);
+
+        vector<size_t> batNext(batStart.begin(), batStart.end() - 1);
+        vector<size_t> bowlNext(bowlStart.begin(), bowlStart.end() - 1);
+        for(const auto& cols : partitions) {
+            for(size_t i = 0; i < cols.size(); i++) {
+                uint8_t outcome = cols.outcome[i];
+                uint8_t runs = isBye(outcome) ? 0 : cols.runs[i];
+                if(cols.batter[i] < playerCount) {
+                    size_t at = batNext[cols.batter[i]]++;
+                    batRuns[at] = runs;
+                    batOutcome[at] = outcome;
+                    batWicket[at] = cols.wicketType[i];
+                }
+                if(cols.bowler[i] < playerCount) {
+                    size_t at = bowlNext[cols.bowler[i]]++;
+                    bowlConceded[at] = (uint8_t)(runs + cols.extras[i]);
+                    bowlOutcome[at] = outcome;
+                    bowlWicket[at] = cols.wicketType[i];
+                    bowlFlags[at] = cols.flags[i];
+                }
+            }
+        }
+    }
+
+    // Career line for every PlayerId, computed in parallel over players
+    vector<CareerLine> compute(TaskPool& pool = TaskPool::shared()) const {
+        vector<CareerLine> lines(playerCount);
+        pool.parallelFor(0, playerCount, 64, [&](size_t p0, size_t p1) {
+            for(size_t p = p0; p < p1; p++) {
+                CareerLine& line = lines[p];
+                uint64_t outcomes[OUTCOME_BINS];
+                uint64_t wickets[WICKET_BINS];
+
+                size_t at = batStart[p];
+                size_t n = batStart[p + 1] - at;
+                if(n > 0) {
+                    memset(outcomes, 0, sizeof(outcomes));
+                    memset(wickets, 0, sizeof(wickets));
+                    DeliveryKernels::histogram(&batOutcome[at], n, outcomes, OUTCOME_BINS);
+                    DeliveryKernels::histogram(&batWicket[at], n, wickets, WICKET_BINS);
+                    line.runsScored = DeliveryKernels::sum(&batRuns[at], n);
+                    line.ballsFaced = n - outcomes[(int)BallOutcome::WIDE];
+                    line.fours = outcomes[(int)BallOutcome::FOUR];
+                    line.sixes = outcomes[(int)BallOutcome::SIX];
+                    line.dotsFaced = outcomes[(int)BallOutcome::DOT_BALL];
+                    line.dismissals = n - wickets[(int)WicketType::NONE];
+                }
+
+                at = bowlStart[p];
+                n = bowlStart[p + 1] - at;
+                if(n > 0) {
+                    memset(outcomes, 0, sizeof(outcomes));
+                    memset(wickets, 0, sizeof(wickets));
+                    DeliveryKernels::histogram(&bowlWicket[at], n, wickets, WICKET_BINS);
+                    line.runsConceded = DeliveryKernels::sum(&bowlConceded[at], n);
+                    line.ballsBowled = DeliveryKernels::countMasked(&bowlFlags[at], n, DELIVERY_VALID, DELIVERY_VALID);
+                    line.dotsBowled = DeliveryKernels::countEqual(&bowlOutcome[at], n, (uint8_t)BallOutcome::DOT_BALL);
+                    line.wicketsTaken = 0;
+                    for(int t = 0; t < WICKET_BINS; t++) {
+                        if(isBowlerWicket((WicketType)t)) line.wicketsTaken += wickets[t];
+                    }
+                }
+            }
+        });
+        return lines;
+    }
+
+    size_t getPlayerCount() const { return playerCount; }
+    size_t getBattingDeliveries() const { return batRuns.size(); }
+    size_t getBowlingDeliveries() const { return bowlConceded.size(); }
+
+    // Write recomputed figures back into every registered player's stats
+    static void applyToRegistry(const vector<CareerLine>& lines, PlayerRegistry& registry) {
+        for(size_t p = 0; p < lines.size() && p < registry.size(); p++) {
+            lines[p].applyTo(registry.getPlayer((PlayerId)p)->getStats());
+        }
+    }
+};
+
+#endif
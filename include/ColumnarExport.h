@@ -0,0 +1,465 @@
+#ifndef COLUMNAREXPORT_H
+#define COLUMNAREXPORT_H
+
+#include "MatchArchive.h"
+#include "DeliveryCodec.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <unordered_map>
+
+// ---------------------------------------------------------------------------
+// Columnar delivery file (modelled on the Arrow IPC file format)
+//
+//   magic "FSBCOLS1"
+//   schema message: one ColumnSchema per column
+//   dictionary and record batch messages, in any interleaving
+//   end-of-stream message
+//   footer: uint64 offset of every record batch, then ColumnFooter
+//
+// Every message is a ColumnMessage header followed by bodyLength bytes.
+// A record batch body holds each column as a contiguous little-endian
+// array of rowCount fixed-width values, each padded to 8 bytes, so a
+// reader can use the buffers in place (e.g. numpy.frombuffer).
+// Player and venue columns hold indexes into dictionaries. Dictionaries
+// are sent as deltas before the first batch that uses new entries; a
+// dictionary body is uint32 offsets[count + 1] followed by UTF-8 text.
+// ---------------------------------------------------------------------------
+
+const char COLUMNAR_MAGIC[8] = {'F', 'S', 'B', 'C', 'O', 'L', 'S', '1'};
+const uint32_t COLUMNAR_NULL = 0xFFFFFFFF;
+
+enum ColumnType {
+    COLUMN_UINT8 = 1,
+    COLUMN_UINT16 = 2,
+    COLUMN_UINT32 = 4,
+    COLUMN_INT64 = 8        // Value is the byte width
+};
+
+enum ColumnDictionary {
+    DICTIONARY_NONE = 0,
+    DICTIONARY_PLAYERS = 1,
+    DICTIONARY_VENUES = 2
+};
+
+enum ColumnMessageKind {
+    MESSAGE_SCHEMA = 1,
+    MESSAGE_DICTIONARY = 2,
+    MESSAGE_RECORD_BATCH = 3,
+    MESSAGE_END = 4
+};
+
+enum DeliveryColumn {
+    COL_MATCH,
+    COL_INNINGS,
+    COL_OVER,
+    COL_BALL,
+    COL_BATTER,
+    COL_NON_STRIKER,
+    COL_BOWLER,
+    COL_FIELDER,
+    COL_VENUE,
+    COL_OUTCOME,
+    COL_WICKET_TYPE,
+    COL_RUNS,
+    COL_EXTRAS,
+    COL_LEGAL,
+    COL_TIMESTAMP,
+    DELIVERY_COLUMN_COUNT
+};
+
+struct ColumnSchema {
+    char name[24];
+    uint32_t type;          // ColumnType
+    uint32_t dictionary;    // ColumnDictionary
+};
+
+struct ColumnMessage {
+    uint32_t kind;          // ColumnMessageKind
+    uint32_t dictionary;    // Dictionary batches: which dictionary
+    uint32_t count;         // Rows, dictionary entries or schema columns
+    uint32_t firstEntry;    // Dictionary batches: index of the first entry
+    uint64_t bodyLength;
+};
+
+struct ColumnFooter {
+    uint64_t batchCount;
+    uint64_t rowCount;
+    char magic[8];
+};
+
+static_assert(sizeof(ColumnSchema) == 32, "column schema layout changed");
+static_assert(sizeof(ColumnMessage) == 24, "column message layout changed");
+static_assert(sizeof(ColumnFooter) == 24, "column footer layout changed");
+
+// Schema of the delivery table
+inline const ColumnSchema* deliveryColumnSchema() {
+    static const ColumnSchema schema[DELIVERY_COLUMN_COUNT] = {
+        {"match", COLUMN_UINT32, DICTIONARY_NONE},
+        {"innings", COLUMN_UINT8, DICTIONARY_NONE},
+        {"over", COLUMN_UINT16, DICTIONARY_NONE},
+        {"ball", COLUMN_UINT8, DICTIONARY_NONE},
+        {"batter", COLUMN_UINT32, DICTIONARY_PLAYERS},
+        {"non_striker", COLUMN_UINT32, DICTIONARY_PLAYERS},
+        {"bowler", COLUMN_UINT32, DICTIONARY_PLAYERS},
+        {"fielder", COLUMN_UINT32, DICTIONARY_PLAYERS},
+        {"venue", COLUMN_UINT32, DICTIONARY_VENUES},
+        {"outcome", COLUMN_UINT8, DICTIONARY_NONE},
+        {"wicket_type", COLUMN_UINT8, DICTIONARY_NONE},
+        {"runs", COLUMN_UINT8, DICTIONARY_NONE},
+        {"extras", COLUMN_UINT8, DICTIONARY_NONE},
+        {"legal", COLUMN_UINT8, DICTIONARY_NONE},
+        {"timestamp", COLUMN_INT64, DICTIONARY_NONE}
+    };
+    return schema;
+}
+
+// Name -> index dictionary that remembers which entries were already written
+class ExportDictionary {
+private:
+    vector<string> entries;
+    unordered_map<string, uint32_t> index;
+    size_t written;
+
+public:
+    ExportDictionary() : written(0) {}
+
+    uint32_t lookup(const string& name) {
+        auto it = index.find(name);
+        if(it != index.end()) return it->second;
+        uint32_t id = (uint32_t)entries.size();
+        entries.push_back(name);
+        index[name] = id;
+        return id;
+    }
+
+    // Same, without building a string when the name is already known
+    uint32_t lookup(const char* data, size_t length, string& scratch) {
+        scratch.assign(data, length);
+        return lookup(scratch);
+    }
+
+    size_t size() const { return entries.size(); }
+    size_t getWritten() const { return written; }
+    const string& get(size_t i) const { return entries[i]; }
+    void markWritten() { written = entries.size(); }
+};
+
+// Streams deliveries into a columnar file, one record batch at a time.
+// Only the current batch and the dictionaries are held in memory.
+class ColumnarWriter {
+private:
+    ofstream out;
+    uint64_t position;
+    size_t batchRows;
+    size_t rowsInBatch;
+    uint64_t totalRows;
+    vector<uint64_t> batchOffsets;
+    vector<vector<char>> columns;   // Current batch, one buffer per column
+    ExportDictionary players;
+    ExportDictionary venues;
+    string scratch;
+    vector<uint32_t> playerMap;     // Snapshot player index -> dictionary index
+    unordered_map<const Player*, uint32_t> livePlayers;
+
+    static size_t pad8(size_t n) { return (n + 7) & ~(size_t)7; }
+
+    void writeBytes(const void* data, size_t length) {
+        out.write((const char*)data, length);
+        position += length;
+    }
+
+    void writePadding(size_t length) {
+        static const char zeros[8] = {0};
+        size_t padded = pad8(length) - length;
+        if(padded) writeBytes(zeros, padded);
+    }
+
+    void writeMessage(uint32_t kind, uint32_t dictionary, uint32_t count, uint32_t firstEntry, uint64_t bodyLength) {
+        ColumnMessage m;
+        m.kind = kind;
+        m.dictionary = dictionary;
+        m.count = count;
+        m.firstEntry = firstEntry;
+        m.bodyLength = bodyLength;
+        writeBytes(&m, sizeof(m));
+    }
+
+    void writeDictionaryDelta(ExportDictionary& dict, uint32_t id) {
+        size_t first = dict.getWritten();
+        size_t count = dict.size() - first;
+        if(count == 0) return;
+
+        vector<uint32_t> offsets(count + 1, 0);
+        for(size_t i = 0; i < count; i++) offsets[i + 1] = offsets[i] + (uint32_t)dict.get(first + i).size();
+        size_t offsetBytes = offsets.size() * sizeof(uint32_t);
+        size_t body = pad8(offsetBytes + offsets.back());
+
+        writeMessage(MESSAGE_DICTIONARY, id, (uint32_t)count, (uint32_t)first, body);
+        writeBytes(offsets.data(), offsetBytes);
+        for(size_t i = 0; i < count; i++) {
+            const string& s = dict.get(first + i);
+            writeBytes(s.data(), s.size());
+        }
+        writePadding(offsetBytes + offsets.back());
+        dict.markWritten();
+    }
+
+    void flushBatch() {
+        if(rowsInBatch == 0) return;
+        writeDictionaryDelta(players, DICTIONARY_PLAYERS);
+        writeDictionaryDelta(venues, DICTIONARY_VENUES);
+
+        const ColumnSchema* schema = deliveryColumnSchema();
+        uint64_t body = 0;
+        for(int c = 0; c < DELIVERY_COLUMN_COUNT; c++) body += pad8(rowsInBatch * schema[c].type);
+
+        batchOffsets.push_back(position);
+        writeMessage(MESSAGE_RECORD_BATCH, DICTIONARY_NONE, (uint32_t)rowsInBatch, 0, body);
+        for(int c = 0; c < DELIVERY_COLUMN_COUNT; c++) {
+            size_t bytes = rowsInBatch * schema[c].type;
+            writeBytes(columns[c].data(), bytes);
+            writePadding(bytes);
+        }
+        rowsInBatch = 0;
+    }
+
+    template<typename T>
+    void put(int column, T value) {
+        memcpy(&columns[column][rowsInBatch * sizeof(T)], &value, sizeof(T));
+    }
+
+    void appendRow(uint32_t match, uint8_t innings, uint16_t over, uint8_t ball, uint32_t batter,
+                   uint32_t nonStriker, uint32_t bowler, uint32_t fielder, uint32_t venue,
+                   uint8_t outcome, uint8_t wicketType, uint8_t runs, uint8_t extras,
+                   uint8_t legal, int64_t timestamp) {
+        put(COL_MATCH, match);
+        put(COL_INNINGS, innings);
+        put(COL_OVER, over);
+        put(COL_BALL, ball);
+        put(COL_BATTER, batter);
+        put(COL_NON_STRIKER, nonStriker);
+        put(COL_BOWLER, bowler);
+        put(COL_FIELDER, fielder);
+        put(COL_VENUE, venue);
+        put(COL_OUTCOME, outcome);
+        put(COL_WICKET_TYPE, wicketType);
+        put(COL_RUNS, runs);
+        put(COL_EXTRAS, extras);
+        put(COL_LEGAL, legal);
+        put(COL_TIMESTAMP, timestamp);
+        totalRows++;
+        if(++rowsInBatch == batchRows) flushBatch();
+    }
+
+    uint32_t playerId(const Player* player) {
+        if(!player) return COLUMNAR_NULL;
+        auto it = livePlayers.find(player);
+        if(it != livePlayers.end()) return it->second;
+        uint32_t id = players.lookup(player->getName());
+        livePlayers[player] = id;
+        return id;
+    }
+
+    uint32_t snapshotPlayer(uint32_t index) const {
+        return index < playerMap.size() ? playerMap[index] : COLUMNAR_NULL;
+    }
+
+public:
+    ColumnarWriter(size_t rowsPerBatch = 65536)
+        : position(0), batchRows(rowsPerBatch ? rowsPerBatch : 1), rowsInBatch(0), totalRows(0) {}
+
+    ~ColumnarWriter() {
+        close();
+    }
+
+    // No copies: the writer owns its file
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    bool open(const string& path) {
+        out.open(path.c_str(), ios::binary | ios::trunc);
+        if(!out) return false;
+        position = 0;
+        totalRows = 0;
+        rowsInBatch = 0;
+        batchOffsets.clear();
+
+        const ColumnSchema* schema = deliveryColumnSchema();
+        columns.assign(DELIVERY_COLUMN_COUNT, vector<char>());
+        for(int c = 0; c < DELIVERY_COLUMN_COUNT; c++) columns[c].resize(batchRows * schema[c].type);
+
+        writeBytes(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+        writeMessage(MESSAGE_SCHEMA, DICTIONARY_NONE, DELIVERY_COLUMN_COUNT, 0,
+                     DELIVERY_COLUMN_COUNT * sizeof(ColumnSchema));
+        writeBytes(schema, DELIVERY_COLUMN_COUNT * sizeof(ColumnSchema));
+        return out.good();
+    }
+
+    // Flush the last batch and write the footer
+    bool close() {
+        if(!out.is_open()) return false;
+        flushBatch();
+        writeMessage(MESSAGE_END, DICTIONARY_NONE, 0, 0, 0);
+        writeBytes(batchOffsets.data(), batchOffsets.size() * sizeof(uint64_t));
+        ColumnFooter footer;
+        footer.batchCount = batchOffsets.size();
+        footer.rowCount = totalRows;
+        memcpy(footer.magic, COLUMNAR_MAGIC, sizeof(footer.magic));
+        writeBytes(&footer, sizeof(footer));
+        bool ok = out.good();
+        out.close();
+        return ok;
+    }
+
+    // Export every delivery of one innings from the live object model
+    void addInnings(const Innings& innings, uint32_t matchNo, const string& venue) {
+        uint32_t venueId = venues.lookup(venue);
+        uint8_t inningsNumber = (uint8_t)innings.getInningsNumber();
+        for(auto over : innings.getOvers()) {
+            for(auto ball : over->getBalls()) {
+                appendRow(matchNo, inningsNumber, (uint16_t)ball->getOverNumber(), (uint8_t)ball->getBallNumber(),
+                          playerId(ball->getBatsman()), playerId(ball->getNonStriker()),
+                          playerId(ball->getBowler()), playerId(ball->getFielder()), venueId,
+                          (uint8_t)ball->getOutcome(), (uint8_t)ball->getWicketType(),
+                          (uint8_t)ball->getRuns(), (uint8_t)ball->getExtras(),
+                          ball->getIsValid() ? 1 : 0, (int64_t)ball->getTimestamp());
+            }
+        }
+    }
+
+    void addMatch(const Match& match, uint32_t matchNo) {
+        string venue = match.getVenue() ? match.getVenue()->getStadiumName() : "";
+        for(auto innings : match.getAllInnings()) addInnings(*innings, matchNo, venue);
+    }
+
+    // Export an archived match, packed or not
+    void addSnapshot(const MatchSnapshot& snapshot, uint32_t matchNo) {
+        const SnapshotHeader& h = snapshot.header();
+        uint32_t venueId = venues.lookup(snapshot.stringData(h.venueName), h.venueName.length, scratch);
+        playerMap.resize(snapshot.count(SECTION_PLAYERS));
+        for(uint32_t p = 0; p < playerMap.size(); p++) {
+            SnapshotString name = snapshot.player(p).name;
+            playerMap[p] = players.lookup(snapshot.stringData(name), name.length, scratch);
+        }
+
+        // Packed snapshots are expanded into the same over/ball tables
+        vector<OverRecord> packedOvers;
+        vector<BallRecord> packedBalls;
+        const OverRecord* overs;
+        const BallRecord* balls;
+        if(snapshot.isPacked()) {
+            if(!DeliveryCodec::unpack(snapshot, packedOvers, packedBalls)) return;
+            overs = packedOvers.data();
+            balls = packedBalls.data();
+        } else {
+            overs = snapshot.section<OverRecord>(SECTION_OVERS);
+            balls = snapshot.section<BallRecord>(SECTION_BALLS);
+        }
+
+        for(uint32_t i = 0; i < snapshot.count(SECTION_INNINGS); i++) {
+            const InningsRecord& inn = snapshot.innings(i);
+            uint8_t inningsNumber = (uint8_t)inn.inningsNumber;
+            for(uint32_t o = inn.firstOver; o < inn.firstOver + inn.overCount; o++) {
+                for(uint32_t k = overs[o].firstBall; k < overs[o].firstBall + overs[o].ballCount; k++) {
+                    const BallRecord& b = balls[k];
+                    appendRow(matchNo, inningsNumber, (uint16_t)b.overNumber, b.ballNumber,
+                              snapshotPlayer(b.batsman), snapshotPlayer(b.nonStriker),
+                              snapshotPlayer(b.bowler), snapshotPlayer(b.fielder), venueId,
+                              b.outcome, b.wicketType, b.runs, b.extras, (b.flags & BALL_VALID) ? 1 : 0,
+                              b.timestamp);
+                }
+            }
+        }
+    }
+
+    // Export the whole archive, one match at a time
+    uint64_t addArchive(const MatchArchive& archive) {
+        uint64_t before = totalRows;
+        MatchSnapshot snapshot;
+        for(uint32_t n = 0; n < archive.getMatchCount(); n++) {
+            if(archive.openSnapshot(n, snapshot)) addSnapshot(snapshot, n);
+        }
+        return totalRows - before;
+    }
+
+    uint64_t getRowCount() const { return totalRows; }
+    size_t getBatchCount() const { return batchOffsets.size(); }
+    uint64_t getBytesWritten() const { return position; }
+    size_t getPlayerCount() const { return players.size(); }
+};
+
+// Reads a columnar file back one record batch at a time
+class ColumnarReader {
+private:
+    ifstream in;
+    vector<ColumnSchema> schema;
+    vector<string> dictionaries[3];
+    vector<char> body;
+    vector<size_t> columnOffsets;
+    uint32_t rows;
+    bool finished;
+
+    bool readDictionary(const ColumnMessage& m) {
+        if(m.dictionary < 1 || m.dictionary > 2) return false;
+        vector<string>& dict = dictionaries[m.dictionary];
+        if(m.firstEntry != dict.size()) return false;
+        const uint32_t* offsets = (const uint32_t*)body.data();
+        const char* text = body.data() + (m.count + 1) * sizeof(uint32_t);
+        for(uint32_t i = 0; i < m.count; i++) dict.push_back(string(text + offsets[i], offsets[i + 1] - offsets[i]));
+        return true;
+    }
+
+public:
+    ColumnarReader() : rows(0), finished(true) {}
+
+    bool open(const string& path) {
+        in.open(path.c_str(), ios::binary);
+        char magic[8];
+        ColumnMessage m;
+        if(!in.read(magic, 8) || memcmp(magic, COLUMNAR_MAGIC, 8) != 0) return false;
+        if(!in.read((char*)&m, sizeof(m)) || m.kind != MESSAGE_SCHEMA) return false;
+        schema.resize(m.count);
+        if(!in.read((char*)schema.data(), m.count * sizeof(ColumnSchema))) return false;
+        finished = false;
+        return true;
+    }
+
+    // Advance to the next record batch, applying dictionary deltas on the way
+    bool nextBatch() {
+        ColumnMessage m;
+        while(!finished && in.read((char*)&m, sizeof(m))) {
+            if(m.kind == MESSAGE_END) break;
+            body.resize((size_t)m.bodyLength);
+            if(!in.read(body.data(), body.size())) break;
+            if(m.kind == MESSAGE_DICTIONARY) {
+                if(!readDictionary(m)) break;
+            } else if(m.kind == MESSAGE_RECORD_BATCH) {
+                rows = m.count;
+                columnOffsets.clear();
+                size_t offset = 0;
+                for(const auto& c : schema) {
+                    columnOffsets.push_back(offset);
+                    offset += ((size_t)rows * c.type + 7) & ~(size_t)7;
+                }
+                return true;
+            }
+        }
+        finished = true;
+        rows = 0;
+        return false;
+    }
+
+    uint32_t getRows() const { return rows; }
+    size_t getColumnCount() const { return schema.size(); }
+    const ColumnSchema& getColumn(size_t c) const { return schema[c]; }
+
+    template<typename T>
+    const T* column(size_t c) const {
+        return (const T*)(body.data() + columnOffsets[c]);
+    }
+
+    const vector<string>& getDictionary(ColumnDictionary d) const { return dictionaries[d]; }
+};
+
+#endif
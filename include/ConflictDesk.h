@@ -0,0 +1,392 @@
+#ifndef CONFLICTDESK_H
+#define CONFLICTDESK_H
+
+#include "Scorebook.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_set>
+
+// One posted dispute. Ball and entries are fixed once posted; the state
+// word is the only thing supervisors race on.
+struct ConflictTicket {
+    int overNumber;
+    int ballNumber;
+    vector<ScoreEntry> entries;     // As they stood when the conflict was posted
+    atomic<uint64_t> state;
+    ScoreEntry ruling;              // Written by the resolving supervisor only
+    int rulingSupervisor;
+    bool applied;                   // Scoring thread only
+    atomic<int>* chunkHolders;      // Claims open on this ticket's chunk
+
+    ConflictTicket() : overNumber(0), ballNumber(0), state(0), rulingSupervisor(-1), applied(false),
+                       chunkHolders(nullptr) {}
+};
+
+// A supervisor's hold on a ticket; the word identifies this exact lease
+struct ConflictClaim {
+    ConflictTicket* ticket;
+    uint64_t word;
+
+    ConflictClaim() : ticket(nullptr), word(0) {}
+    bool isValid() const { return ticket != nullptr; }
+};
+
+// Each supervisor's counters sit on their own cache line
+struct alignas(64) SupervisorDeskStats {
+    atomic<uint64_t> claims;
+    atomic<uint64_t> resolutions;
+    atomic<uint64_t> releases;
+    atomic<uint64_t> leasesExpired;     // Lost to another supervisor after running out
+    atomic<uint64_t> leasesTaken;       // Taken over from a supervisor who ran out
+    atomic<uint64_t> lateRulings;       // Ruled after losing the lease; discarded
+    atomic<uint64_t> busyMicros;        // Lease start to ruling, summed
+
+    SupervisorDeskStats() : claims(0), resolutions(0), releases(0), leasesExpired(0), leasesTaken(0),
+                            lateRulings(0), busyMicros(0) {}
+};
+
+// Lets several supervisors work through a match's conflicts at once.
+// The scoring thread posts each new conflict as a ticket and, in sync(),
+// applies finished rulings to the Scorebook, which stays single-threaded.
+// Supervisors on their own threads claim, renew, release and resolve
+// tickets with a compare-and-swap on the ticket's state word. That word
+// packs the state, the owning supervisor and the lease deadline, so a
+// claim, a takeover of an expired lease and a ruling each succeed for
+// exactly one supervisor and nothing else serializes them.
+//
+// Tickets live in chunks that are recycled once every ticket in them has
+// been applied and no supervisor holds a claim there, so memory follows
+// the open backlog rather than the match. Every claim must end in
+// resolve() or release().
+class ConflictDesk {
+public:
+    static const size_t CHUNK_SIZE = 1024;
+    static const size_t MAX_CHUNKS = 1024;     // Live chunks at once
+    static const int MAX_SUPERVISORS = 64;
+
+    enum TicketState : uint64_t {
+        OPEN = 0,
+        CLAIMED = 1,
+        RESOLVING = 2,
+        RESOLVED = 3,
+        CANCELLED = 4       // Settled some other way (automatic or replicated ruling)
+    };
+
+private:
+    // State word: state (3 bits) | owner (13 bits) | lease deadline in microseconds (48 bits)
+    static uint64_t pack(uint64_t state, int owner, uint64_t deadline) {
+        return state | ((uint64_t)owner << 3) | (deadline << 16);
+    }
+    static uint64_t stateOf(uint64_t word) { return word & 7; }
+    static int ownerOf(uint64_t word) { return (int)((word >> 3) & 0x1FFF); }
+    static uint64_t deadlineOf(uint64_t word) { return word >> 16; }
+
+    // Chunks are only freed with the desk, so a supervisor scanning a stale
+    // range reads valid tickets; finished or not yet posted ones look
+    // CANCELLED, and an OPEN one is a real ticket whatever its index.
+    struct TicketChunk {
+        ConflictTicket tickets[CHUNK_SIZE];
+        atomic<int> holders;
+
+        TicketChunk() : holders(0) {
+            for(auto& t : tickets) {
+                t.state.store(pack(CANCELLED, 0, 0), memory_order_relaxed);
+                t.chunkHolders = &holders;
+            }
+        }
+    };
+
+    atomic<TicketChunk*> chunks[MAX_CHUNKS];    // Chunk number (ticket / CHUNK_SIZE) modulo MAX_CHUNKS
+    atomic<size_t> published;       // Tickets visible to supervisors
+    atomic<size_t> scanStart;       // Every ticket below is finished
+    chrono::steady_clock::time_point epoch;
+    uint64_t leaseMicros;
+
+    Supervisor* supervisors[MAX_SUPERVISORS];
+    SupervisorDeskStats stats[MAX_SUPERVISORS];
+    atomic<int> supervisorCount;
+    mutex registerLock;
+
+    // Scoring thread only
+    int conflictsSeen;
+    unordered_set<int64_t> postedBalls;     // Every conflict the desk has looked at
+    size_t firstUnapplied;
+    uint64_t rulingsApplied;
+    uint64_t rulingsSuperseded;
+    uint64_t ticketsCancelled;
+    uint64_t postsDeferred;                 // Live chunks at the limit; retried next sync
+    size_t firstLiveChunk;
+    vector<TicketChunk*> allocatedChunks;
+    vector<TicketChunk*> spareChunks;
+
+    ConflictTicket& at(size_t i) const {
+        return chunks[(i / CHUNK_SIZE) % MAX_CHUNKS].load(memory_order_acquire)->tickets[i % CHUNK_SIZE];
+    }
+
+    static int64_t ballKey(int over, int ball) { return ((int64_t)over << 32) | (uint32_t)ball; }
+
+    static bool isFinished(uint64_t word) {
+        return stateOf(word) == RESOLVED || stateOf(word) == CANCELLED;
+    }
+
+    // False when MAX_CHUNKS chunks still hold live tickets
+    bool post(const Conflict& conflict) {
+        size_t i = published.load(memory_order_relaxed);
+        if(i % CHUNK_SIZE == 0) {
+            size_t chunk = i / CHUNK_SIZE;
+            if(chunk - firstLiveChunk >= MAX_CHUNKS) return false;
+            TicketChunk* c;
+            if(!spareChunks.empty()) {
+                c = spareChunks.back();
+                spareChunks.pop_back();
+            } else {
+                c = new TicketChunk();
+                allocatedChunks.push_back(c);
+            }
+            chunks[chunk % MAX_CHUNKS].store(c, memory_order_release);
+        }
+        ConflictTicket& t = at(i);
+        t.overNumber = conflict.overNumber;
+        t.ballNumber = conflict.ballNumber;
+        t.entries = conflict.conflictingEntries;
+        t.ruling = ScoreEntry();
+        t.rulingSupervisor = -1;
+        t.applied = false;
+        t.state.store(pack(OPEN, 0, 0), memory_order_release);
+        published.store(i + 1, memory_order_release);
+        return true;
+    }
+
+    // Recycle chunks whose tickets are all applied and unclaimed
+    void retireChunks() {
+        while((firstLiveChunk + 1) * CHUNK_SIZE <= firstUnapplied) {
+            TicketChunk* c = chunks[firstLiveChunk % MAX_CHUNKS].load(memory_order_relaxed);
+            if(c->holders.load(memory_order_acquire) != 0) break;
+            spareChunks.push_back(c);
+            firstLiveChunk++;
+        }
+    }
+
+    // Withdraw a ticket that no longer needs a supervisor
+    void cancel(ConflictTicket& t) {
+        uint64_t word = t.state.load(memory_order_acquire);
+        while(stateOf(word) == OPEN || stateOf(word) == CLAIMED) {
+            if(t.state.compare_exchange_weak(word, pack(CANCELLED, 0, 0), memory_order_acq_rel)) {
+                ticketsCancelled++;
+                return;
+            }
+        }
+    }
+
+    // Move scanStart past finished tickets
+    void advanceScanStart(size_t from, size_t count) {
+        size_t i = from;
+        while(i < count && isFinished(at(i).state.load(memory_order_acquire))) i++;
+        size_t current = scanStart.load(memory_order_relaxed);
+        while(current < i && !scanStart.compare_exchange_weak(current, i, memory_order_relaxed)) {}
+    }
+
+public:
+    ConflictDesk(uint64_t leaseMs = 30000)
+        : published(0), scanStart(0), epoch(chrono::steady_clock::now()), leaseMicros(leaseMs * 1000),
+          supervisorCount(0), conflictsSeen(0), firstUnapplied(0), rulingsApplied(0),
+          rulingsSuperseded(0), ticketsCancelled(0), postsDeferred(0), firstLiveChunk(0) {
+        for(size_t c = 0; c < MAX_CHUNKS; c++) chunks[c].store(nullptr, memory_order_relaxed);
+        for(int s = 0; s < MAX_SUPERVISORS; s++) supervisors[s] = nullptr;
+    }
+
+    ~ConflictDesk() {
+        for(auto c : allocatedChunks) delete c;
+    }
+
+    // No copies: supervisors hold pointers to tickets
+    ConflictDesk(const ConflictDesk&) = delete;
+    ConflictDesk& operator=(const ConflictDesk&) = delete;
+
+    // Returns the supervisor's desk index, or -1 when the desk is full
+    int addSupervisor(Supervisor* supervisor) {
+        lock_guard<mutex> lock(registerLock);
+        int n = supervisorCount.load(memory_order_relaxed);
+        if(n == MAX_SUPERVISORS) return -1;
+        supervisors[n] = supervisor;
+        supervisorCount.store(n + 1, memory_order_release);
+        return n;
+    }
+
+    uint64_t nowMicros() const {
+        return (uint64_t)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - epoch).count();
+    }
+
+    // Scoring thread: post new conflicts, apply finished rulings, and
+    // withdraw tickets for conflicts that were settled some other way
+    void sync(Scorebook& scorebook) {
+        int total = scorebook.getTotalConflicts();
+        if(total > conflictsSeen) {
+            // New conflicts are appended and compaction keeps the order of
+            // the rest, so the ones not seen yet are a suffix
+            const vector<Conflict>& conflicts = scorebook.getConflicts();
+            size_t first = conflicts.size();
+            while(first > 0 && !postedBalls.count(ballKey(conflicts[first - 1].overNumber,
+                                                          conflicts[first - 1].ballNumber))) first--;
+            bool complete = true;
+            for(size_t i = first; i < conflicts.size(); i++) {
+                if(!conflicts[i].isResolved && !post(conflicts[i])) {
+                    postsDeferred++;
+                    complete = false;
+                    break;
+                }
+                postedBalls.insert(ballKey(conflicts[i].overNumber, conflicts[i].ballNumber));
+            }
+            if(complete) conflictsSeen = total;
+
+            // Only conflicts the scorebook still holds are needed to find the suffix
+            if(postedBalls.size() > 2 * conflicts.size() + CHUNK_SIZE) {
+                unordered_set<int64_t> kept;
+                for(size_t i = 0; i < conflicts.size(); i++) {
+                    int64_t key = ballKey(conflicts[i].overNumber, conflicts[i].ballNumber);
+                    if(postedBalls.count(key)) kept.insert(key);
+                }
+                postedBalls.swap(kept);
+            }
+        }
+
+        size_t count = published.load(memory_order_relaxed);
+        for(size_t i = firstUnapplied; i < count; i++) {
+            ConflictTicket& t = at(i);
+            if(t.applied) continue;
+            uint64_t word = t.state.load(memory_order_acquire);
+            if(stateOf(word) == RESOLVED) {
+                if(scorebook.resolveConflict(t.overNumber, t.ballNumber, t.ruling, supervisors[t.rulingSupervisor])) {
+                    rulingsApplied++;
+                } else {
+                    rulingsSuperseded++;
+                }
+                t.applied = true;
+            } else if(stateOf(word) == CANCELLED) {
+                t.applied = true;
+            } else if(stateOf(word) != RESOLVING) {
+                const Conflict* c = scorebook.findConflict(t.overNumber, t.ballNumber);
+                if(!c || c->isResolved) cancel(t);
+            }
+        }
+        while(firstUnapplied < count && at(firstUnapplied).applied) firstUnapplied++;
+        advanceScanStart(scanStart.load(memory_order_relaxed), firstUnapplied);
+        retireChunks();
+    }
+
+    // Supervisor: take the oldest open ticket, or one whose lease ran out.
+    // The claim is invalid when there is nothing to do.
+    ConflictClaim claim(int supervisor) {
+        ConflictClaim claim;
+        size_t count = published.load(memory_order_acquire);
+        size_t start = scanStart.load(memory_order_relaxed);
+        uint64_t now = nowMicros();
+        for(size_t i = start; i < count; i++) {
+            ConflictTicket& t = at(i);
+            uint64_t word = t.state.load(memory_order_acquire);
+            bool expired = stateOf(word) == CLAIMED && deadlineOf(word) < now;
+            if(stateOf(word) != OPEN && !expired) continue;
+
+            // Hold the chunk before the ticket can be ours
+            uint64_t mine = pack(CLAIMED, supervisor, now + leaseMicros);
+            t.chunkHolders->fetch_add(1, memory_order_acq_rel);
+            if(!t.state.compare_exchange_strong(word, mine, memory_order_acq_rel)) {
+                t.chunkHolders->fetch_sub(1, memory_order_release);
+            } else {
+                if(expired) {
+                    stats[ownerOf(word)].leasesExpired.fetch_add(1, memory_order_relaxed);
+                    stats[supervisor].leasesTaken.fetch_add(1, memory_order_relaxed);
+                }
+                stats[supervisor].claims.fetch_add(1, memory_order_relaxed);
+                claim.ticket = &t;
+                claim.word = mine;
+                break;
+            }
+        }
+        if(count > start) advanceScanStart(start, count);
+        return claim;
+    }
+
+    // Extend the lease; false if it was already lost
+    bool renew(ConflictClaim& claim) {
+        uint64_t word = claim.word;
+        uint64_t renewed = pack(CLAIMED, ownerOf(word), nowMicros() + leaseMicros);
+        if(!claim.ticket->state.compare_exchange_strong(word, renewed, memory_order_acq_rel)) return false;
+        claim.word = renewed;
+        return true;
+    }
+
+    // Hand the ticket back unruled
+    bool release(ConflictClaim& claim) {
+        uint64_t word = claim.word;
+        int supervisor = ownerOf(word);
+        bool released = claim.ticket->state.compare_exchange_strong(word, pack(OPEN, 0, 0), memory_order_acq_rel);
+        if(released) stats[supervisor].releases.fetch_add(1, memory_order_relaxed);
+        claim.ticket->chunkHolders->fetch_sub(1, memory_order_release);
+        claim.ticket = nullptr;
+        return released;
+    }
+
+    // Rule on the claimed ticket; false if the lease was lost first
+    bool resolve(ConflictClaim& claim, const ScoreEntry& correctEntry) {
+        ConflictTicket& t = *claim.ticket;
+        uint64_t word = claim.word;
+        int supervisor = ownerOf(word);
+        claim.ticket = nullptr;
+        if(!t.state.compare_exchange_strong(word, pack(RESOLVING, supervisor, 0), memory_order_acq_rel)) {
+            stats[supervisor].lateRulings.fetch_add(1, memory_order_relaxed);
+            t.chunkHolders->fetch_sub(1, memory_order_release);
+            return false;
+        }
+        t.ruling = correctEntry;
+        t.rulingSupervisor = supervisor;
+        t.state.store(pack(RESOLVED, supervisor, 0), memory_order_release);
+        t.chunkHolders->fetch_sub(1, memory_order_release);
+
+        uint64_t leaseStart = deadlineOf(claim.word) - leaseMicros;
+        uint64_t now = nowMicros();
+        stats[supervisor].busyMicros.fetch_add(now > leaseStart ? now - leaseStart : 0, memory_order_relaxed);
+        stats[supervisor].resolutions.fetch_add(1, memory_order_relaxed);
+        return true;
+    }
+
+    // Tickets not yet ruled on or withdrawn
+    size_t getBacklog() const {
+        size_t count = published.load(memory_order_acquire);
+        size_t open = 0;
+        for(size_t i = scanStart.load(memory_order_relaxed); i < count; i++) {
+            if(!isFinished(at(i).state.load(memory_order_acquire))) open++;
+        }
+        return open;
+    }
+
+    void displayMetrics(double elapsedSeconds) const {
+        cout << "\nConflict desk: " << published.load() << " tickets, " << rulingsApplied
+             << " rulings applied, " << rulingsSuperseded << " superseded, " << ticketsCancelled
+             << " withdrawn, " << getBacklog() << " outstanding, " << postsDeferred << " posts deferred; "
+             << allocatedChunks.size() << " chunks of " << CHUNK_SIZE << " allocated" << endl;
+        int n = supervisorCount.load(memory_order_acquire);
+        for(int s = 0; s < n; s++) {
+            const SupervisorDeskStats& st = stats[s];
+            uint64_t done = st.resolutions.load();
+            cout << "  " << supervisors[s]->getName() << ": " << done << " rulings ("
+                 << (elapsedSeconds > 0 ? (int)(done / elapsedSeconds) : 0) << "/s, avg "
+                 << (done ? st.busyMicros.load() / done : 0) << " us each), " << st.claims.load()
+                 << " claims, " << st.releases.load() << " released, " << st.leasesExpired.load()
+                 << " leases expired, " << st.leasesTaken.load() << " taken over, "
+                 << st.lateRulings.load() << " late rulings" << endl;
+        }
+    }
+
+    const SupervisorDeskStats& getStats(int supervisor) const { return stats[supervisor]; }
+    size_t getTicketsPosted() const { return published.load(memory_order_acquire); }
+    uint64_t getRulingsApplied() const { return rulingsApplied; }
+    uint64_t getRulingsSuperseded() const { return rulingsSuperseded; }
+    uint64_t getTicketsCancelled() const { return ticketsCancelled; }
+    uint64_t getPostsDeferred() const { return postsDeferred; }
+    size_t getChunksAllocated() const { return allocatedChunks.size(); }
+    uint64_t getLeaseMicros() const { return leaseMicros; }
+};
+
+#endif
@@ -0,0 +1,597 @@
+#ifndef DELIVERYCODEC_H
+#define DELIVERYCODEC_H
+
+#include "MatchSnapshot.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// Packed delivery encoding
+//
+// The over and ball tables of a snapshot are stored as byte-aligned blocks
+// instead of 32- and 40-byte records, one block per field, so a reader
+// fills a whole column at a time:
+//
+//   header:     varint overCount, varint ballCount, varint zigzag(first
+//               timestamp), varint over entry width, varint byte lengths
+//               of batters and exceptions
+//   overs:      one fixed-width entry per over, u16 overNumber, u8
+//               ballCount | maiden << 7, u8 bowler + 1; or, when an over
+//               does not fit, u32 of each (maiden in the ballCount top bit)
+//   codes:      one byte per ball, outcome (low 4 bits) | runs (high 4 bits)
+//   extras:     one nibble per ball, two to a byte, extras (2 bits) |
+//               legal (1 bit)
+//   pairs:      2 bits per ball, four to a byte: same batters, swapped
+//               batters, or the next explicit pair
+//   batters:    varint batsman + 1, varint nonStriker + 1, per explicit pair
+//   exceptions: varint ball index delta, u8 field, varint value(s), for each
+//               field that is not the usual (runs or extras past the code
+//               range, ball or over number not the expected, bowler not
+//               the over's, wicket, commentary)
+//   times:      varint zigzag(timestamp delta) per ball
+//
+// The bowler and over number are run-length encoded per over, and batters
+// only cost bytes when a wicket or end of innings changes the pair. Over
+// runs and wickets are recomputed from the balls when unpacking. Column
+// loads skip the timestamps. A typical delivery takes about 3.7 bytes.
+// ---------------------------------------------------------------------------
+
+// Destination arrays for DeliveryCodec::decode, ballCount entries each.
+// Player fields receive snapshot player indexes, or with a playerMap the
+// mapped value; null arrays are skipped.
+struct PackedColumns {
+    uint16_t* overNumber;
+    uint32_t* bowler;
+    uint32_t* batsman;
+    uint8_t* outcome;
+    uint8_t* wicketType;
+    uint8_t* runs;
+    uint8_t* extras;
+    uint8_t* flags;          // SnapshotBallFlags
+    // Only needed to rebuild full records
+    uint32_t* nonStriker;
+    uint32_t* fielder;
+    uint8_t* ballNumber;
+    int64_t* timestamp;
+    SnapshotString* commentary;
+    // Optional value per player index for bowler and batsman, playerCount + 1
+    // entries; the last stands in for a missing or out-of-range index.
+    // batterFlags (same indexing) is ORed into flags for the batsman.
+    const uint32_t* playerMap;
+    const uint8_t* batterFlags;
+    uint32_t playerCount;
+
+    PackedColumns()
+        : overNumber(nullptr), bowler(nullptr), batsman(nullptr), outcome(nullptr), wicketType(nullptr),
+          runs(nullptr), extras(nullptr), flags(nullptr), nonStriker(nullptr), fielder(nullptr),
+          ballNumber(nullptr), timestamp(nullptr), commentary(nullptr), playerMap(nullptr),
+          batterFlags(nullptr), playerCount(0) {}
+};
+
+class DeliveryCodec {
+private:
+    static const uint32_t RUNS_LIMIT = 15;      // Runs below fit the code byte
+    static const uint32_t EXTRAS_LIMIT = 3;     // Extras below fit the nibble
+    static const uint8_t NIBBLE_LEGAL = 4;
+    static const uint32_t NARROW_OVER = 4;      // Over entry widths
+    static const uint32_t WIDE_OVER = 12;
+
+    enum BatterCode {
+        BATTERS_SAME = 0,
+        BATTERS_SWAPPED = 1,
+        BATTERS_EXPLICIT = 2
+    };
+
+    enum ExceptionField {
+        EXCEPTION_RUNS,
+        EXCEPTION_EXTRAS,
+        EXCEPTION_BALL_NUMBER,
+        EXCEPTION_OVER_NUMBER,
+        EXCEPTION_BOWLER,
+        EXCEPTION_WICKET,       // Type, fielder + 1
+        EXCEPTION_COMMENTARY    // Offset, length
+    };
+
+    static void putVarint(vector<uint8_t>& out, uint64_t value) {
+        while(value >= 0x80) {
+            out.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((uint8_t)value);
+    }
+
+    static void putSigned(vector<uint8_t>& out, int64_t value) {
+        putVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    static void putFixed(vector<uint8_t>& out, uint32_t value, int bytes) {
+        for(int i = 0; i < bytes; i++) out.push_back((uint8_t)(value >> (8 * i)));
+    }
+
+    static uint32_t getFixed(const uint8_t* in, int bytes) {
+        uint32_t value = 0;
+        for(int i = 0; i < bytes; i++) value |= (uint32_t)in[i] << (8 * i);
+        return value;
+    }
+
+    // Bounds-checked reads from one part of the stream
+    class ByteReader {
+    private:
+        const uint8_t* data;
+        size_t size;
+        size_t pos;
+        bool bad;
+
+    public:
+        ByteReader(const uint8_t* bytes, size_t length) : data(bytes), size(length), pos(0), bad(false) {}
+
+        uint8_t u8() {
+            if(pos >= size) {
+                bad = true;
+                return 0;
+            }
+            return data[pos++];
+        }
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for(int shift = 0; shift < 64; shift += 7) {
+                uint8_t group = u8();
+                value |= (uint64_t)(group & 0x7F) << shift;
+                if(!(group & 0x80)) break;
+            }
+            return value;
+        }
+
+        int64_t signedVarint() {
+            uint64_t v = varint();
+            return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+        }
+
+        // Take the next n bytes as their own part
+        const uint8_t* take(size_t n) {
+            if(n > size - pos) {
+                bad = true;
+                return nullptr;
+            }
+            const uint8_t* p = data + pos;
+            pos += n;
+            return p;
+        }
+
+        size_t remaining() const { return size - pos; }
+        bool failed() const { return bad; }
+    };
+
+    // Where each part of a packed stream starts
+    struct StreamLayout {
+        uint32_t overCount;
+        uint32_t ballCount;
+        int64_t firstTime;
+        uint32_t overWidth;
+        const uint8_t* overs;
+        const uint8_t* codes;
+        const uint8_t* extras;
+        const uint8_t* pairs;
+        const uint8_t* batters;
+        size_t battersSize;
+        const uint8_t* exceptions;
+        size_t exceptionsSize;
+        const uint8_t* times;
+        size_t timesSize;
+    };
+
+    static bool parseLayout(const uint8_t* data, size_t size, StreamLayout& l) {
+        ByteReader r(data, size);
+        uint64_t overCount = r.varint();
+        uint64_t ballCount = r.varint();
+        l.firstTime = r.signedVarint();
+        uint64_t overWidth = r.varint();
+        uint64_t battersSize = r.varint();
+        uint64_t exceptionsSize = r.varint();
+        if(r.failed() || overCount > size || ballCount > size * 4 || battersSize > size ||
+           exceptionsSize > size || (overWidth != NARROW_OVER && overWidth != WIDE_OVER)) return false;
+        l.overCount = (uint32_t)overCount;
+        l.ballCount = (uint32_t)ballCount;
+        l.overWidth = (uint32_t)overWidth;
+        l.battersSize = (size_t)battersSize;
+        l.exceptionsSize = (size_t)exceptionsSize;
+        l.overs = r.take((size_t)l.overCount * l.overWidth);
+        l.codes = r.take(l.ballCount);
+        l.extras = r.take((l.ballCount + 1) / 2);
+        l.pairs = r.take((l.ballCount + 3) / 4);
+        l.batters = r.take(l.battersSize);
+        l.exceptions = r.take(l.exceptionsSize);
+        l.timesSize = r.remaining();
+        l.times = r.take(l.timesSize);
+        return !r.failed();
+    }
+
+    static void encodeStream(const MatchSnapshot& snapshot, vector<uint8_t>& out) {
+        uint32_t overCount = snapshot.count(SECTION_OVERS);
+        uint32_t ballCount = snapshot.count(SECTION_BALLS);
+        vector<uint8_t> overs, codes(ballCount), extras((ballCount + 1) / 2), pairs((ballCount + 3) / 4);
+        vector<uint8_t> batters, exceptions, times;
+        int64_t firstTime = ballCount ? snapshot.ball(0).timestamp : 0;
+        int64_t lastTime = firstTime;
+        uint32_t lastException = 0;
+        auto exception = [&](uint32_t ball, ExceptionField field) {
+            putVarint(exceptions, ball - lastException);
+            exceptions.push_back((uint8_t)field);
+            lastException = ball;
+        };
+
+        uint32_t overWidth = NARROW_OVER;
+        for(uint32_t o = 0; o < overCount; o++) {
+            const OverRecord& over = snapshot.over(o);
+            if(over.overNumber > 0xFFFF || over.ballCount >= 0x80 || (uint32_t)(over.bowler + 1) > 0xFF) {
+                overWidth = WIDE_OVER;
+            }
+        }
+
+        uint32_t striker = SNAPSHOT_NONE, other = SNAPSHOT_NONE;
+        for(uint32_t o = 0; o < overCount; o++) {
+            const OverRecord& over = snapshot.over(o);
+            uint32_t bowlerCode = over.bowler + 1;     // SNAPSHOT_NONE wraps to 0
+            if(overWidth == NARROW_OVER) {
+                putFixed(overs, over.overNumber, 2);
+                putFixed(overs, over.ballCount | (over.isMaiden ? 0x80 : 0), 1);
+                putFixed(overs, bowlerCode, 1);
+            } else {
+                putFixed(overs, over.overNumber, 4);
+                putFixed(overs, (over.ballCount & 0x7FFFFFFF) | (over.isMaiden ? 0x80000000u : 0), 4);
+                putFixed(overs, bowlerCode, 4);
+            }
+
+            int legal = 0;
+            for(uint32_t i = over.firstBall; i < over.firstBall + over.ballCount; i++) {
+                const BallRecord& b = snapshot.ball(i);
+                uint32_t runs = b.runs < RUNS_LIMIT ? b.runs : RUNS_LIMIT;
+                uint32_t extra = b.extras < EXTRAS_LIMIT ? b.extras : EXTRAS_LIMIT;
+                codes[i] = (uint8_t)((b.outcome & 0x0F) | runs << 4);
+                uint8_t nibble = (uint8_t)(extra | ((b.flags & BALL_VALID) ? NIBBLE_LEGAL : 0));
+                extras[i / 2] |= (uint8_t)(nibble << (i % 2 * 4));
+                if(runs == RUNS_LIMIT) {
+                    exception(i, EXCEPTION_RUNS);
+                    putVarint(exceptions, b.runs);
+                }
+                if(extra == EXTRAS_LIMIT) {
+                    exception(i, EXCEPTION_EXTRAS);
+                    putVarint(exceptions, b.extras);
+                }
+
+                if(b.ballNumber != legal + 1) {
+                    exception(i, EXCEPTION_BALL_NUMBER);
+                    putVarint(exceptions, b.ballNumber);
+                }
+                if(b.flags & BALL_VALID) legal++;
+                if((uint32_t)(uint16_t)b.overNumber != (over.overNumber & 0xFFFF)) {
+                    exception(i, EXCEPTION_OVER_NUMBER);
+                    putVarint(exceptions, (uint16_t)b.overNumber);
+                }
+                if(b.bowler != over.bowler) {
+                    exception(i, EXCEPTION_BOWLER);
+                    putVarint(exceptions, (uint32_t)(b.bowler + 1));
+                }
+
+                uint32_t code;
+                if(b.batsman == striker && b.nonStriker == other) {
+                    code = BATTERS_SAME;
+                } else if(b.batsman == other && b.nonStriker == striker) {
+                    code = BATTERS_SWAPPED;
+                } else {
+                    code = BATTERS_EXPLICIT;
+                    putVarint(batters, (uint32_t)(b.batsman + 1));
+                    putVarint(batters, (uint32_t)(b.nonStriker + 1));
+                }
+                pairs[i / 4] |= (uint8_t)(code << (i % 4 * 2));
+                striker = b.batsman;
+                other = b.nonStriker;
+
+                if(b.wicketType != (uint8_t)WicketType::NONE) {
+                    exception(i, EXCEPTION_WICKET);
+                    putVarint(exceptions, b.wicketType);
+                    putVarint(exceptions, (uint32_t)(b.fielder + 1));
+                }
+                if(b.commentary.length > 0) {
+                    exception(i, EXCEPTION_COMMENTARY);
+                    putVarint(exceptions, b.commentary.offset);
+                    putVarint(exceptions, b.commentary.length);
+                }
+
+                putSigned(times, b.timestamp - lastTime);
+                lastTime = b.timestamp;
+            }
+        }
+
+        putVarint(out, overCount);
+        putVarint(out, ballCount);
+        putSigned(out, firstTime);
+        putVarint(out, overWidth);
+        putVarint(out, batters.size());
+        putVarint(out, exceptions.size());
+        for(const vector<uint8_t>* part : {&overs, &codes, &extras, &pairs, &batters, &exceptions, &times}) {
+            out.insert(out.end(), part->begin(), part->end());
+        }
+    }
+
+    // Column loops take plain pointers: a store through uint8_t* may alias
+    // any struct field, which would reload it every iteration
+    static void splitBytes(const uint8_t* in, uint8_t* out, uint32_t n, int shift, uint8_t mask) {
+        for(uint32_t i = 0; i < n; i++) out[i] = (in[i] >> shift) & mask;
+    }
+
+    // Two nibbles a byte, low first; the last byte may hold only one
+    static void splitNibbles(const uint8_t* in, uint8_t* out, uint32_t n, int shift, uint8_t mask) {
+        for(uint32_t j = 0; j < n / 2; j++) {
+            uint8_t pair = in[j];
+            out[2 * j] = (pair >> shift) & mask;
+            out[2 * j + 1] = (pair >> (shift + 4)) & mask;
+        }
+        if(n % 2) out[n - 1] = (in[n / 2] >> shift) & mask;
+    }
+
+    // Over runs are mostly six to eight balls: store a fixed block of
+    // eight, which the next run overwrites, rather than a short fill
+    template<typename T>
+    static void fillRun(T* out, uint32_t first, uint32_t count, uint32_t n, T value) {
+        if(count <= 8 && n - first >= 8) {
+            for(int k = 0; k < 8; k++) out[first + k] = value;
+        } else {
+            fill(out + first, out + first + count, value);
+        }
+    }
+
+    static const uint8_t* packedData(const MatchSnapshot& snapshot) {
+        return snapshot.section<uint8_t>(SECTION_PACKED_DELIVERIES);
+    }
+
+public:
+    // Deliveries in a packed snapshot, from the stream header
+    static uint32_t countBalls(const MatchSnapshot& snapshot) {
+        if(!snapshot.isPacked()) return 0;
+        StreamLayout l;
+        return parseLayout(packedData(snapshot), snapshot.count(SECTION_PACKED_DELIVERIES), l) ? l.ballCount : 0;
+    }
+
+    // Decode every delivery of a packed snapshot into the given column
+    // arrays, a whole column at a time. onOver(overNumber, bowler,
+    // firstBall, ballCount, maiden) is called for each over. Returns false
+    // if the stream is truncated or inconsistent; the arrays are then
+    // partly filled.
+    template<typename OverFn>
+    static bool decode(const MatchSnapshot& snapshot, const PackedColumns& out, OverFn onOver) {
+        if(!snapshot.isPacked()) return false;
+        StreamLayout l;
+        if(!parseLayout(packedData(snapshot), snapshot.count(SECTION_PACKED_DELIVERIES), l)) return false;
+        uint32_t n = l.ballCount;
+        const uint32_t* map = out.playerMap;
+        auto player = [&](uint32_t index) { return map ? map[index < out.playerCount ? index : out.playerCount] : index; };
+
+        // Over runs: over number and bowler for every ball of the over, and
+        // the ball numbers, which count legal deliveries within the over
+        uint32_t first = 0;
+        for(uint32_t o = 0; o < l.overCount; o++) {
+            const uint8_t* entry = l.overs + (size_t)o * l.overWidth;
+            uint32_t overNumber, balls, bowlerIndex;
+            bool maiden;
+            if(l.overWidth == NARROW_OVER) {
+                overNumber = getFixed(entry, 2);
+                balls = entry[2] & 0x7F;
+                maiden = (entry[2] & 0x80) != 0;
+                bowlerIndex = (uint32_t)entry[3] - 1;
+            } else {
+                overNumber = getFixed(entry, 4);
+                balls = getFixed(entry + 4, 4);
+                maiden = (balls & 0x80000000u) != 0;
+                balls &= 0x7FFFFFFF;
+                bowlerIndex = getFixed(entry + 8, 4) - 1;
+            }
+            if(balls > n - first) return false;
+            if(out.overNumber) fillRun(out.overNumber, first, balls, n, (uint16_t)overNumber);
+            if(out.bowler) fillRun(out.bowler, first, balls, n, player(bowlerIndex));
+            if(out.ballNumber) {
+                uint8_t* ballNumber = out.ballNumber;
+                const uint8_t* nibbles = l.extras;
+                int legal = 0;
+                for(uint32_t i = first; i < first + balls; i++) {
+                    ballNumber[i] = (uint8_t)(legal + 1);
+                    if((nibbles[i / 2] >> (i % 2 * 4)) & NIBBLE_LEGAL) legal++;
+                }
+            }
+            onOver(overNumber, bowlerIndex, first, balls, maiden);
+            first += balls;
+        }
+        if(first != n) return false;
+
+        if(out.outcome) splitBytes(l.codes, out.outcome, n, 0, 0x0F);
+        if(out.runs) splitBytes(l.codes, out.runs, n, 4, 0x0F);
+        if(out.extras) splitNibbles(l.extras, out.extras, n, 0, 3);
+        if(out.flags) splitNibbles(l.extras, out.flags, n, 2, BALL_VALID);
+        if(out.wicketType) memset(out.wicketType, (uint8_t)WicketType::NONE, n);
+        if(out.fielder) fill(out.fielder, out.fielder + n, SNAPSHOT_NONE);
+        if(out.commentary) memset(out.commentary, 0, n * sizeof(SnapshotString));
+
+        // Batters without a branch: between explicit pairs the striker is
+        // the pair's first or second by the parity of swaps so far. Each
+        // side carries its batter flags in the high word.
+        if(out.batsman || out.nonStriker) {
+            ByteReader batters(l.batters, l.battersSize);
+            auto side = [&](uint32_t index) {
+                uint64_t bits = out.batterFlags ? out.batterFlags[index < out.playerCount ? index : out.playerCount] : 0;
+                return bits << 32 | player(index);
+            };
+            uint64_t pairFirst = side(SNAPSHOT_NONE), pairDiff = 0, parity = 0;
+            uint32_t* batsman = out.batsman;
+            uint32_t* nonStriker = out.nonStriker;
+            uint8_t* flags = out.batterFlags ? out.flags : nullptr;
+            const uint8_t* pairs = l.pairs;
+            for(uint32_t i = 0; i < n; i++) {
+                uint32_t code = (pairs[i / 4] >> (i % 4 * 2)) & 3;
+                if(code == BATTERS_EXPLICIT) {
+                    pairFirst = side((uint32_t)batters.varint() - 1);
+                    pairDiff = pairFirst ^ side((uint32_t)batters.varint() - 1);
+                    parity = 0;
+                }
+                parity ^= code & BATTERS_SWAPPED;
+                uint64_t striker = pairFirst ^ (pairDiff & (0 - parity));
+                if(batsman) batsman[i] = (uint32_t)striker;
+                if(nonStriker) nonStriker[i] = (uint32_t)(striker ^ pairDiff);
+                if(flags) flags[i] |= (uint8_t)(striker >> 32);
+            }
+            if(batters.failed()) return false;
+        }
+
+        ByteReader exceptions(l.exceptions, l.exceptionsSize);
+        uint32_t ball = 0;
+        while(exceptions.remaining() > 0) {
+            ball += (uint32_t)exceptions.varint();
+            uint8_t field = exceptions.u8();
+            uint64_t value = exceptions.varint();
+            if(exceptions.failed() || ball >= n) return false;
+            switch(field) {
+                case EXCEPTION_RUNS: if(out.runs) out.runs[ball] = (uint8_t)value; break;
+                case EXCEPTION_EXTRAS: if(out.extras) out.extras[ball] = (uint8_t)value; break;
+                case EXCEPTION_BALL_NUMBER: if(out.ballNumber) out.ballNumber[ball] = (uint8_t)value; break;
+                case EXCEPTION_OVER_NUMBER: if(out.overNumber) out.overNumber[ball] = (uint16_t)value; break;
+                case EXCEPTION_BOWLER: if(out.bowler) out.bowler[ball] = player((uint32_t)value - 1); break;
+                case EXCEPTION_WICKET: {
+                    uint32_t fielder = (uint32_t)exceptions.varint() - 1;
+                    if(out.wicketType) out.wicketType[ball] = (uint8_t)value;
+                    if(out.fielder) out.fielder[ball] = fielder;
+                    break;
+                }
+                case EXCEPTION_COMMENTARY: {
+                    uint32_t length = (uint32_t)exceptions.varint();
+                    if(out.commentary) {
+                        out.commentary[ball].offset = (uint32_t)value;
+                        out.commentary[ball].length = length;
+                    }
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        if(exceptions.failed()) return false;
+
+        if(out.timestamp) {
+            ByteReader times(l.times, l.timesSize);
+            int64_t t = l.firstTime;
+            for(uint32_t i = 0; i < n; i++) {
+                t += times.signedVarint();
+                out.timestamp[i] = t;
+            }
+            if(times.failed()) return false;
+        }
+        return true;
+    }
+
+    // Rewrite a full snapshot with its overs and balls packed. Returns false
+    // if the input is not an unpacked snapshot.
+    static bool pack(const MatchSnapshot& full, vector<char>& out) {
+        if(!full.isOpen() || full.isPacked()) return false;
+
+        vector<uint8_t> stream;
+        stream.reserve(full.count(SECTION_BALLS) * 4 + 16);
+        encodeStream(full, stream);
+
+        SnapshotHeader header = full.header();
+        header.version = SNAPSHOT_VERSION;
+        header.headerSize = sizeof(SnapshotHeader);
+
+        const char* sources[SECTION_COUNT];
+        size_t cursor = sizeof(SnapshotHeader);
+        for(int id = 0; id < SECTION_COUNT; id++) {
+            SnapshotSection& s = header.sections[id];
+            sources[id] = full.section<char>((SnapshotSectionId)id);
+            if(id == SECTION_OVERS || id == SECTION_BALLS) {
+                s.count = 0;
+            } else if(id == SECTION_PACKED_DELIVERIES) {
+                s.count = (uint32_t)stream.size();
+                sources[id] = (const char*)stream.data();
+            }
+            cursor = (cursor + 7) & ~(size_t)7;
+            s.offset = cursor;
+            cursor += (size_t)s.count * s.recordSize;
+        }
+        header.fileSize = (cursor + 7) & ~(size_t)7;
+
+        out.assign(header.fileSize, 0);
+        memcpy(&out[0], &header, sizeof(header));
+        for(int id = 0; id < SECTION_COUNT; id++) {
+            const SnapshotSection& s = header.sections[id];
+            if(s.count > 0) memcpy(&out[s.offset], sources[id], (size_t)s.count * s.recordSize);
+        }
+        return true;
+    }
+
+    // Rebuild the over and ball records of a packed snapshot
+    static bool unpack(const MatchSnapshot& snapshot, vector<OverRecord>& overs, vector<BallRecord>& balls) {
+        overs.clear();
+        balls.clear();
+        uint32_t n = countBalls(snapshot);
+        vector<uint16_t> overNumber(n);
+        vector<uint32_t> bowler(n), batsman(n), nonStriker(n), fielder(n);
+        vector<uint8_t> outcome(n), wicketType(n), runs(n), extras(n), flags(n), ballNumber(n);
+        vector<int64_t> timestamp(n);
+        vector<SnapshotString> commentary(n);
+        PackedColumns cols;
+        cols.overNumber = overNumber.data();
+        cols.bowler = bowler.data();
+        cols.batsman = batsman.data();
+        cols.outcome = outcome.data();
+        cols.wicketType = wicketType.data();
+        cols.runs = runs.data();
+        cols.extras = extras.data();
+        cols.flags = flags.data();
+        cols.nonStriker = nonStriker.data();
+        cols.fielder = fielder.data();
+        cols.ballNumber = ballNumber.data();
+        cols.timestamp = timestamp.data();
+        cols.commentary = commentary.data();
+        bool ok = decode(snapshot, cols,
+            [&](uint32_t number, uint32_t overBowler, uint32_t firstBall, uint32_t ballCount, bool maiden) {
+                OverRecord o;
+                o.overNumber = number;
+                o.bowler = overBowler;
+                o.firstBall = firstBall;
+                o.ballCount = ballCount;
+                o.runs = 0;
+                o.wickets = 0;
+                o.isMaiden = maiden ? 1 : 0;
+                o.reserved = 0;
+                overs.push_back(o);
+            });
+        if(!ok) {
+            overs.clear();
+            return false;
+        }
+
+        balls.resize(n);
+        for(auto& o : overs) {
+            for(uint32_t i = o.firstBall; i < o.firstBall + o.ballCount; i++) {
+                BallRecord& b = balls[i];
+                b.timestamp = timestamp[i];
+                b.bowler = bowler[i];
+                b.batsman = batsman[i];
+                b.nonStriker = nonStriker[i];
+                b.fielder = fielder[i];
+                b.commentary = commentary[i];
+                b.overNumber = (int16_t)overNumber[i];
+                b.ballNumber = ballNumber[i];
+                b.outcome = outcome[i];
+                b.wicketType = wicketType[i];
+                b.runs = runs[i];
+                b.extras = extras[i];
+                b.flags = flags[i];
+                o.runs += b.runs + b.extras;
+                if(b.wicketType != (uint8_t)WicketType::NONE) o.wickets++;
+            }
+        }
+        return true;
+    }
+};
+
+#endif
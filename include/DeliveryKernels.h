@@ -0,0 +1,298 @@
+#ifndef DELIVERYKERNELS_H
+#define DELIVERYKERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// SSE2 is part of every x86-64 CPU; AVX2 is compiled per function and only
+// used after a runtime CPU check, so no extra compiler flags are needed.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define FAST_SCOREBOOK_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// Vectorized reductions over byte columns (runs, outcome codes, flags), and
+// selection scans that write the offsets of matching rows (at most 65536
+// per call). Every kernel has a scalar version, which is also used on
+// non-x86 builds.
+class DeliveryKernels {
+public:
+    enum Level {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+private:
+    static Level& activeLevel() {
+        static Level level = detectLevel();
+        return level;
+    }
+
+    // Scalar kernels
+
+    static uint64_t sumScalar(const uint8_t* v, size_t n) {
+        uint64_t total = 0;
+        for(size_t i = 0; i < n; i++) total += v[i];
+        return total;
+    }
+
+    static size_t countMaskedScalar(const uint8_t* v, size_t n, uint8_t mask, uint8_t want) {
+        size_t count = 0;
+        for(size_t i = 0; i < n; i++) count += ((v[i] & mask) == want);
+        return count;
+    }
+
+    static void histogramScalar(const uint8_t* v, size_t n, uint64_t* hist, int bins) {
+        for(size_t i = 0; i < n; i++) {
+            if(v[i] < bins) hist[v[i]]++;
+        }
+    }
+
+    static size_t selectEqualScalar(const uint32_t* v, size_t n, uint32_t value, uint16_t* sel, size_t from = 0) {
+        size_t kept = 0;
+        for(size_t i = from; i < n; i++) {
+            sel[kept] = (uint16_t)i;
+            kept += (v[i] == value);
+        }
+        return kept;
+    }
+
+    static size_t selectMaskedScalar(const uint8_t* v, size_t n, uint8_t mask, uint8_t want, uint16_t* sel,
+                                     size_t from = 0) {
+        size_t kept = 0;
+        for(size_t i = from; i < n; i++) {
+            sel[kept] = (uint16_t)i;
+            kept += ((v[i] & mask) == want);
+        }
+        return kept;
+    }
+
+    // Append base + the index of each set bit
+    static size_t appendBits(uint32_t bits, size_t base, uint16_t* sel) {
+        size_t kept = 0;
+        while(bits) {
+            sel[kept++] = (uint16_t)(base + __builtin_ctz(bits));
+            bits &= bits - 1;
+        }
+        return kept;
+    }
+
+#ifdef FAST_SCOREBOOK_X86_KERNELS
+    // SSE2 kernels: 16 bytes per step
+
+    static uint64_t horizontalSum(__m128i sums) {
+        uint64_t lanes[2];
+        _mm_storeu_si128((__m128i*)lanes, sums);
+        return lanes[0] + lanes[1];
+    }
+
+    static uint64_t sumSSE2(const uint8_t* v, size_t n) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc = zero;
+        size_t i = 0;
+        for(; i + 16 <= n; i += 16) {
+            // SAD against zero adds each group of eight bytes into a 64-bit lane
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128((const __m128i*)(v + i)), zero));
+        }
+        return horizontalSum(acc) + sumScalar(v + i, n - i);
+    }
+
+    static size_t countMaskedSSE2(const uint8_t* v, size_t n, uint8_t mask, uint8_t want) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i m = _mm_set1_epi8((char)mask);
+        const __m128i w = _mm_set1_epi8((char)want);
+        __m128i total = zero;
+        size_t i = 0;
+        while(i + 16 <= n) {
+            // Byte counters overflow after 255 steps, so flush them in batches
+            __m128i counts = zero;
+            size_t stop = i + 255 * 16 < n ? i + 255 * 16 : n;
+            for(; i + 16 <= stop; i += 16) {
+                __m128i x = _mm_and_si128(_mm_loadu_si128((const __m128i*)(v + i)), m);
+                counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(x, w));
+            }
+            total = _mm_add_epi64(total, _mm_sad_epu8(counts, zero));
+        }
+        return (size_t)horizontalSum(total) + countMaskedScalar(v + i, n - i, mask, want);
+    }
+
+    // Selective filters leave most compare masks empty, and those steps
+    // write nothing
+    static size_t selectEqualSSE2(const uint32_t* v, size_t n, uint32_t value, uint16_t* sel) {
+        const __m128i w = _mm_set1_epi32((int)value);
+        size_t kept = 0, i = 0;
+        for(; i + 4 <= n; i += 4) {
+            __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(v + i)), w);
+            uint32_t bits = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(eq));
+            if(bits) kept += appendBits(bits, i, sel + kept);
+        }
+        return kept + selectEqualScalar(v, n, value, sel + kept, i);
+    }
+
+    static size_t selectMaskedSSE2(const uint8_t* v, size_t n, uint8_t mask, uint8_t want, uint16_t* sel) {
+        const __m128i m = _mm_set1_epi8((char)mask);
+        const __m128i w = _mm_set1_epi8((char)want);
+        size_t kept = 0, i = 0;
+        for(; i + 16 <= n; i += 16) {
+            __m128i x = _mm_and_si128(_mm_loadu_si128((const __m128i*)(v + i)), m);
+            uint32_t bits = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, w));
+            if(bits) kept += appendBits(bits, i, sel + kept);
+        }
+        return kept + selectMaskedScalar(v, n, mask, want, sel + kept, i);
+    }
+
+    // AVX2 kernels: 32 bytes per step
+
+    __attribute__((target("avx2")))
+    static uint64_t sumAVX2(const uint8_t* v, size_t n) {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i acc = zero;
+        size_t i = 0;
+        for(; i + 32 <= n; i += 32) {
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i*)(v + i)), zero));
+        }
+        __m128i sums = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        return horizontalSum(sums) + sumScalar(v + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t countMaskedAVX2(const uint8_t* v, size_t n, uint8_t mask, uint8_t want) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i m = _mm256_set1_epi8((char)mask);
+        const __m256i w = _mm256_set1_epi8((char)want);
+        __m256i total = zero;
+        size_t i = 0;
+        while(i + 32 <= n) {
+            __m256i counts = zero;
+            size_t stop = i + 255 * 32 < n ? i + 255 * 32 : n;
+            for(; i + 32 <= stop; i += 32) {
+                __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(v + i)), m);
+                counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(x, w));
+            }
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(counts, zero));
+        }
+        __m128i sums = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+        return (size_t)horizontalSum(sums) + countMaskedScalar(v + i, n - i, mask, want);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t selectEqualAVX2(const uint32_t* v, size_t n, uint32_t value, uint16_t* sel) {
+        const __m256i w = _mm256_set1_epi32((int)value);
+        size_t kept = 0, i = 0;
+        for(; i + 8 <= n; i += 8) {
+            __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(v + i)), w);
+            uint32_t bits = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(eq));
+            if(bits) kept += appendBits(bits, i, sel + kept);
+        }
+        return kept + selectEqualScalar(v, n, value, sel + kept, i);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t selectMaskedAVX2(const uint8_t* v, size_t n, uint8_t mask, uint8_t want, uint16_t* sel) {
+        const __m256i m = _mm256_set1_epi8((char)mask);
+        const __m256i w = _mm256_set1_epi8((char)want);
+        size_t kept = 0, i = 0;
+        for(; i + 32 <= n; i += 32) {
+            __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(v + i)), m);
+            uint32_t bits = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, w));
+            if(bits) kept += appendBits(bits, i, sel + kept);
+        }
+        return kept + selectMaskedScalar(v, n, mask, want, sel + kept, i);
+    }
+#endif
+
+    static Level detectLevel() {
+#ifdef FAST_SCOREBOOK_X86_KERNELS
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) return AVX2;
+        return SSE2;
+#else
+        return SCALAR;
+#endif
+    }
+
+public:
+    static Level getLevel() { return activeLevel(); }
+
+    // Force a lower level, e.g. to compare against the scalar kernels.
+    // Requests above what the CPU supports are clamped.
+    static void setLevel(Level level) {
+        Level best = detectLevel();
+        activeLevel() = level < best ? level : best;
+    }
+
+    static const char* getLevelString(Level level) {
+        switch(level) {
+            case AVX2: return "AVX2";
+            case SSE2: return "SSE2";
+            default: return "Scalar";
+        }
+    }
+
+    // Sum of all bytes
+    static uint64_t sum(const uint8_t* v, size_t n) {
+#ifdef FAST_SCOREBOOK_X86_KERNELS
+        switch(activeLevel()) {
+            case AVX2: return sumAVX2(v, n);
+            case SSE2: return sumSSE2(v, n);
+            default: break;
+        }
+#endif
+        return sumScalar(v, n);
+    }
+
+    // Number of bytes where (v & mask) == want
+    static size_t countMasked(const uint8_t* v, size_t n, uint8_t mask, uint8_t want) {
+#ifdef FAST_SCOREBOOK_X86_KERNELS
+        switch(activeLevel()) {
+            case AVX2: return countMaskedAVX2(v, n, mask, want);
+            case SSE2: return countMaskedSSE2(v, n, mask, want);
+            default: break;
+        }
+#endif
+        return countMaskedScalar(v, n, mask, want);
+    }
+
+    // Write the offsets i where v[i] == value to sel; returns how many
+    static size_t selectEqual(const uint32_t* v, size_t n, uint32_t value, uint16_t* sel) {
+#ifdef FAST_SCOREBOOK_X86_KERNELS
+        switch(activeLevel()) {
+            case AVX2: return selectEqualAVX2(v, n, value, sel);
+            case SSE2: return selectEqualSSE2(v, n, value, sel);
+            default: break;
+        }
+#endif
+        return selectEqualScalar(v, n, value, sel);
+    }
+
+    // Write the offsets i where (v[i] & mask) == want to sel; returns how many
+    static size_t selectMasked(const uint8_t* v, size_t n, uint8_t mask, uint8_t want, uint16_t* sel) {
+#ifdef FAST_SCOREBOOK_X86_KERNELS
+        switch(activeLevel()) {
+            case AVX2: return selectMaskedAVX2(v, n, mask, want, sel);
+            case SSE2: return selectMaskedSSE2(v, n, mask, want, sel);
+            default: break;
+        }
+#endif
+        return selectMaskedScalar(v, n, mask, want, sel);
+    }
+
+    static size_t countEqual(const uint8_t* v, size_t n, uint8_t value) {
+        return countMasked(v, n, 0xFF, value);
+    }
+
+    // Count of each value below bins; larger values are ignored. Meant for
+    // small code sets like BallOutcome, where one vector pass per bin beats
+    // a scattered scalar histogram.
+    static void histogram(const uint8_t* v, size_t n, uint64_t* hist, int bins) {
+        if(activeLevel() == SCALAR) {
+            histogramScalar(v, n, hist, bins);
+            return;
+        }
+        for(int b = 0; b < bins; b++) hist[b] += countEqual(v, n, (uint8_t)b);
+    }
+};
+
+#endif
@@ -0,0 +1,469 @@
+#ifndef DELIVERYQUERY_H
+#define DELIVERYQUERY_H
+
+#include "MatchArchive.h"
+#include "DeliveryCodec.h"
+#include "DeliveryKernels.h"
+#include "TaskPool.h"
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+enum DeliveryFlags {
+    DELIVERY_VALID = 1,
+    DELIVERY_LEFT_HANDED_BATTER = 2
+};
+
+// Deliveries of one archive partition stored column by column, so a filter
+// only reads the columns it tests. Rows are in archive order.
+struct DeliveryColumns {
+    vector<uint32_t> matchNo;
+    vector<uint32_t> bowler;     // PlayerId
+    vector<uint32_t> batter;     // PlayerId
+    vector<uint32_t> venue;      // Archive name key
+    vector<uint16_t> over;
+    vector<uint8_t> outcome;     // BallOutcome
+    vector<uint8_t> wicketType;  // WicketType
+    vector<uint8_t> runs;
+    vector<uint8_t> extras;
+    vector<uint8_t> matchType;   // MatchType
+    vector<uint8_t> flags;       // DeliveryFlags
+
+    // Partition summary used to skip whole partitions
+    uint32_t typeMask;
+    uint16_t minOver;
+    uint16_t maxOver;
+
+    DeliveryColumns() : typeMask(0), minOver(0xFFFF), maxOver(0) {}
+
+    size_t size() const { return outcome.size(); }
+
+    void reserve(size_t n) {
+        matchNo.reserve(n); bowler.reserve(n); batter.reserve(n); venue.reserve(n);
+        over.reserve(n); outcome.reserve(n); wicketType.reserve(n); runs.reserve(n);
+        extras.reserve(n); matchType.reserve(n); flags.reserve(n);
+    }
+
+    void resize(size_t n) {
+        matchNo.resize(n); bowler.resize(n); batter.resize(n); venue.resize(n);
+        over.resize(n); outcome.resize(n); wicketType.resize(n); runs.resize(n);
+        extras.resize(n); matchType.resize(n); flags.resize(n);
+    }
+
+    void append(uint32_t match, uint32_t bowlerId, uint32_t batterId, uint32_t venueKey,
+                uint16_t overNo, uint8_t out, uint8_t wicket, uint8_t r, uint8_t ext,
+                uint8_t type, uint8_t f) {
+        matchNo.push_back(match);
+        bowler.push_back(bowlerId);
+        batter.push_back(batterId);
+        venue.push_back(venueKey);
+        over.push_back(overNo);
+        outcome.push_back(out);
+        wicketType.push_back(wicket);
+        runs.push_back(r);
+        extras.push_back(ext);
+        matchType.push_back(type);
+        flags.push_back(f);
+        typeMask |= 1u << type;
+        if(overNo < minOver) minOver = overNo;
+        if(overNo > maxOver) maxOver = overNo;
+    }
+
+    // Append every ball of an archived match, translating snapshot-local
+    // player indexes to registry IDs. The columns are grown once for the
+    // whole match; packed snapshots are decoded a column at a time straight
+    // into them without materializing ball records.
+    void appendSnapshot(const MatchSnapshot& snapshot, uint32_t match, uint32_t venueKey) {
+        bool packed = snapshot.isPacked();
+        uint32_t ballCount = packed ? DeliveryCodec::countBalls(snapshot) : snapshot.count(SECTION_BALLS);
+        if(ballCount == 0) return;
+
+        // Registry ID and handedness by player index; the last slot stands
+        // in for a missing or out-of-range index
+        uint32_t playerCount = snapshot.count(SECTION_PLAYERS);
+        vector<uint32_t> ids(playerCount + 1, INVALID_PLAYER_ID);
+        vector<uint8_t> lefty(playerCount + 1, 0);
+        for(uint32_t p = 0; p < playerCount; p++) {
+            const PlayerRecord& player = snapshot.player(p);
+            ids[p] = player.registryId;
+            lefty[p] = (player.flags & PLAYER_LEFT_HANDED) ? DELIVERY_LEFT_HANDED_BATTER : 0;
+        }
+
+        size_t first = size();
+        resize(first + ballCount);
+        uint8_t type = (uint8_t)snapshot.header().matchType;
+        fill(matchNo.begin() + first, matchNo.end(), match);
+        fill(venue.begin() + first, venue.end(), venueKey);
+        fill(matchType.begin() + first, matchType.end(), type);
+        typeMask |= 1u << type;
+
+        if(packed) {
+            // Whole columns at a time, player indexes mapped as they decode
+            // (BALL_VALID and DELIVERY_VALID are the same bit)
+            PackedColumns cols;
+            cols.overNumber = &over[first];
+            cols.bowler = &bowler[first];
+            cols.batsman = &batter[first];
+            cols.outcome = &outcome[first];
+            cols.wicketType = &wicketType[first];
+            cols.runs = &runs[first];
+            cols.extras = &extras[first];
+            cols.flags = &flags[first];
+            cols.playerMap = ids.data();
+            cols.batterFlags = lefty.data();
+            cols.playerCount = playerCount;
+            if(!DeliveryCodec::decode(snapshot, cols, [](uint32_t, uint32_t, uint32_t, uint32_t, bool) {})) {
+                resize(first);   // Truncated stream
+                return;
+            }
+        } else {
+            const BallRecord* balls = snapshot.section<BallRecord>(SECTION_BALLS);
+            for(uint32_t i = 0; i < ballCount; i++) {
+                const BallRecord& b = balls[i];
+                size_t row = first + i;
+                uint32_t bowlerIndex = b.bowler < playerCount ? b.bowler : playerCount;
+                uint32_t batterIndex = b.batsman < playerCount ? b.batsman : playerCount;
+                bowler[row] = ids[bowlerIndex];
+                batter[row] = ids[batterIndex];
+                over[row] = (uint16_t)b.overNumber;
+                outcome[row] = b.outcome;
+                wicketType[row] = b.wicketType;
+                runs[row] = b.runs;
+                extras[row] = b.extras;
+                flags[row] = (uint8_t)(((b.flags & BALL_VALID) ? DELIVERY_VALID : 0) | lefty[batterIndex]);
+            }
+        }
+
+        uint16_t lowOver = minOver, highOver = maxOver;
+        for(size_t row = first; row < first + ballCount; row++) {
+            lowOver = min(lowOver, over[row]);
+            highOver = max(highOver, over[row]);
+        }
+        minOver = lowOver;
+        maxOver = highOver;
+    }
+};
+
+// Load the archive into column partitions of matchesPerPartition matches each, in parallel
+inline vector<DeliveryColumns> loadDeliveryPartitions(const MatchArchive& archive,
+                                                      size_t matchesPerPartition,
+                                                      TaskPool& pool = TaskPool::shared()) {
+    size_t matchCount = archive.getMatchCount();
+    if(matchesPerPartition == 0) matchesPerPartition = 1;
+    vector<DeliveryColumns> partitions((matchCount + matchesPerPartition - 1) / matchesPerPartition);
+    pool.parallelFor(0, partitions.size(), 1, [&](size_t p0, size_t p1) {
+        MatchSnapshot snapshot;
+        for(size_t p = p0; p < p1; p++) {
+            uint32_t first = (uint32_t)(p * matchesPerPartition);
+            uint32_t last = (uint32_t)min(matchCount, (p + 1) * matchesPerPartition);
+            for(uint32_t n = first; n < last; n++) {
+                if(archive.openSnapshot(n, snapshot)) {
+                    partitions[p].appendSnapshot(snapshot, n, archive.getRecord(n).venue);
+                }
+            }
+        }
+    });
+    return partitions;
+}
+
+// Totals for one group of matching deliveries
+struct DeliveryAggregate {
+    uint64_t deliveries;
+    uint64_t legalBalls;
+    uint64_t runs;        // Off the bat
+    uint64_t extras;
+    uint64_t wickets;
+
+    DeliveryAggregate() : deliveries(0), legalBalls(0), runs(0), extras(0), wickets(0) {}
+
+    void add(const DeliveryAggregate& other) {
+        deliveries += other.deliveries;
+        legalBalls += other.legalBalls;
+        runs += other.runs;
+        extras += other.extras;
+        wickets += other.wickets;
+    }
+};
+
+enum class DeliveryGroupBy {
+    NONE,
+    OUTCOME,
+    WICKET_TYPE,
+    BOWLER,
+    BATTER,
+    OVER,
+    MATCH
+};
+
+// Ad-hoc delivery query with filters pushed down to column scans.
+//
+// Each partition is first checked against its summary (match types, over
+// range) and skipped if it cannot match. Surviving partitions are scanned in
+// blocks: the first filter scans its whole column block and writes the
+// matching row offsets into a selection vector, using the vector kernels for
+// player, venue and flag filters, so a selective filter skips runs of rows a
+// register at a time. Each later filter only reads its column at the offsets
+// still selected, compacting the vector in place. A block is dropped as
+// soon as its selection is empty. Partitions run in parallel on the
+// TaskPool and their groups are merged at the end.
+class DeliveryQuery {
+public:
+    static const size_t BLOCK_SIZE = 2048;
+    typedef map<uint32_t, DeliveryAggregate> Result;
+
+private:
+    uint32_t bowler;
+    uint32_t batter;
+    uint32_t venue;
+    bool hasBowler;     // Any ID is a valid filter value, INVALID_PLAYER_ID included
+    bool hasBatter;
+    bool hasVenue;
+    bool impossible;    // A filter that can match nothing, e.g. a reversed over range
+    uint32_t outcomeMask;
+    uint32_t wicketMask;
+    uint32_t typeMask;
+    uint16_t overFrom;
+    uint16_t overTo;
+    int handedness; // -1 any, 0 right-handed batters, 1 left-handed
+    bool legalOnly;
+    DeliveryGroupBy groupBy;
+
+    static const uint32_t ALL = 0xFFFFFFFF;     // Every code passes a mask filter
+
+    bool partitionMayMatch(const DeliveryColumns& cols) const {
+        if(impossible) return false;
+        if((cols.typeMask & typeMask) == 0) return false;
+        if(cols.size() == 0 || cols.maxOver < overFrom || cols.minOver > overTo) return false;
+        return true;
+    }
+
+    uint32_t groupKey(const DeliveryColumns& cols, size_t row) const {
+        switch(groupBy) {
+            case DeliveryGroupBy::OUTCOME: return cols.outcome[row];
+            case DeliveryGroupBy::WICKET_TYPE: return cols.wicketType[row];
+            case DeliveryGroupBy::BOWLER: return cols.bowler[row];
+            case DeliveryGroupBy::BATTER: return cols.batter[row];
+            case DeliveryGroupBy::OVER: return cols.over[row];
+            case DeliveryGroupBy::MATCH: return cols.matchNo[row];
+            default: return 0;
+        }
+    }
+
+    // Keep the selected rows whose column value passes the test
+    template<typename T, typename Pred>
+    static size_t refine(const T* column, uint16_t* sel, size_t count, size_t n, bool first, Pred pass) {
+        size_t kept = 0;
+        if(first) {
+            for(size_t i = 0; i < n; i++) {
+                sel[kept] = (uint16_t)i;
+                kept += pass(column[i]);
+            }
+        } else {
+            for(size_t k = 0; k < count; k++) {
+                uint16_t i = sel[k];
+                sel[kept] = i;
+                kept += pass(column[i]);
+            }
+        }
+        return kept;
+    }
+
+    static size_t refineEqual(const uint32_t* column, uint16_t* sel, size_t count, size_t n, bool first,
+                              uint32_t value) {
+        if(first) return DeliveryKernels::selectEqual(column, n, value, sel);
+        return refine(column, sel, count, n, false, [=](uint32_t v) { return v == value; });
+    }
+
+    static size_t refineMasked(const uint8_t* column, uint16_t* sel, size_t count, size_t n, bool first,
+                               uint8_t mask, uint8_t want) {
+        if(first) return DeliveryKernels::selectMasked(column, n, mask, want, sel);
+        return refine(column, sel, count, n, false, [=](uint8_t v) { return (v & mask) == want; });
+    }
+
+    void scanPartition(const DeliveryColumns& cols, Result& groups) const {
+        if(!partitionMayMatch(cols)) return;
+        uint16_t sel[BLOCK_SIZE];
+        const uint32_t overSpan = (uint32_t)(overTo - overFrom);
+        const uint16_t lowOver = overFrom;
+        const uint32_t bowlerId = bowler, batterId = batter, venueKey = venue;
+        const uint32_t outcomes = outcomeMask, wickets = wicketMask, types = typeMask;
+        uint8_t flagMask = 0, flagWant = 0;
+        if(legalOnly) { flagMask |= DELIVERY_VALID; flagWant |= DELIVERY_VALID; }
+        if(handedness >= 0) {
+            flagMask |= DELIVERY_LEFT_HANDED_BATTER;
+            if(handedness == 1) flagWant |= DELIVERY_LEFT_HANDED_BATTER;
+        }
+
+        for(size_t base = 0; base < cols.size(); base += BLOCK_SIZE) {
+            size_t n = min(BLOCK_SIZE, cols.size() - base);
+            size_t count = n;
+            bool first = true;
+
+            // Most selective filters first
+            if(hasBowler) {
+                count = refineEqual(&cols.bowler[base], sel, count, n, first, bowlerId);
+                first = false;
+                if(count == 0) continue;
+            }
+            if(hasBatter) {
+                count = refineEqual(&cols.batter[base], sel, count, n, first, batterId);
+                first = false;
+                if(count == 0) continue;
+            }
+            if(hasVenue) {
+                count = refineEqual(&cols.venue[base], sel, count, n, first, venueKey);
+                first = false;
+                if(count == 0) continue;
+            }
+            if(overFrom != 0 || overTo != 0xFFFF) {
+                count = refine(&cols.over[base], sel, count, n, first,
+                               [=](uint16_t v) { return (uint32_t)(uint16_t)(v - lowOver) <= overSpan; });
+                first = false;
+                if(count == 0) continue;
+            }
+            if(flagMask) {
+                count = refineMasked(&cols.flags[base], sel, count, n, first, flagMask, flagWant);
+                first = false;
+                if(count == 0) continue;
+            }
+            if(outcomes != ALL) {
+                count = refine(&cols.outcome[base], sel, count, n, first,
+                               [=](uint8_t v) { return ((outcomes >> (v & 31)) & 1) != 0; });
+                first = false;
+                if(count == 0) continue;
+            }
+            if(wickets != ALL) {
+                count = refine(&cols.wicketType[base], sel, count, n, first,
+                               [=](uint8_t v) { return ((wickets >> (v & 31)) & 1) != 0; });
+                first = false;
+                if(count == 0) continue;
+            }
+            if(types != ALL) {
+                count = refine(&cols.matchType[base], sel, count, n, first,
+                               [=](uint8_t v) { return ((types >> (v & 31)) & 1) != 0; });
+                first = false;
+                if(count == 0) continue;
+            }
+            if(first) {
+                for(size_t i = 0; i < n; i++) sel[i] = (uint16_t)i;
+            }
+
+            for(size_t k = 0; k < count; k++) {
+                size_t row = base + sel[k];
+                DeliveryAggregate& agg = groups[groupKey(cols, row)];
+                agg.deliveries++;
+                if(cols.flags[row] & DELIVERY_VALID) agg.legalBalls++;
+                if(cols.outcome[row] != (uint8_t)BallOutcome::BYE &&
+                   cols.outcome[row] != (uint8_t)BallOutcome::LEG_BYE) {
+                    agg.runs += cols.runs[row];
+                } else {
+                    agg.extras += cols.runs[row];
+                }
+                agg.extras += cols.extras[row];
+                if(cols.wicketType[row] != (uint8_t)WicketType::NONE) agg.wickets++;
+            }
+        }
+    }
+
+public:
+    DeliveryQuery()
+        : bowler(0), batter(0), venue(0), hasBowler(false), hasBatter(false), hasVenue(false),
+          impossible(false), outcomeMask(ALL), wicketMask(ALL), typeMask(ALL), overFrom(0),
+          overTo(0xFFFF), handedness(-1), legalOnly(false), groupBy(DeliveryGroupBy::NONE) {}
+
+    // Filters (each call narrows the query)
+    DeliveryQuery& byBowler(PlayerId id) { bowler = id; hasBowler = true; return *this; }
+    DeliveryQuery& toBatter(PlayerId id) { batter = id; hasBatter = true; return *this; }
+    DeliveryQuery& atVenue(uint32_t venueKey) { venue = venueKey; hasVenue = true; return *this; }
+
+    // Inclusive; a range with to < from matches nothing
+    DeliveryQuery& inOvers(int from, int to) {
+        if(from < 0) from = 0;
+        if(to > 0xFFFF) to = 0xFFFF;
+        if(to < from) {
+            impossible = true;
+            return *this;
+        }
+        overFrom = (uint16_t)from;
+        overTo = (uint16_t)to;
+        return *this;
+    }
+    DeliveryQuery& toLeftHanders() { handedness = 1; return *this; }
+    DeliveryQuery& toRightHanders() { handedness = 0; return *this; }
+    DeliveryQuery& legalDeliveriesOnly() { legalOnly = true; return *this; }
+
+    DeliveryQuery& withOutcome(BallOutcome outcome) {
+        if(outcomeMask == ALL) outcomeMask = 0;
+        outcomeMask |= 1u << (int)outcome;
+        return *this;
+    }
+
+    DeliveryQuery& withWicketType(WicketType type) {
+        if(wicketMask == ALL) wicketMask = 0;
+        wicketMask |= 1u << (int)type;
+        return *this;
+    }
+
+    DeliveryQuery& ofMatchType(MatchType type) {
+        if(typeMask == ALL) typeMask = 0;
+        typeMask |= 1u << (int)type;
+        return *this;
+    }
+
+    DeliveryQuery& groupedBy(DeliveryGroupBy g) { groupBy = g; return *this; }
+
+    Result run(const DeliveryColumns& cols) const {
+        Result groups;
+        scanPartition(cols, groups);
+        return groups;
+    }
+
+    // Scan every partition in parallel and merge the groups
+    Result run(const vector<DeliveryColumns>& partitions, TaskPool& pool = TaskPool::shared()) const {
+        // A few chunks per worker keeps stealing useful without a map per partition
+        size_t grain = partitions.size() / (pool.getWorkerCount() * 4 + 1) + 1;
+        return pool.parallelReduce(0, partitions.size(), grain, Result(),
+            [&](size_t p0, size_t p1) {
+                Result groups;
+                for(size_t p = p0; p < p1; p++) scanPartition(partitions[p], groups);
+                return groups;
+            },
+            [](Result a, const Result& b) {
+                for(const auto& g : b) a[g.first].add(g.second);
+                return a;
+            });
+    }
+
+    // Rows in the partitions whose summaries let them through to a scan
+    uint64_t getScannedRows(const vector<DeliveryColumns>& partitions) const {
+        uint64_t rows = 0;
+        for(const auto& p : partitions) {
+            if(partitionMayMatch(p)) rows += p.size();
+        }
+        return rows;
+    }
+
+    string getGroupLabel(uint32_t key) const {
+        switch(groupBy) {
+            case DeliveryGroupBy::OUTCOME: return Ball::outcomeToString((BallOutcome)key);
+            case DeliveryGroupBy::WICKET_TYPE: return Ball::wicketTypeToString((WicketType)key);
+            case DeliveryGroupBy::BOWLER: return "Bowler #" + to_string(key);
+            case DeliveryGroupBy::BATTER: return "Batter #" + to_string(key);
+            case DeliveryGroupBy::OVER: return "Over " + to_string(key);
+            case DeliveryGroupBy::MATCH: return "Match " + to_string(key);
+            default: return "All";
+        }
+    }
+
+    void displayResult(const Result& result) const {
+        cout << "\n===== Delivery Query =====" << endl;
+        for(const auto& g : result) {
+            const DeliveryAggregate& a = g.second;
+            cout << "  " << getGroupLabel(g.first) << ": " << a.deliveries << " deliveries, "
+                 << a.runs << " runs, " << a.extras << " extras, " << a.wickets << " wickets" << endl;
+        }
+        if(result.empty()) cout << "  No matching deliveries" << endl;
+    }
+};
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+
+#include "Match.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+enum class MatchEventKind : uint8_t {
+    DELIVERY,
+    CONFLICT,
+    RESOLUTION,
+    CONSENSUS       // Scorers agree on a ball, with none dissenting
+};
+
+enum MatchEventFlags {
+    EVENT_AUTOMATIC = 1     // Resolutions: ruled on by weighted vote, not a supervisor
+};
+
+// What a subscriber does when it falls a full ring behind the producer
+enum class SlowConsumerPolicy {
+    BLOCK,  // The producer waits for this subscriber
+    DROP    // This subscriber skips the events it missed
+};
+
+// One published event; fixed size so it can live in a ring slot
+struct MatchEvent {
+    uint64_t sequence;
+    const Match* match;
+    int64_t timestamp;
+    MatchEventKind kind;
+    uint8_t outcome;        // BallOutcome
+    uint8_t wicketType;     // WicketType
+    uint8_t inningsNumber;
+    uint8_t flags;          // MatchEventFlags
+    int32_t overNumber;
+    int32_t ballNumber;
+    int32_t runs;
+    int32_t extras;
+    PlayerId batter;
+    PlayerId bowler;
+    int32_t inningsRuns;    // Deliveries: score after this ball
+    int32_t inningsWickets;
+    int32_t entryCount;     // Conflicts: entries in the dispute; consensus: scorers agreeing
+    const Supervisor* supervisor;   // Resolutions: who ruled, if a local supervisor did
+
+    MatchEvent() : sequence(0), match(nullptr), timestamp(0), kind(MatchEventKind::DELIVERY),
+                   outcome(0), wicketType(0), inningsNumber(0), flags(0), overNumber(0), ballNumber(0),
+                   runs(0), extras(0), batter(INVALID_PLAYER_ID), bowler(INVALID_PLAYER_ID),
+                   inningsRuns(0), inningsWickets(0), entryCount(0), supervisor(nullptr) {}
+
+    static string kindToString(MatchEventKind kind) {
+        switch(kind) {
+            case MatchEventKind::DELIVERY: return "Delivery";
+            case MatchEventKind::CONFLICT: return "Conflict";
+            case MatchEventKind::RESOLUTION: return "Resolution";
+            case MatchEventKind::CONSENSUS: return "Consensus";
+            default: return "Unknown";
+        }
+    }
+};
+
+// A subscriber's position in the bus. Only its own consumer thread reads
+// events through it; the producer only looks at the first cache line
+// (next, policy, active), and only when the ring wraps. Cursors are
+// allocated on their own lines so neighbouring subscribers never share one.
+class alignas(64) EventCursor {
+private:
+    friend class EventBus;
+
+    atomic<uint64_t> next;  // Sequence of the next event to read
+    SlowConsumerPolicy policy;
+    atomic<bool> active;
+    char padding[48];       // The consumer's counters start on the next line
+    atomic<uint64_t> received;
+    atomic<uint64_t> dropped;
+    string name;
+
+public:
+    EventCursor(const string& n, SlowConsumerPolicy p, uint64_t start)
+        : next(start), policy(p), active(true), received(0), dropped(0), name(n) {}
+
+    // Plain new only guarantees 16-byte alignment before C++17
+    static void* operator new(size_t size) {
+        void* raw = ::operator new(size + 64);
+        uintptr_t aligned = ((uintptr_t)raw + 64) & ~(uintptr_t)63;
+        ((void**)aligned)[-1] = raw;
+        return (void*)aligned;
+    }
+
+    static void operator delete(void* p) {
+        if(p) ::operator delete(((void**)p)[-1]);
+    }
+
+    const string& getName() const { return name; }
+    SlowConsumerPolicy getPolicy() const { return policy; }
+    uint64_t getNext() const { return next.load(memory_order_acquire); }
+    uint64_t getReceived() const { return received.load(memory_order_relaxed); }
+    uint64_t getDropped() const { return dropped.load(memory_order_relaxed); }
+    bool isActive() const { return active.load(memory_order_acquire); }
+};
+
+// Single-producer, multi-consumer ring buffer (disruptor style).
+// The scoring thread publishes each event once into a power-of-two ring;
+// every subscriber reads the same slots through its own cursor, so adding
+// subscribers adds no work to publish(). The producer consults BLOCK
+// cursors only when it is about to overwrite a slot it has not seen
+// them pass, and never waits for DROP subscribers. Slots are versioned
+// like a seqlock so a DROP reader can tell when one was overwritten
+// under it. All publishing must happen on one thread.
+class EventBus : public DeliveryListener {
+public:
+    static const size_t MAX_SUBSCRIBERS = 64;
+
+private:
+    struct Slot {
+        atomic<uint64_t> version;   // 2 * sequence + 2 once written, odd while writing
+        MatchEvent event;
+    };
+
+    unique_ptr<Slot[]> slots;
+    size_t capacity;
+    size_t mask;
+
+    char padBefore[64];
+    atomic<uint64_t> published;     // Events visible to subscribers
+    char padAfter[56];
+    uint64_t gatingCache;           // Producer only: slowest BLOCK cursor last seen
+    uint64_t producerWaits;
+
+    unique_ptr<EventCursor> cursors[MAX_SUBSCRIBERS];
+    atomic<size_t> cursorCount;
+    mutex subscribeLock;
+
+    // Lowest cursor the producer must not lap
+    uint64_t slowestBlockingCursor(uint64_t upTo) const {
+        uint64_t slowest = upTo;
+        size_t count = cursorCount.load(memory_order_acquire);
+        for(size_t i = 0; i < count; i++) {
+            const EventCursor& c = *cursors[i];
+            if(c.policy != SlowConsumerPolicy::BLOCK || !c.active.load(memory_order_acquire)) continue;
+            uint64_t at = c.next.load(memory_order_acquire);
+            if(at < slowest) slowest = at;
+        }
+        return slowest;
+    }
+
+public:
+    EventBus(size_t minCapacity = 4096) : capacity(1), published(0), gatingCache(0),
+                                          producerWaits(0), cursorCount(0) {
+        while(capacity < minCapacity) capacity <<= 1;
+        mask = capacity - 1;
+        slots.reset(new Slot[capacity]);
+        for(size_t i = 0; i < capacity; i++) slots[i].version.store(0, memory_order_relaxed);
+    }
+
+    // No copies: cursors and matches point into the bus
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    // New subscribers see events published from now on
+    EventCursor* subscribe(const string& name, SlowConsumerPolicy policy = SlowConsumerPolicy::DROP) {
+        lock_guard<mutex> lock(subscribeLock);
+        size_t count = cursorCount.load(memory_order_relaxed);
+        if(count == MAX_SUBSCRIBERS) return nullptr;
+        cursors[count].reset(new EventCursor(name, policy, published.load(memory_order_acquire)));
+        cursorCount.store(count + 1, memory_order_release);
+        return cursors[count].get();
+    }
+
+    // Stop gating the producer on this cursor; it stays valid until the bus goes away
+    void unsubscribe(EventCursor* cursor) {
+        if(cursor) cursor->active.store(false, memory_order_release);
+    }
+
+    void publish(const MatchEvent& event) {
+        uint64_t s = published.load(memory_order_relaxed);
+        if(s >= capacity) {
+            uint64_t wrapPoint = s - capacity;
+            if(gatingCache <= wrapPoint) {
+                gatingCache = slowestBlockingCursor(s);
+                while(gatingCache <= wrapPoint) {
+                    producerWaits++;
+                    this_thread::yield();
+                    gatingCache = slowestBlockingCursor(s);
+                }
+            }
+        }
+
+        Slot& slot = slots[s & mask];
+        slot.version.store(2 * s + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        slot.event = event;
+        slot.event.sequence = s;
+        slot.version.store(2 * s + 2, memory_order_release);
+        published.store(s + 1, memory_order_release);
+    }
+
+    void publishDelivery(const Match& match, const Innings& innings, const Ball& ball) {
+        MatchEvent e;
+        e.kind = MatchEventKind::DELIVERY;
+        e.match = &match;
+        e.timestamp = (int64_t)ball.getTimestamp();
+        e.outcome = (uint8_t)ball.getOutcome();
+        e.wicketType = (uint8_t)ball.getWicketType();
+        e.inningsNumber = (uint8_t)innings.getInningsNumber();
+        e.overNumber = ball.getOverNumber();
+        e.ballNumber = ball.getBallNumber();
+        e.runs = ball.getRuns();
+        e.extras = ball.getExtras();
+        e.batter = ball.getBatsmanId();
+        e.bowler = ball.getBowlerId();
+        e.inningsRuns = innings.getTotalRuns();
+        e.inningsWickets = innings.getTotalWickets();
+        publish(e);
+    }
+
+    void onDelivery(const Match& match, const Innings& innings, const Ball& ball) override {
+        publishDelivery(match, innings, ball);
+    }
+
+    // Publish the match's deliveries and give each of its broadcasters and
+    // commentators its own DROP cursor, so none can hold up scoring
+    void attach(Match& match) {
+        match.addDeliveryListener(this);
+        for(auto agency : match.getBroadcasters()) {
+            if(!agency->getFeed()) agency->setFeed(subscribe(agency->getAgencyName(), SlowConsumerPolicy::DROP));
+        }
+        for(auto commentator : match.getCommentators()) {
+            if(!commentator->getFeed()) commentator->setFeed(subscribe(commentator->getName(), SlowConsumerPolicy::DROP));
+        }
+    }
+
+    // Air the deliveries a broadcaster has not seen yet; returns how many
+    size_t catchUp(BroadcastAgency& agency) {
+        if(!agency.getFeed()) return 0;
+        return poll(*agency.getFeed(), [&agency](const MatchEvent& e) {
+            if(e.kind != MatchEventKind::DELIVERY) return;
+            agency.airDelivery(to_string(e.inningsRuns) + "/" + to_string(e.inningsWickets) + " (" +
+                               to_string(e.overNumber) + "." + to_string(e.ballNumber) + ")");
+        });
+    }
+
+    // Call the deliveries a commentator has not seen yet; returns how many events were read
+    size_t catchUp(Commentator& commentator) {
+        if(!commentator.getFeed()) return 0;
+        return poll(*commentator.getFeed(), [&commentator](const MatchEvent& e) {
+            if(e.kind == MatchEventKind::DELIVERY) commentator.callDelivery(e.wicketType != (uint8_t)WicketType::NONE);
+        });
+    }
+
+    // Hand up to maxEvents new events to fn(const MatchEvent&); returns how many
+    template<typename Fn>
+    size_t poll(EventCursor& cursor, Fn fn, size_t maxEvents = SIZE_MAX) {
+        uint64_t available = published.load(memory_order_acquire);
+        uint64_t n = cursor.next.load(memory_order_relaxed);
+        if(available - n > capacity) {
+            // Only DROP cursors can be lapped
+            cursor.dropped.fetch_add(available - capacity - n, memory_order_relaxed);
+            n = available - capacity;
+        }
+
+        size_t delivered = 0;
+        while(n < available && delivered < maxEvents) {
+            Slot& slot = slots[n & mask];
+            uint64_t expected = 2 * n + 2;
+            uint64_t before = slot.version.load(memory_order_acquire);
+            MatchEvent copy = slot.event;
+            atomic_thread_fence(memory_order_acquire);
+            uint64_t after = slot.version.load(memory_order_relaxed);
+            if(before != expected || after != expected) {
+                // Overwritten while we were behind
+                cursor.dropped.fetch_add(1, memory_order_relaxed);
+            } else {
+                fn(copy);
+                delivered++;
+            }
+            n++;
+            cursor.next.store(n, memory_order_release);
+        }
+        cursor.received.fetch_add(delivered, memory_order_relaxed);
+        return delivered;
+    }
+
+    // Poll until at least one event arrives or stop becomes true
+    template<typename Fn>
+    size_t waitAndPoll(EventCursor& cursor, Fn fn, const atomic<bool>& stop, size_t maxEvents = SIZE_MAX) {
+        size_t n;
+        while((n = poll(cursor, fn, maxEvents)) == 0 && !stop.load(memory_order_acquire)) {
+            this_thread::yield();
+        }
+        return n;
+    }
+
+    void displaySubscribers() const {
+        cout << "\nEvent bus: " << getPublished() << " events published, ring of " << capacity
+             << ", producer waited " << producerWaits << " times" << endl;
+        size_t count = cursorCount.load(memory_order_acquire);
+        for(size_t i = 0; i < count; i++) {
+            const EventCursor& c = *cursors[i];
+            cout << "  " << c.getName() << " ("
+                 << (c.getPolicy() == SlowConsumerPolicy::BLOCK ? "block" : "drop") << "): "
+                 << c.getReceived() << " received, " << c.getDropped() << " dropped, "
+                 << getBacklog(c) << " pending" << (c.isActive() ? "" : " [unsubscribed]") << endl;
+        }
+    }
+
+    uint64_t getPublished() const { return published.load(memory_order_acquire); }
+    uint64_t getBacklog(const EventCursor& cursor) const { return getPublished() - cursor.getNext(); }
+    size_t getCapacity() const { return capacity; }
+    size_t getSubscriberCount() const { return cursorCount.load(memory_order_acquire); }
+    uint64_t getProducerWaits() const { return producerWaits; }
+};
+
+#endif
@@ -3,7 +3,96 @@
 
 #include "Ball.h"
 #include "Team.h"
+#include "Trace.h"
 #include <vector>
+#include <unordered_map>
+
+// Phases of a limited-overs innings
+enum class InningsPhase {
+    POWERPLAY,
+    MIDDLE,
+    DEATH
+};
+
+const int PHASE_COUNT = 3;
+
+// Running counters for one phase, updated incrementally on every delivery.
+// The same counters serve the team, a batter and a bowler; only the
+// perspective of which runs and balls count differs.
+struct PhaseStats {
+    int runs;
+    int balls;
+    int wickets;
+    int dotBalls;
+    int fours;
+    int sixes;
+
+    PhaseStats() : runs(0), balls(0), wickets(0), dotBalls(0), fours(0), sixes(0) {}
+
+    void addBoundary(const Ball* ball) {
+        if(ball->getOutcome() == BallOutcome::FOUR) fours++;
+        else if(ball->getOutcome() == BallOutcome::SIX) sixes++;
+    }
+
+    // Every run counts, legal balls only
+    void addTeamBall(const Ball* ball) {
+        runs += ball->getTotalRuns();
+        if(ball->getIsValid()) {
+            balls++;
+            if(ball->getTotalRuns() == 0) dotBalls++;
+        }
+        if(ball->getWicketType() != WicketType::NONE) wickets++;
+        addBoundary(ball);
+    }
+
+    // Runs off the bat and balls faced (wides are not faced)
+    void addBatterBall(const Ball* ball) {
+        bool offBat = ball->getOutcome() != BallOutcome::BYE &&
+                      ball->getOutcome() != BallOutcome::LEG_BYE;
+        if(offBat) runs += ball->getRuns();
+        if(ball->getOutcome() != BallOutcome::WIDE) {
+            balls++;
+            if(!offBat || ball->getRuns() == 0) dotBalls++;
+        }
+        if(ball->getWicketType() != WicketType::NONE) wickets++;
+        addBoundary(ball);
+    }
+
+    // Runs conceded exclude byes and leg byes; wickets only those isBowlerWicket credits
+    void addBowlerBall(const Ball* ball) {
+        int conceded = ball->getTotalRuns();
+        if(ball->getOutcome() == BallOutcome::BYE || ball->getOutcome() == BallOutcome::LEG_BYE) {
+            conceded = 0;
+        }
+        runs += conceded;
+        if(ball->getIsValid()) {
+            balls++;
+            if(conceded == 0) dotBalls++;
+        }
+        if(isBowlerWicket(ball->getWicketType())) wickets++;
+        addBoundary(ball);
+    }
+
+    void add(const PhaseStats& other) {
+        runs += other.runs;
+        balls += other.balls;
+        wickets += other.wickets;
+        dotBalls += other.dotBalls;
+        fours += other.fours;
+        sixes += other.sixes;
+    }
+};
+
+// One player's counters split by phase
+struct PhaseLine {
+    PhaseStats phases[PHASE_COUNT];
+
+    PhaseStats total() const {
+        PhaseStats sum;
+        for(int i = 0; i < PHASE_COUNT; i++) sum.add(phases[i]);
+        return sum;
+    }
+};
 
 class Over {
 private:
@@ -29,6 +118,7 @@ public:
     }
     
     void addBall(Ball* ball) {
+        TRACE_SPAN("Over::addBall");
         balls.push_back(ball);
         runsInOver += ball->getTotalRuns();
         if(ball->getWicketType() != WicketType::NONE) {
@@ -95,18 +185,29 @@ private:
     int legByes;
     bool isCompleted;
     bool isAllOut;
+    bool isDeclared;
+    
+    // Phase boundaries by over number (1-based); 0 disables the phase
+    int powerplayOvers;
+    int deathStartOver;
+    PhaseStats phaseTotals[PHASE_COUNT];
+    // Per-player lines keyed by registry ID (unregistered players are not tracked)
+    unordered_map<PlayerId, PhaseLine> batterPhases;
+    unordered_map<PlayerId, PhaseLine> bowlerPhases;
     
 public:
     Innings() : inningsNumber(0), battingTeam(nullptr), bowlingTeam(nullptr),
                 currentBatsman1(nullptr), currentBatsman2(nullptr), striker1(true),
                 totalRuns(0), totalWickets(0), totalExtras(0), wides(0), noBalls(0),
-                byes(0), legByes(0), isCompleted(false), isAllOut(false) {}
+                byes(0), legByes(0), isCompleted(false), isAllOut(false), isDeclared(false),
+                powerplayOvers(0), deathStartOver(0) {}
     
     Innings(int num, Team* batTeam, Team* bowlTeam)
         : inningsNumber(num), battingTeam(batTeam), bowlingTeam(bowlTeam),
           currentBatsman1(nullptr), currentBatsman2(nullptr), striker1(true),
           totalRuns(0), totalWickets(0), totalExtras(0), wides(0), noBalls(0),
-          byes(0), legByes(0), isCompleted(false), isAllOut(false) {}
+          byes(0), legByes(0), isCompleted(false), isAllOut(false), isDeclared(false),
+          powerplayOvers(0), deathStartOver(0) {}
     
     ~Innings() {
         for(auto over : overs) {
@@ -121,6 +222,7 @@ public:
     }
     
     void recordBall(Ball* ball) {
+        TRACE_SPAN("Innings::recordBall");
         if(overs.empty()) return;
         
         Over* currentOver = overs.back();
@@ -143,6 +245,16 @@ public:
             totalExtras += ball->getRuns();
         }
         
+        // Phase counters for the team, the striker and the bowler
+        int phase = (int)getPhaseForOver(currentOver->getOverNumber());
+        phaseTotals[phase].addTeamBall(ball);
+        if(ball->getBatsmanId() != INVALID_PLAYER_ID) {
+            batterPhases[ball->getBatsmanId()].phases[phase].addBatterBall(ball);
+        }
+        if(ball->getBowlerId() != INVALID_PLAYER_ID) {
+            bowlerPhases[ball->getBowlerId()].phases[phase].addBowlerBall(ball);
+        }
+        
         if(ball->getWicketType() != WicketType::NONE) {
             totalWickets++;
             if(totalWickets >= 10) {
@@ -179,13 +291,48 @@ public:
     void displayInningsScore() const {
         cout << "\n===== Innings " << inningsNumber << " =====" << endl;
         cout << battingTeam->getTeamName() << ": " << totalRuns << "/" << totalWickets;
+        if(isDeclared) cout << " dec";
         cout << " (" << overs.size() << " overs)" << endl;
         cout << "Extras: " << totalExtras << " (wd " << wides << ", nb " << noBalls 
              << ", b " << byes << ", lb " << legByes << ")" << endl;
     }
     
+    void setPhaseBoundaries(int powerplay, int deathStart) {
+        powerplayOvers = powerplay;
+        deathStartOver = deathStart;
+    }
+    
+    InningsPhase getPhaseForOver(int overNumber) const {
+        if(powerplayOvers > 0 && overNumber <= powerplayOvers) return InningsPhase::POWERPLAY;
+        if(deathStartOver > 0 && overNumber >= deathStartOver) return InningsPhase::DEATH;
+        return InningsPhase::MIDDLE;
+    }
+    
+    static string getPhaseString(InningsPhase phase) {
+        switch(phase) {
+            case InningsPhase::POWERPLAY: return "Powerplay";
+            case InningsPhase::MIDDLE: return "Middle";
+            case InningsPhase::DEATH: return "Death";
+            default: return "Unknown";
+        }
+    }
+    
+    void displayPhaseBreakdown() const {
+        cout << "\nPhase Breakdown:" << endl;
+        for(int i = 0; i < PHASE_COUNT; i++) {
+            const PhaseStats& p = phaseTotals[i];
+            if(p.balls == 0 && p.runs == 0) continue;
+            cout << "  " << getPhaseString((InningsPhase)i) << ": " << p.runs << "/" << p.wickets
+                 << " off " << p.balls << " balls (dots " << p.dotBalls
+                 << ", 4s " << p.fours << ", 6s " << p.sixes << ")" << endl;
+        }
+    }
+    
     void displayFullInnings() const {
         displayInningsScore();
+        if(powerplayOvers > 0) {
+            displayPhaseBreakdown();
+        }
         cout << "\nOver by Over:" << endl;
         for(auto over : overs) {
             over->displayOver();
@@ -199,9 +346,31 @@ public:
     int getTotalRuns() const { return totalRuns; }
     int getTotalWickets() const { return totalWickets; }
     int getTotalExtras() const { return totalExtras; }
+    int getWides() const { return wides; }
+    int getNoBalls() const { return noBalls; }
+    int getByes() const { return byes; }
+    int getLegByes() const { return legByes; }
     const vector<Over*>& getOvers() const { return overs; }
     bool getIsCompleted() const { return isCompleted; }
     bool getIsAllOut() const { return isAllOut; }
+    bool getIsDeclared() const { return isDeclared; }
+    int getPowerplayOvers() const { return powerplayOvers; }
+    int getDeathStartOver() const { return deathStartOver; }
+    const PhaseStats& getPhaseTotals(InningsPhase phase) const { return phaseTotals[(int)phase]; }
+    const unordered_map<PlayerId, PhaseLine>& getBatterPhases() const { return batterPhases; }
+    const unordered_map<PlayerId, PhaseLine>& getBowlerPhases() const { return bowlerPhases; }
+    
+    // Empty line for players who have not batted or bowled yet
+    PhaseLine getBatterLine(PlayerId batter) const {
+        auto it = batterPhases.find(batter);
+        return it != batterPhases.end() ? it->second : PhaseLine();
+    }
+    
+    PhaseLine getBowlerLine(PlayerId bowler) const {
+        auto it = bowlerPhases.find(bowler);
+        return it != bowlerPhases.end() ? it->second : PhaseLine();
+    }
+    
     double getCurrentRunRate() const {
         if(overs.empty()) return 0.0;
         double oversPlayed = overs.size();
@@ -217,6 +386,7 @@ public:
     }
     
     void setCompleted(bool completed) { isCompleted = completed; }
+    void setDeclared(bool declared) { isDeclared = declared; }
 };
 
 #endif
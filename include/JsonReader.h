@@ -0,0 +1,276 @@
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+// A run of characters inside the document being read (not null-terminated)
+struct JsonSlice {
+    const char* data;
+    size_t length;
+
+    JsonSlice() : data(""), length(0) {}
+    JsonSlice(const char* d, size_t n) : data(d), length(n) {}
+
+    bool operator==(const char* text) const {
+        return strncmp(data, text, length) == 0 && text[length] == '\0';
+    }
+    bool operator!=(const char* text) const { return !(*this == text); }
+
+    bool operator==(const JsonSlice& other) const {
+        return length == other.length && memcmp(data, other.data, length) == 0;
+    }
+
+    bool empty() const { return length == 0; }
+    string str() const { return string(data, length); }
+};
+
+struct JsonSliceHash {
+    size_t operator()(const JsonSlice& s) const {
+        // FNV-1a
+        uint64_t h = 1469598103934665603ULL;
+        for(size_t i = 0; i < s.length; i++) {
+            h ^= (unsigned char)s.data[i];
+            h *= 1099511628211ULL;
+        }
+        return (size_t)h;
+    }
+};
+
+// Pull parser over a mutable JSON buffer.
+// Strings are returned as slices into the buffer and unescaped in place, so
+// reading a document allocates nothing. Objects and arrays are walked with
+// nextKey()/nextElement() loops; anything the caller does not want is
+// passed over with skipValue(). Any syntax error makes every later call
+// return false, so loops unwind on their own and failed() reports it.
+//
+//   reader.beginObject();
+//   JsonSlice key;
+//   while(reader.nextKey(key)) {
+//       if(key == "name") reader.readString(name);
+//       else reader.skipValue();
+//   }
+class JsonReader {
+private:
+    char* p;
+    char* end;
+    bool error;
+
+    void skipWhitespace() {
+        while(p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+    }
+
+    bool fail() {
+        error = true;
+        p = end;
+        return false;
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if(p >= end || *p != c) return fail();
+        p++;
+        return true;
+    }
+
+    static int hexValue(char c) {
+        if(c >= '0' && c <= '9') return c - '0';
+        if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    bool readHex4(const char* at, uint32_t& out) const {
+        if(end - at < 4) return false;
+        out = 0;
+        for(int i = 0; i < 4; i++) {
+            int v = hexValue(at[i]);
+            if(v < 0) return false;
+            out = (out << 4) | (uint32_t)v;
+        }
+        return true;
+    }
+
+    static char* putUtf8(char* out, uint32_t cp) {
+        if(cp < 0x80) {
+            *out++ = (char)cp;
+        } else if(cp < 0x800) {
+            *out++ = (char)(0xC0 | (cp >> 6));
+            *out++ = (char)(0x80 | (cp & 0x3F));
+        } else if(cp < 0x10000) {
+            *out++ = (char)(0xE0 | (cp >> 12));
+            *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = (char)(0x80 | (cp & 0x3F));
+        } else {
+            *out++ = (char)(0xF0 | (cp >> 18));
+            *out++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+            *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = (char)(0x80 | (cp & 0x3F));
+        }
+        return out;
+    }
+
+    // Unescape the rest of a string that contains a backslash. The output
+    // is never longer than the input, so it is written over it.
+    bool unescapeInPlace(char* start, JsonSlice& out) {
+        char* w = p;
+        while(p < end && *p != '"') {
+            if(*p != '\\') {
+                *w++ = *p++;
+                continue;
+            }
+            if(end - p < 2) return fail();
+            char c = p[1];
+            p += 2;
+            switch(c) {
+                case '"': *w++ = '"'; break;
+                case '\\': *w++ = '\\'; break;
+                case '/': *w++ = '/'; break;
+                case 'b': *w++ = '\b'; break;
+                case 'f': *w++ = '\f'; break;
+                case 'n': *w++ = '\n'; break;
+                case 'r': *w++ = '\r'; break;
+                case 't': *w++ = '\t'; break;
+                case 'u': {
+                    uint32_t cp;
+                    if(!readHex4(p, cp)) return fail();
+                    p += 4;
+                    // Join a surrogate pair into one code point
+                    uint32_t low;
+                    if(cp >= 0xD800 && cp < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                       readHex4(p + 2, low) && low >= 0xDC00 && low < 0xE000) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    }
+                    w = putUtf8(w, cp);
+                    break;
+                }
+                default:
+                    return fail();
+            }
+        }
+        if(p >= end) return fail();
+        p++; // Closing quote
+        out = JsonSlice(start, (size_t)(w - start));
+        return true;
+    }
+
+public:
+    JsonReader(char* data, size_t size) : p(data), end(data + size), error(false) {}
+
+    bool failed() const { return error; }
+
+    // Whether the document ended cleanly after the top-level value
+    bool atEnd() {
+        skipWhitespace();
+        return !error && p == end;
+    }
+
+    bool beginObject() { return !error && consume('{'); }
+    bool beginArray() { return !error && consume('['); }
+
+    // Next member name of the current object; false at '}' or on error
+    bool nextKey(JsonSlice& key) {
+        if(error) return false;
+        skipWhitespace();
+        if(p < end && *p == '}') {
+            p++;
+            return false;
+        }
+        if(p < end && *p == ',') {
+            p++;
+            skipWhitespace();
+        }
+        if(!readString(key)) return false;
+        return consume(':');
+    }
+
+    // Position on the next element of the current array; false at ']' or on error
+    bool nextElement() {
+        if(error) return false;
+        skipWhitespace();
+        if(p < end && *p == ']') {
+            p++;
+            return false;
+        }
+        if(p < end && *p == ',') p++;
+        skipWhitespace();
+        if(p >= end) return fail();
+        return true;
+    }
+
+    bool readString(JsonSlice& out) {
+        if(error || !consume('"')) return false;
+        char* start = p;
+        while(p < end && *p != '"' && *p != '\\') p++;
+        if(p >= end) return fail();
+        if(*p == '"') {
+            out = JsonSlice(start, (size_t)(p - start));
+            p++;
+            return true;
+        }
+        return unescapeInPlace(start, out);
+    }
+
+    bool readInt(int64_t& out) {
+        if(error) return false;
+        skipWhitespace();
+        bool negative = false;
+        if(p < end && *p == '-') {
+            negative = true;
+            p++;
+        }
+        if(p >= end || *p < '0' || *p > '9') return fail();
+        int64_t value = 0;
+        while(p < end && *p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+        // Integers written with a fraction or exponent are truncated
+        while(p < end && (*p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-' ||
+                          (*p >= '0' && *p <= '9'))) p++;
+        out = negative ? -value : value;
+        return true;
+    }
+
+    bool readBool(bool& out) {
+        if(error) return false;
+        skipWhitespace();
+        if(end - p >= 4 && memcmp(p, "true", 4) == 0) { p += 4; out = true; return true; }
+        if(end - p >= 5 && memcmp(p, "false", 5) == 0) { p += 5; out = false; return true; }
+        return fail();
+    }
+
+    // Type of the next value: one of { [ " n t f or a digit/minus for numbers
+    char peek() {
+        skipWhitespace();
+        return p < end ? *p : '\0';
+    }
+
+    bool skipValue() {
+        if(error) return false;
+        char c = peek();
+        if(c == '{') {
+            p++;
+            JsonSlice key;
+            while(nextKey(key)) skipValue();
+        } else if(c == '[') {
+            p++;
+            while(nextElement()) skipValue();
+        } else if(c == '"') {
+            p++;
+            while(p < end && *p != '"') p += (*p == '\\') ? 2 : 1;
+            if(p >= end) return fail();
+            p++;
+        } else if(c == 't' || c == 'f' || c == 'n' || c == '-' || (c >= '0' && c <= '9')) {
+            while(p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' &&
+                  *p != '\n' && *p != '\r' && *p != '\t') p++;
+        } else {
+            return fail();
+        }
+        return !error;
+    }
+};
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+using namespace std;
+
+// Appends JSON text to a caller-provided buffer without allocating.
+// Writes that do not fit set overflowed() and are dropped, along with
+// everything after them, so callers check once at the end and retry with
+// a larger buffer. Commas between members are the caller's job: the
+// literal keys carry them (e.g. lit(",\"runs\":")).
+class JsonWriter {
+private:
+    char* start;
+    char* p;
+    char* end;
+    bool overflow;
+
+    bool reserve(size_t n) {
+        if(overflow || (size_t)(end - p) < n) {
+            overflow = true;
+            return false;
+        }
+        return true;
+    }
+
+    static bool needsEscape(unsigned char c) {
+        return c < 0x20 || c == '"' || c == '\\';
+    }
+
+public:
+    JsonWriter(char* buffer, size_t capacity)
+        : start(buffer), p(buffer), end(buffer + capacity), overflow(false) {}
+
+    void raw(const char* text, size_t length) {
+        if(!reserve(length)) return;
+        memcpy(p, text, length);
+        p += length;
+    }
+
+    // String literal known at compile time
+    template<size_t N>
+    void lit(const char (&text)[N]) {
+        // Constant length, so the copy is inlined
+        if(!reserve(N - 1)) return;
+        memcpy(p, text, N - 1);
+        p += N - 1;
+    }
+
+    void ch(char c) {
+        if(!reserve(1)) return;
+        *p++ = c;
+    }
+
+    // Quoted and escaped string value
+    void str(const char* text, size_t length) {
+        // Most names need no escaping and are copied whole
+        size_t clean = 0;
+        while(clean < length && !needsEscape((unsigned char)text[clean])) clean++;
+        if(clean == length) {
+            if(!reserve(length + 2)) return;
+            *p = '"';
+            memcpy(p + 1, text, length);
+            p[length + 1] = '"';
+            p += length + 2;
+            return;
+        }
+
+        // Worst case every byte becomes \u00XX
+        if(!reserve(length * 6 + 2)) return;
+        *p++ = '"';
+        for(size_t i = 0; i < length; i++) {
+            unsigned char c = (unsigned char)text[i];
+            if(!needsEscape(c)) {
+                *p++ = (char)c;
+            } else if(c == '"' || c == '\\') {
+                *p++ = '\\';
+                *p++ = (char)c;
+            } else if(c == '\n') {
+                *p++ = '\\';
+                *p++ = 'n';
+            } else {
+                static const char hex[] = "0123456789abcdef";
+                memcpy(p, "\\u00", 4);
+                p[4] = hex[c >> 4];
+                p[5] = hex[c & 15];
+                p += 6;
+            }
+        }
+        *p++ = '"';
+    }
+
+    void str(const string& text) {
+        str(text.data(), text.size());
+    }
+
+    void integer(int64_t value) {
+        if(!reserve(20)) return;
+        // Scorecard numbers are nearly always below 100
+        if(value >= 0 && value < 100) {
+            if(value < 10) {
+                *p++ = (char)('0' + value);
+            } else {
+                p[0] = (char)('0' + value / 10);
+                p[1] = (char)('0' + value % 10);
+                p += 2;
+            }
+            return;
+        }
+        uint64_t v = value < 0 ? (uint64_t)(-(value + 1)) + 1 : (uint64_t)value;
+        if(value < 0) *p++ = '-';
+        char digits[20];
+        int n = 0;
+        do {
+            digits[n++] = (char)('0' + v % 10);
+            v /= 10;
+        } while(v);
+        while(n) *p++ = digits[--n];
+    }
+
+    // Fixed two decimal places (run rates, averages)
+    void decimal2(double value) {
+        int64_t hundredths = (int64_t)(value * 100.0 + (value < 0 ? -0.5 : 0.5));
+        if(hundredths < 0) {
+            ch('-');
+            hundredths = -hundredths;
+        }
+        integer(hundredths / 100);
+        if(!reserve(3)) return;
+        *p++ = '.';
+        *p++ = (char)('0' + (hundredths / 10) % 10);
+        *p++ = (char)('0' + hundredths % 10);
+    }
+
+    void boolean(bool value) {
+        if(value) lit("true");
+        else lit("false");
+    }
+
+    void null() { lit("null"); }
+
+    bool overflowed() const { return overflow; }
+    size_t size() const { return (size_t)(p - start); }
+
+    void reset() {
+        p = start;
+        overflow = false;
+    }
+};
+
+#endif
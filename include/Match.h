@@ -5,6 +5,7 @@
 #include "Team.h"
 #include "Venue.h"
 #include "Officials.h"
+#include "SessionTracker.h"
 #include <vector>
 #include <ctime>
 
@@ -28,6 +29,15 @@ enum class MatchStatus {
     DRAWN
 };
 
+class Match;
+
+// Notified after every delivery a match records
+class DeliveryListener {
+public:
+    virtual ~DeliveryListener() {}
+    virtual void onDelivery(const Match& match, const Innings& innings, const Ball& ball) = 0;
+};
+
 // Base Match class (Abstract)
 class Match {
 protected:
@@ -48,6 +58,7 @@ protected:
     Team* winner;
     int maxOversPerInnings;
     int maxInnings;
+    vector<DeliveryListener*> deliveryListeners;
     
 public:
     Match() : matchId(""), matchType(MatchType::ODI), status(MatchStatus::NOT_STARTED),
@@ -72,6 +83,15 @@ public:
     virtual bool checkInningsComplete(Innings* innings) const = 0;
     virtual void applyMatchRules() = 0;
     
+    // Hook for formats that track state per delivery
+    virtual void onBallRecorded(const Ball*) {}
+    
+    // Side to bat in the next innings: team1 first, then the sides alternate
+    virtual Team* getNextBattingTeam() const {
+        if(allInnings.empty()) return team1;
+        return allInnings.back()->getBowlingTeam();
+    }
+    
     void setToss(string winnerTeam, string decision) {
         tossWinner = winnerTeam;
         tossDecision = decision;
@@ -94,9 +114,18 @@ public:
         Innings* newInnings = new Innings(inningsNum, batTeam, bowlTeam);
         allInnings.push_back(newInnings);
         status = MatchStatus::IN_PROGRESS;
+        applyMatchRules();
         return newInnings;
     }
     
+    // Record a delivery in the current innings
+    void recordBall(Ball* ball) {
+        if(allInnings.empty()) return;
+        allInnings.back()->recordBall(ball);
+        onBallRecorded(ball);
+        for(auto listener : deliveryListeners) listener->onDelivery(*this, *allInnings.back(), *ball);
+    }
+    
     void displayMatchSummary() const {
         cout << "\n========================================" << endl;
         cout << "       MATCH SUMMARY" << endl;
@@ -151,20 +180,42 @@ public:
     }
     
     // Getters
-    string getMatchId() const { return matchId; }
+    const string& getMatchId() const { return matchId; }
     MatchType getMatchType() const { return matchType; }
     MatchStatus getStatus() const { return status; }
     Team* getTeam1() const { return team1; }
     Team* getTeam2() const { return team2; }
     Venue* getVenue() const { return venue; }
     const vector<Innings*>& getAllInnings() const { return allInnings; }
+    const vector<Umpire*>& getUmpires() const { return umpires; }
+    const vector<Commentator*>& getCommentators() const { return commentators; }
+    const vector<BroadcastAgency*>& getBroadcasters() const { return broadcasters; }
+    string getTossWinner() const { return tossWinner; }
+    string getTossDecision() const { return tossDecision; }
+    const string& getResult() const { return result; }
     Team* getWinner() const { return winner; }
     int getMaxOversPerInnings() const { return maxOversPerInnings; }
+    int getMaxInnings() const { return maxInnings; }
+    time_t getMatchDate() const { return matchDate; }
     
     // Setters
     void setStatus(MatchStatus s) { status = s; }
     void setResult(string res) { result = res; }
     void setWinner(Team* w) { winner = w; }
+    void setMatchDate(time_t date) { matchDate = date; }
+    
+    void addDeliveryListener(DeliveryListener* listener) {
+        deliveryListeners.push_back(listener);
+    }
+    
+    void removeDeliveryListener(DeliveryListener* listener) {
+        for(size_t i = 0; i < deliveryListeners.size(); i++) {
+            if(deliveryListeners[i] == listener) {
+                deliveryListeners.erase(deliveryListeners.begin() + i);
+                return;
+            }
+        }
+    }
 };
 
 // ODI Match class
@@ -190,6 +241,7 @@ public:
         cout << team1->getTeamName() << " vs " << team2->getTeamName() << endl;
         cout << "Venue: " << venue->getStadiumName() << endl;
         cout << "Max Overs: " << maxOversPerInnings << " per innings" << endl;
+        cout << "Powerplay: Overs 1-" << powerplayOvers << endl;
     }
     
     bool checkInningsComplete(Innings* innings) const override {
@@ -201,10 +253,13 @@ public:
         return false;
     }
     
+    // Called for each new innings: powerplay is overs 1-10, death overs 41-50
     void applyMatchRules() override {
-        // ODI specific rules
-        // Powerplay restrictions, fielding restrictions, etc.
+        if(allInnings.empty()) return;
+        allInnings.back()->setPhaseBoundaries(powerplayOvers, maxOversPerInnings - 9);
     }
+    
+    int getPowerplayOvers() const { return powerplayOvers; }
 };
 
 // T20 Match class
@@ -231,6 +286,8 @@ public:
         cout << team1->getTeamName() << " vs " << team2->getTeamName() << endl;
         cout << "Venue: " << venue->getStadiumName() << endl;
         cout << "Max Overs: " << maxOversPerInnings << " per innings" << endl;
+        cout << "Powerplay: Overs 1-" << powerplayOvers
+             << " | Strategic Timeouts: " << strategicTimeout << endl;
     }
     
     bool checkInningsComplete(Innings* innings) const override {
@@ -242,9 +299,14 @@ public:
         return false;
     }
     
+    // Called for each new innings: powerplay is overs 1-6, death overs 16-20
     void applyMatchRules() override {
-        // T20 specific rules
+        if(allInnings.empty()) return;
+        allInnings.back()->setPhaseBoundaries(powerplayOvers, maxOversPerInnings - 4);
     }
+    
+    int getPowerplayOvers() const { return powerplayOvers; }
+    int getStrategicTimeouts() const { return strategicTimeout; }
 };
 
 // Test Match class
@@ -253,9 +315,12 @@ private:
     int maxDays;
     int currentDay;
     int minOversPerDay;
+    SessionTracker sessions;
+    bool followOnEnforced;
     
 public:
-    TestMatch() : Match(), maxDays(5), currentDay(1), minOversPerDay(90) {
+    TestMatch() : Match(), maxDays(5), currentDay(1), minOversPerDay(90),
+                  sessions(0, 5, 90), followOnEnforced(false) {
         matchType = MatchType::TEST_MATCH;
         maxOversPerInnings = 999; // Unlimited overs
         maxInnings = 4; // Each team plays 2 innings
@@ -263,7 +328,8 @@ public:
     
     TestMatch(string id, Team* t1, Team* t2, Venue* v)
         : Match(id, MatchType::TEST_MATCH, t1, t2, v), 
-          maxDays(5), currentDay(1), minOversPerDay(90) {
+          maxDays(5), currentDay(1), minOversPerDay(90),
+          sessions(0, 5, 90), followOnEnforced(false) {
         maxOversPerInnings = 999;
         maxInnings = 4;
     }
@@ -273,7 +339,13 @@ public:
         cout << team1->getTeamName() << " vs " << team2->getTeamName() << endl;
         cout << "Venue: " << venue->getStadiumName() << endl;
         cout << "Format: " << maxDays << " Day Test" << endl;
-        cout << "Current Day: " << currentDay << endl;
+        cout << "Current Day: " << currentDay << ", Session " << sessions.getCurrentSession() << endl;
+        if(followOnEnforced) cout << "Follow-on enforced" << endl;
+    }
+    
+    void onBallRecorded(const Ball* ball) override {
+        sessions.addBall(ball);
+        currentDay = sessions.getCurrentDay();
     }
     
     bool checkInningsComplete(Innings* innings) const override {
@@ -284,14 +356,70 @@ public:
     }
     
     void applyMatchRules() override {
-        // Test match specific rules
-        // Follow-on, declaration, etc.
+        // A side batting in the third innings straight after its first is
+        // following on, however the innings was started
+        if(allInnings.size() == 3 &&
+           allInnings[2]->getBattingTeam() == allInnings[1]->getBattingTeam()) {
+            followOnEnforced = true;
+        }
+    }
+    
+    // The side following on bats again straight away
+    Team* getNextBattingTeam() const override {
+        if(followOnEnforced && allInnings.size() == 2) return allInnings[1]->getBattingTeam();
+        return Match::getNextBattingTeam();
     }
     
     void declareInnings(Innings* innings) {
         innings->setCompleted(true);
+        innings->setDeclared(true);
         status = MatchStatus::INNINGS_BREAK;
     }
+    
+    // Minimum first-innings lead to enforce the follow-on (Law 14)
+    int getFollowOnMargin() const {
+        if(maxDays >= 5) return 200;
+        if(maxDays >= 3) return 150;
+        if(maxDays == 2) return 100;
+        return 75;
+    }
+    
+    // After two completed innings, can the side batting first make the other follow on?
+    bool isFollowOnAvailable() const {
+        if(allInnings.size() != 2 || !allInnings[1]->getIsCompleted()) return false;
+        int lead = allInnings[0]->getTotalRuns() - allInnings[1]->getTotalRuns();
+        return lead >= getFollowOnMargin();
+    }
+    
+    // Make the side batting second follow on; getNextBattingTeam then
+    // returns it for the third innings
+    bool enforceFollowOn() {
+        if(!isFollowOnAvailable()) return false;
+        followOnEnforced = true;
+        return true;
+    }
+    
+    void displaySessionSummary() const {
+        cout << "\n===== Day and Session Summary =====" << endl;
+        for(int d = 1; d <= currentDay; d++) {
+            sessions.displayDaySummary(d);
+        }
+        int deficit = sessions.getTotalOverRateDeficit();
+        if(deficit > 0) {
+            cout << "\nOver-rate deficit: " << deficit << " overs" << endl;
+        }
+    }
+    
+    // Getters
+    int getMaxDays() const { return maxDays; }
+    int getCurrentDay() const { return currentDay; }
+    int getMinOversPerDay() const { return minOversPerDay; }
+    bool getFollowOnEnforced() const { return followOnEnforced; }
+    const SessionTracker& getSessionTracker() const { return sessions; }
+    
+    // Start of play on day 1; sessions are placed relative to it.
+    // Unset, play starts at the first recorded ball.
+    void setPlayStart(time_t start) { sessions.setPlayStart(start); }
 };
 
 // First Class Match
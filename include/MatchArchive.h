@@ -0,0 +1,460 @@
+#ifndef MATCHARCHIVE_H
+#define MATCHARCHIVE_H
+
+#include "MatchSnapshot.h"
+#include "DeliveryCodec.h"
+#include "PlayerRegistry.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+// One fixed-width catalog row per archived match
+struct CatalogRecord {
+    uint32_t matchNo;
+    uint32_t matchType;      // MatchType
+    int64_t matchDate;
+    uint32_t team1;          // Name key
+    uint32_t team2;          // Name key
+    uint32_t venue;          // Name key
+    uint32_t status;         // MatchStatus
+    uint64_t snapshotOffset; // Position of the snapshot in matches.dat
+    uint64_t snapshotSize;
+    uint64_t playerOffset;   // First PlayerId in players.dat
+    uint32_t playerCount;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(CatalogRecord) == 64, "catalog record layout changed");
+
+const int MATCH_TYPE_COUNT = 6;
+const uint32_t INVALID_MATCH_NO = 0xFFFFFFFF;
+
+// On-disk archive of completed matches with secondary indexes.
+//
+// Files in the archive directory:
+//   matches.dat  - snapshots appended back to back (8-byte aligned), with
+//                  deliveries packed after setPackDeliveries(true)
+//   catalog.dat  - CatalogRecord per match, indexed by match number
+//   names.dat    - team and venue names, one per line, key = line number
+//   people.dat   - the archive's players, "personId<TAB>nationality<TAB>name"
+//                  per line, PlayerId = line number
+//   players.dat  - PlayerIds of everyone in each match's squads
+//
+// PlayerIds are the archive's own: open() loads people.dat into a
+// PlayerRegistry, and matches must be built from that registry's players
+// (MatchImporter and simulations take it by reference). New players are
+// appended to people.dat as their matches are added.
+//
+// The catalog record is written last, after the snapshot, names, people
+// and player list are on disk; a failed write cuts the files back, so a
+// record never points at missing bytes.
+//
+// Indexes are sorted posting lists of match numbers (team, venue, player),
+// one bitmap per MatchType and a date-sorted list. Match numbers are
+// assigned in insertion order, so postings stay sorted by appending.
+// Queries intersect the shortest lists first and only ever touch matches
+// that satisfy every filter.
+class MatchArchive {
+private:
+    string directory;
+    unique_ptr<PlayerRegistry> ownRegistry; // When open() is given none
+    PlayerRegistry* registry;
+    uint32_t persistedPlayers; // Registry entries already in people.dat
+    vector<CatalogRecord> catalog;
+    vector<string> names;
+    unordered_map<string, uint32_t> nameKeys;
+    vector<vector<uint32_t>> teamPostings;   // Name key -> match numbers
+    vector<vector<uint32_t>> venuePostings;  // Name key -> match numbers
+    vector<vector<uint32_t>> playerPostings; // PlayerId -> match numbers
+    vector<uint64_t> typeBitmaps[MATCH_TYPE_COUNT];
+    mutable vector<pair<int64_t, uint32_t>> dateIndex; // Sorted lazily by date
+    mutable bool dateIndexSorted;
+    uint64_t matchesSize;   // Bytes in matches.dat
+    uint64_t playerEntries; // PlayerIds in players.dat
+    uint64_t namesSize;     // Bytes in names.dat
+    uint64_t peopleSize;    // Bytes in people.dat
+    bool packDeliveries;    // Store overs and balls with DeliveryCodec
+
+    string pathOf(const string& file) const {
+        return directory + "/" + file;
+    }
+
+    static void makeDirectory(const string& path) {
+#ifdef _WIN32
+        _mkdir(path.c_str());
+#else
+        mkdir(path.c_str(), 0755);
+#endif
+    }
+
+    static uint64_t fileSize(const string& path) {
+        ifstream file(path.c_str(), ios::binary | ios::ate);
+        return file ? (uint64_t)file.tellg() : 0;
+    }
+
+    // Cut a file back to size bytes, dropping a partial append
+    bool cutBack(const string& file, uint64_t size) const {
+#ifndef _WIN32
+        return truncate(pathOf(file).c_str(), (off_t)size) == 0;
+#else
+        return false;
+#endif
+    }
+
+    // Append n bytes to a file holding size bytes; false (with the file cut
+    // back to size) unless every byte was written
+    bool appendBytes(const string& file, uint64_t size, const char* data, size_t n) const {
+        if(n == 0) return true;
+        ofstream out(pathOf(file).c_str(), ios::binary | ios::app);
+        out.write(data, n);
+        out.flush();
+        if(out.good()) return true;
+        out.close();
+        cutBack(file, size);
+        return false;
+    }
+
+    uint32_t internName(const string& name) {
+        auto it = nameKeys.find(name);
+        if(it != nameKeys.end()) return it->second;
+        uint32_t key = (uint32_t)names.size();
+        names.push_back(name);
+        nameKeys[name] = key;
+        return key;
+    }
+
+    // Forget names interned after the first count, when they failed to persist
+    void dropNames(size_t count) {
+        while(names.size() > count) {
+            nameKeys.erase(names.back());
+            names.pop_back();
+        }
+    }
+
+    static void addPosting(vector<vector<uint32_t>>& postings, uint32_t key, uint32_t matchNo) {
+        if(key >= postings.size()) postings.resize(key + 1);
+        vector<uint32_t>& list = postings[key];
+        if(list.empty() || list.back() != matchNo) list.push_back(matchNo);
+    }
+
+    void indexMatch(const CatalogRecord& record, const vector<PlayerId>& players) {
+        uint32_t n = record.matchNo;
+        addPosting(teamPostings, record.team1, n);
+        addPosting(teamPostings, record.team2, n);
+        addPosting(venuePostings, record.venue, n);
+        for(auto id : players) {
+            if(id != INVALID_PLAYER_ID) addPosting(playerPostings, id, n);
+        }
+
+        if(record.matchType < MATCH_TYPE_COUNT) {
+            vector<uint64_t>& bitmap = typeBitmaps[record.matchType];
+            if(bitmap.size() <= n / 64) bitmap.resize(n / 64 + 1, 0);
+            bitmap[n / 64] |= (uint64_t)1 << (n % 64);
+        }
+
+        if(!dateIndex.empty() && dateIndex.back().first > record.matchDate) {
+            dateIndexSorted = false;
+        }
+        dateIndex.push_back(make_pair(record.matchDate, n));
+    }
+
+    static vector<uint32_t> intersect(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        vector<uint32_t> out;
+        size_t i = 0, j = 0;
+        while(i < a.size() && j < b.size()) {
+            if(a[i] < b[j]) i++;
+            else if(b[j] < a[i]) j++;
+            else {
+                out.push_back(a[i]);
+                i++;
+                j++;
+            }
+        }
+        return out;
+    }
+
+public:
+    MatchArchive()
+        : registry(nullptr), persistedPlayers(0), dateIndexSorted(true), matchesSize(0),
+          playerEntries(0), namesSize(0), peopleSize(0), packDeliveries(false) {}
+
+    MatchArchive(const MatchArchive&) = delete;
+    MatchArchive& operator=(const MatchArchive&) = delete;
+
+    // Open (creating if needed) the archive in dir and rebuild the in-memory
+    // indexes. The archive's players are loaded into playerRegistry, which must
+    // give them the PlayerIds they were stored with: an empty registry, or
+    // the one the archive was built from. Without one the archive keeps its own.
+    bool open(const string& dir, PlayerRegistry* playerRegistry = nullptr) {
+        directory = dir;
+        makeDirectory(directory);
+        catalog.clear(); names.clear(); nameKeys.clear();
+        teamPostings.clear(); venuePostings.clear(); playerPostings.clear();
+        for(int t = 0; t < MATCH_TYPE_COUNT; t++) typeBitmaps[t].clear();
+        dateIndex.clear();
+        dateIndexSorted = true;
+
+        if(playerRegistry) {
+            ownRegistry.reset();
+            registry = playerRegistry;
+        } else {
+            ownRegistry.reset(new PlayerRegistry());
+            registry = ownRegistry.get();
+        }
+
+        ifstream nameFile(pathOf("names.dat").c_str());
+        string line;
+        while(getline(nameFile, line)) internName(line);
+        namesSize = fileSize(pathOf("names.dat"));
+
+        ifstream peopleFile(pathOf("people.dat").c_str());
+        persistedPlayers = 0;
+        while(getline(peopleFile, line)) {
+            size_t tab1 = line.find('\t');
+            size_t tab2 = tab1 == string::npos ? string::npos : line.find('\t', tab1 + 1);
+            if(tab2 == string::npos) return false;
+            Player* player = registry->createPlayer(line.substr(tab2 + 1), 0, line.substr(tab1 + 1, tab2 - tab1 - 1),
+                                                    line.substr(0, tab1), 0);
+            if(player->getRegistryId() != persistedPlayers) return false; // Registry numbers players differently
+            persistedPlayers++;
+        }
+        peopleSize = fileSize(pathOf("people.dat"));
+
+        ifstream catalogFile(pathOf("catalog.dat").c_str(), ios::binary);
+        ifstream playerFile(pathOf("players.dat").c_str(), ios::binary);
+        CatalogRecord record;
+        vector<PlayerId> players;
+        while(catalogFile.read((char*)&record, sizeof(record))) {
+            players.resize(record.playerCount);
+            playerFile.seekg((streamoff)(record.playerOffset * sizeof(PlayerId)));
+            if(record.playerCount > 0 && !playerFile.read((char*)players.data(), players.size() * sizeof(PlayerId))) {
+                return false;
+            }
+            catalog.push_back(record);
+            indexMatch(record, players);
+        }
+
+        // Anything past the last catalog record is a write that never completed
+        matchesSize = catalog.empty() ? 0 : catalog.back().snapshotOffset + catalog.back().snapshotSize;
+        playerEntries = catalog.empty() ? 0 : catalog.back().playerOffset + catalog.back().playerCount;
+        if(fileSize(pathOf("catalog.dat")) > catalog.size() * sizeof(CatalogRecord)) {
+            cutBack("catalog.dat", catalog.size() * sizeof(CatalogRecord));
+        }
+        if(fileSize(pathOf("matches.dat")) > matchesSize) cutBack("matches.dat", matchesSize);
+        if(fileSize(pathOf("players.dat")) > playerEntries * sizeof(PlayerId)) {
+            cutBack("players.dat", playerEntries * sizeof(PlayerId));
+        }
+        return true;
+    }
+
+    // Append a completed match. Returns its match number, or
+    // INVALID_MATCH_NO if a player is not from the archive's registry or a
+    // write failed (the archive is then unchanged on disk).
+    uint32_t addMatch(const Match& match) {
+        vector<PlayerId> players;
+        for(auto team : {match.getTeam1(), match.getTeam2()}) {
+            for(auto player : team->getSquad()) {
+                const Player* known = registry->getPlayer(player->getRegistryId());
+                if(!known || known->getId() != player->getId()) return INVALID_MATCH_NO;
+                players.push_back(player->getRegistryId());
+            }
+        }
+
+        vector<char> buffer;
+        MatchSnapshotWriter writer;
+        writer.write(match, buffer);
+        if(packDeliveries) {
+            MatchSnapshot full;
+            vector<char> packed;
+            if(full.load(buffer.data(), buffer.size()) && DeliveryCodec::pack(full, packed)) {
+                buffer.swap(packed);
+            }
+        }
+
+        CatalogRecord record;
+        memset(&record, 0, sizeof(record));
+        record.matchNo = (uint32_t)catalog.size();
+        record.matchType = (uint32_t)match.getMatchType();
+        record.matchDate = (int64_t)match.getMatchDate();
+        size_t knownNames = names.size();
+        record.team1 = internName(match.getTeam1()->getTeamName());
+        record.team2 = internName(match.getTeam2()->getTeamName());
+        record.venue = internName(match.getVenue() ? match.getVenue()->getStadiumName() : "");
+        record.status = (uint32_t)match.getStatus();
+        record.snapshotOffset = matchesSize;
+        record.snapshotSize = buffer.size();
+        record.playerOffset = playerEntries;
+        record.playerCount = (uint32_t)players.size();
+
+        // New names and players first: on their own they are harmless
+        string text;
+        for(size_t k = knownNames; k < names.size(); k++) text += names[k] + "\n";
+        if(!appendBytes("names.dat", namesSize, text.data(), text.size())) {
+            dropNames(knownNames);
+            return INVALID_MATCH_NO;
+        }
+        namesSize += text.size();
+
+        text.clear();
+        for(size_t id = persistedPlayers; id < registry->size(); id++) {
+            const Player* player = registry->getPlayer((PlayerId)id);
+            text += player->getId() + "\t" + player->getNationality() + "\t" + player->getName() + "\n";
+        }
+        if(!appendBytes("people.dat", peopleSize, text.data(), text.size())) return INVALID_MATCH_NO;
+        peopleSize += text.size();
+        persistedPlayers = (uint32_t)registry->size();
+
+        // Then the match, and the catalog record that makes it visible
+        uint64_t playersSize = playerEntries * sizeof(PlayerId);
+        if(!appendBytes("matches.dat", matchesSize, buffer.data(), buffer.size())) return INVALID_MATCH_NO;
+        if(!appendBytes("players.dat", playersSize, (const char*)players.data(), players.size() * sizeof(PlayerId))) {
+            cutBack("matches.dat", matchesSize);
+            return INVALID_MATCH_NO;
+        }
+        if(!appendBytes("catalog.dat", catalog.size() * sizeof(CatalogRecord), (const char*)&record, sizeof(record))) {
+            cutBack("matches.dat", matchesSize);
+            cutBack("players.dat", playersSize);
+            return INVALID_MATCH_NO;
+        }
+        matchesSize += buffer.size(); // Snapshot sizes are multiples of 8
+        playerEntries += players.size();
+
+        catalog.push_back(record);
+        indexMatch(record, players);
+        return record.matchNo;
+    }
+
+    // Map one archived match for in-place reading
+    bool openSnapshot(uint32_t matchNo, MatchSnapshot& snapshot) const {
+        if(matchNo >= catalog.size()) return false;
+        const CatalogRecord& record = catalog[matchNo];
+        return snapshot.openRange(pathOf("matches.dat"), record.snapshotOffset, record.snapshotSize);
+    }
+
+    // Query builder: every filter set must match
+    class Query {
+    private:
+        const MatchArchive* archive;
+        vector<const vector<uint32_t>*> postings;
+        bool impossible;
+        int matchType;
+        int64_t dateFrom;
+        int64_t dateTo;
+
+        static const vector<uint32_t>* lookup(const vector<vector<uint32_t>>& lists, uint32_t key) {
+            return key < lists.size() ? &lists[key] : nullptr;
+        }
+
+        void addNamed(const vector<vector<uint32_t>>& lists, const string& name) {
+            auto it = archive->nameKeys.find(name);
+            const vector<uint32_t>* list = it != archive->nameKeys.end() ? lookup(lists, it->second) : nullptr;
+            if(list) postings.push_back(list);
+            else impossible = true;
+        }
+
+        bool passes(uint32_t n) const {
+            if(matchType >= 0) {
+                const vector<uint64_t>& bitmap = archive->typeBitmaps[matchType];
+                if(n / 64 >= bitmap.size() || !(bitmap[n / 64] >> (n % 64) & 1)) return false;
+            }
+            int64_t date = archive->catalog[n].matchDate;
+            return date >= dateFrom && date <= dateTo;
+        }
+
+    public:
+        Query(const MatchArchive* a)
+            : archive(a), impossible(false), matchType(-1),
+              dateFrom(INT64_MIN), dateTo(INT64_MAX) {}
+
+        Query& withTeam(const string& team) { addNamed(archive->teamPostings, team); return *this; }
+        Query& atVenue(const string& venue) { addNamed(archive->venuePostings, venue); return *this; }
+        Query& ofType(MatchType type) { matchType = (int)type; return *this; }
+        Query& between(time_t from, time_t to) { dateFrom = from; dateTo = to; return *this; }
+        Query& since(time_t from) { dateFrom = from; return *this; }
+
+        Query& withPlayer(PlayerId player) {
+            const vector<uint32_t>* list = lookup(archive->playerPostings, player);
+            if(list) postings.push_back(list);
+            else impossible = true;
+            return *this;
+        }
+
+        // Matching match numbers in ascending order
+        vector<uint32_t> run() {
+            vector<uint32_t> result;
+            if(impossible) return result;
+
+            if(!postings.empty()) {
+                sort(postings.begin(), postings.end(),
+                     [](const vector<uint32_t>* a, const vector<uint32_t>* b) { return a->size() < b->size(); });
+                vector<uint32_t> candidates = *postings[0];
+                for(size_t i = 1; i < postings.size() && !candidates.empty(); i++) {
+                    candidates = intersect(candidates, *postings[i]);
+                }
+                for(auto n : candidates) {
+                    if(passes(n)) result.push_back(n);
+                }
+            } else if(matchType >= 0) {
+                // Walk the set bits of the type bitmap
+                const vector<uint64_t>& bitmap = archive->typeBitmaps[matchType];
+                for(size_t w = 0; w < bitmap.size(); w++) {
+                    uint64_t bits = bitmap[w];
+                    while(bits) {
+                        uint32_t n = (uint32_t)(w * 64 + __builtin_ctzll(bits));
+                        bits &= bits - 1;
+                        if(passes(n)) result.push_back(n);
+                    }
+                }
+            } else {
+                // Date range only: binary search the date index
+                const vector<pair<int64_t, uint32_t>>& dates = archive->getDateIndex();
+                auto it = lower_bound(dates.begin(), dates.end(), make_pair(dateFrom, (uint32_t)0));
+                for(; it != dates.end() && it->first <= dateTo; ++it) result.push_back(it->second);
+                sort(result.begin(), result.end());
+            }
+            return result;
+        }
+    };
+
+    Query query() const { return Query(this); }
+
+    const vector<pair<int64_t, uint32_t>>& getDateIndex() const {
+        if(!dateIndexSorted) {
+            sort(dateIndex.begin(), dateIndex.end());
+            dateIndexSorted = true;
+        }
+        return dateIndex;
+    }
+
+    // Getters
+    // Applies to matches added from now on; both kinds can be read back.
+    // Packed deliveries take a twelfth of the space but decode slower than
+    // full records once paged in, so they are for cold storage.
+    void setPackDeliveries(bool pack) { packDeliveries = pack; }
+    bool getPackDeliveries() const { return packDeliveries; }
+
+    size_t getMatchCount() const { return catalog.size(); }
+    uint64_t getMatchesSize() const { return matchesSize; }
+    const CatalogRecord& getRecord(uint32_t matchNo) const { return catalog[matchNo]; }
+    string getName(uint32_t key) const { return key < names.size() ? names[key] : ""; }
+    PlayerRegistry& getRegistry() { return *registry; }
+    const PlayerRegistry& getRegistry() const { return *registry; }
+    string getDirectory() const { return directory; }
+
+    void displayArchiveSummary() const {
+        cout << "\n===== Match Archive =====" << endl;
+        cout << "Directory: " << directory << endl;
+        cout << "Matches: " << catalog.size() << " | Teams/Venues: " << names.size()
+             << " | Players indexed: " << playerPostings.size() << endl;
+        cout << "Snapshot data: " << matchesSize / 1024 << " KB" << endl;
+    }
+};
+
+#endif
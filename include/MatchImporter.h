@@ -0,0 +1,660 @@
+#ifndef MATCHIMPORTER_H
+#define MATCHIMPORTER_H
+
+#include "Match.h"
+#include "PlayerRegistry.h"
+#include "TaskPool.h"
+#include "JsonReader.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <functional>
+#include <unordered_map>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+// One delivery as read from the file; players are indexes into the
+// match's name table
+struct ImportedDelivery {
+    uint32_t batter;
+    uint32_t nonStriker;
+    uint32_t bowler;
+    uint32_t fielder;       // Name index or IMPORT_NONE
+    uint16_t over;          // 0-based as in the source files
+    uint8_t batterRuns;
+    uint8_t wides;
+    uint8_t noBalls;
+    uint8_t byes;
+    uint8_t legByes;
+    uint8_t wicketType;     // WicketType
+};
+
+const uint32_t IMPORT_NONE = 0xFFFFFFFF;
+
+struct ImportedInnings {
+    uint32_t team;          // Name index
+    uint32_t firstDelivery;
+    uint32_t deliveryCount;
+    bool declared;
+};
+
+// Everything read from one ball-by-ball file. Names are slices into the
+// file text, which the record keeps alive.
+struct ImportedMatch {
+    string path;
+    vector<char> text;
+    bool ok;
+
+    vector<JsonSlice> names;
+    unordered_map<JsonSlice, uint32_t, JsonSliceHash> nameIndex;
+    vector<JsonSlice> personIds;            // Registry ID per name index, may be empty
+
+    JsonSlice matchType;
+    JsonSlice date;
+    JsonSlice venue;
+    JsonSlice city;
+    uint32_t teams[2];
+    uint32_t squadTeam[2];                  // Team name index of each squad list
+    vector<uint32_t> squads[2];
+    vector<JsonSlice> umpires;
+    uint32_t tossWinner;
+    JsonSlice tossDecision;
+    uint32_t winner;
+    JsonSlice resultKind;                   // "draw", "tie", "no result" or empty
+    JsonSlice marginKind;                   // "runs", "wickets" or "innings"
+    int margin;
+    int inningsMargin;
+
+    vector<ImportedInnings> innings;
+    vector<ImportedDelivery> deliveries;
+
+    ImportedMatch() { clear(); }
+
+    void clear() {
+        ok = false;
+        names.clear();
+        nameIndex.clear();
+        personIds.clear();
+        matchType = date = venue = city = tossDecision = resultKind = marginKind = JsonSlice();
+        teams[0] = teams[1] = IMPORT_NONE;
+        squadTeam[0] = squadTeam[1] = IMPORT_NONE;
+        squads[0].clear();
+        squads[1].clear();
+        umpires.clear();
+        tossWinner = winner = IMPORT_NONE;
+        margin = inningsMargin = 0;
+        innings.clear();
+        deliveries.clear();
+    }
+
+    uint32_t intern(const JsonSlice& name) {
+        auto it = nameIndex.find(name);
+        if(it != nameIndex.end()) return it->second;
+        uint32_t index = (uint32_t)names.size();
+        names.push_back(name);
+        personIds.push_back(JsonSlice());
+        nameIndex[name] = index;
+        return index;
+    }
+};
+
+struct ImportStats {
+    uint64_t files;
+    uint64_t failedFiles;
+    uint64_t matches;
+    uint64_t deliveries;
+    uint64_t bytes;
+    double parseSeconds;    // Wall time of the parallel parse stage
+    double buildSeconds;    // Wall time building Match objects
+
+    ImportStats() : files(0), failedFiles(0), matches(0), deliveries(0), bytes(0),
+                    parseSeconds(0), buildSeconds(0) {}
+
+    double getDeliveriesPerSecond() const {
+        double total = parseSeconds + buildSeconds;
+        return total > 0 ? deliveries / total : 0.0;
+    }
+};
+
+// Bulk importer for Cricsheet-style ball-by-ball JSON files.
+//
+// Files are imported in batches. Each batch is read and parsed in parallel
+// on the TaskPool into compact ImportedMatch records (no Match objects yet,
+// so workers share nothing). The batch is then turned into Match, Innings
+// and Ball objects on the calling thread, where players are registered,
+// and handed to the sink one match at a time. Memory stays bounded by the
+// batch size however many files there are.
+//
+// Teams, venues and umpires are created once per name and owned by the
+// importer, so it must outlive the matches it produced.
+class MatchImporter {
+private:
+    PlayerRegistry& registry;
+    TaskPool& pool;
+    size_t batchSize;
+    ImportStats stats;
+    unordered_map<string, Team*> teams;
+    unordered_map<string, Venue*> venues;
+    unordered_map<string, Umpire*> umpires;
+
+    typedef chrono::steady_clock Clock;
+
+    static double secondsSince(Clock::time_point start) {
+        return chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    static bool readFile(const string& path, vector<char>& out) {
+        ifstream file(path.c_str(), ios::binary | ios::ate);
+        if(!file) return false;
+        streamoff size = file.tellg();
+        if(size <= 0) return false;
+        out.resize((size_t)size);
+        file.seekg(0);
+        return (bool)file.read(out.data(), size);
+    }
+
+    static WicketType parseWicketKind(const JsonSlice& kind) {
+        if(kind == "bowled") return WicketType::BOWLED;
+        if(kind == "caught") return WicketType::CAUGHT;
+        if(kind == "lbw") return WicketType::LBW;
+        if(kind == "run out") return WicketType::RUN_OUT;
+        if(kind == "stumped") return WicketType::STUMPED;
+        if(kind == "hit wicket") return WicketType::HIT_WICKET;
+        if(kind == "caught and bowled") return WicketType::CAUGHT_AND_BOWLED;
+        if(kind == "obstructing the field" || kind == "handled the ball") return WicketType::OBSTRUCTING_FIELD;
+        if(kind == "hit the ball twice") return WicketType::HIT_BALL_TWICE;
+        if(kind == "timed out") return WicketType::TIMED_OUT;
+        if(kind == "retired out") return WicketType::TIMED_OUT; // Out, not credited to the bowler
+        return WicketType::NONE; // Retired hurt and anything unknown
+    }
+
+    static uint8_t clampByte(int64_t v) {
+        return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+    }
+
+    // --- Parsing (runs on pool workers) ---
+
+    static void parseStringList(JsonReader& r, ImportedMatch& m, vector<uint32_t>* indexes, vector<JsonSlice>* slices) {
+        if(!r.beginArray()) return;
+        while(r.nextElement()) {
+            JsonSlice s;
+            if(!r.readString(s)) return;
+            if(indexes) indexes->push_back(m.intern(s));
+            if(slices) slices->push_back(s);
+        }
+    }
+
+    static void parseOutcome(JsonReader& r, ImportedMatch& m) {
+        if(!r.beginObject()) return;
+        JsonSlice key, value;
+        while(r.nextKey(key)) {
+            if(key == "winner" && r.readString(value)) {
+                m.winner = m.intern(value);
+            } else if(key == "result") {
+                r.readString(m.resultKind);
+            } else if(key == "by" && r.beginObject()) {
+                JsonSlice kind;
+                while(r.nextKey(kind)) {
+                    int64_t n = 0;
+                    r.readInt(n);
+                    if(kind == "innings") m.inningsMargin = (int)n;
+                    else { m.marginKind = kind; m.margin = (int)n; }
+                }
+            } else {
+                r.skipValue();
+            }
+        }
+    }
+
+    static void parseInfo(JsonReader& r, ImportedMatch& m) {
+        if(!r.beginObject()) return;
+        JsonSlice key, value;
+        while(r.nextKey(key)) {
+            if(key == "match_type") {
+                r.readString(m.matchType);
+            } else if(key == "dates" && r.beginArray()) {
+                while(r.nextElement()) {
+                    if(m.date.empty()) r.readString(m.date);
+                    else r.skipValue();
+                }
+            } else if(key == "venue") {
+                r.readString(m.venue);
+            } else if(key == "city") {
+                r.readString(m.city);
+            } else if(key == "teams" && r.beginArray()) {
+                int t = 0;
+                while(r.nextElement()) {
+                    if(t < 2 && r.readString(value)) m.teams[t++] = m.intern(value);
+                    else r.skipValue();
+                }
+            } else if(key == "players" && r.beginObject()) {
+                // Keys are sorted, so squads can come before "teams"
+                int s = 0;
+                while(r.nextKey(value)) {
+                    if(s >= 2) {
+                        r.skipValue();
+                        continue;
+                    }
+                    m.squadTeam[s] = m.intern(value);
+                    parseStringList(r, m, &m.squads[s], nullptr);
+                    s++;
+                }
+            } else if(key == "registry" && r.beginObject()) {
+                while(r.nextKey(value)) {
+                    if(value == "people" && r.beginObject()) {
+                        JsonSlice name, id;
+                        while(r.nextKey(name)) {
+                            if(r.readString(id)) m.personIds[m.intern(name)] = id;
+                        }
+                    } else {
+                        r.skipValue();
+                    }
+                }
+            } else if(key == "toss" && r.beginObject()) {
+                while(r.nextKey(value)) {
+                    JsonSlice s;
+                    if(value == "winner" && r.readString(s)) m.tossWinner = m.intern(s);
+                    else if(value == "decision") r.readString(m.tossDecision);
+                    else r.skipValue();
+                }
+            } else if(key == "outcome") {
+                parseOutcome(r, m);
+            } else if(key == "officials" && r.beginObject()) {
+                while(r.nextKey(value)) {
+                    if(value == "umpires") parseStringList(r, m, nullptr, &m.umpires);
+                    else r.skipValue();
+                }
+            } else {
+                r.skipValue();
+            }
+        }
+    }
+
+    static void parseDelivery(JsonReader& r, ImportedMatch& m, uint16_t over) {
+        ImportedDelivery d;
+        memset(&d, 0, sizeof(d));
+        d.batter = d.nonStriker = d.bowler = d.fielder = IMPORT_NONE;
+        d.over = over;
+        d.wicketType = (uint8_t)WicketType::NONE;
+
+        if(!r.beginObject()) return;
+        JsonSlice key, value;
+        int64_t n;
+        while(r.nextKey(key)) {
+            if((key == "batter" || key == "batsman") && r.readString(value)) {
+                d.batter = m.intern(value);
+            } else if(key == "bowler" && r.readString(value)) {
+                d.bowler = m.intern(value);
+            } else if(key == "non_striker" && r.readString(value)) {
+                d.nonStriker = m.intern(value);
+            } else if(key == "runs" && r.beginObject()) {
+                while(r.nextKey(value)) {
+                    if((value == "batter" || value == "batsman") && r.readInt(n)) d.batterRuns = clampByte(n);
+                    else r.skipValue();
+                }
+            } else if(key == "extras" && r.beginObject()) {
+                while(r.nextKey(value)) {
+                    if(!r.readInt(n)) break;
+                    if(value == "wides") d.wides = clampByte(n);
+                    else if(value == "noballs") d.noBalls = clampByte(n);
+                    else if(value == "byes") d.byes = clampByte(n);
+                    else if(value == "legbyes") d.legByes = clampByte(n);
+                }
+            } else if(key == "wickets" && r.beginArray()) {
+                // Only the first dismissal on a delivery is kept
+                while(r.nextElement()) {
+                    if(d.wicketType != (uint8_t)WicketType::NONE || !r.beginObject()) {
+                        r.skipValue();
+                        continue;
+                    }
+                    while(r.nextKey(value)) {
+                        JsonSlice s;
+                        if(value == "kind" && r.readString(s)) {
+                            d.wicketType = (uint8_t)parseWicketKind(s);
+                        } else if(value == "fielders" && r.beginArray()) {
+                            while(r.nextElement()) {
+                                if(d.fielder != IMPORT_NONE || !r.beginObject()) {
+                                    r.skipValue();
+                                    continue;
+                                }
+                                JsonSlice field;
+                                while(r.nextKey(field)) {
+                                    if(field == "name" && r.readString(s)) d.fielder = m.intern(s);
+                                    else r.skipValue();
+                                }
+                            }
+                        } else {
+                            r.skipValue();
+                        }
+                    }
+                }
+            } else {
+                r.skipValue();
+            }
+        }
+        m.deliveries.push_back(d);
+    }
+
+    static void parseInnings(JsonReader& r, ImportedMatch& m) {
+        if(!r.beginArray()) return;
+        while(r.nextElement()) {
+            ImportedInnings inn;
+            inn.team = IMPORT_NONE;
+            inn.firstDelivery = (uint32_t)m.deliveries.size();
+            inn.declared = false;
+            bool superOver = false;
+
+            if(!r.beginObject()) return;
+            JsonSlice key, value;
+            while(r.nextKey(key)) {
+                if(key == "team" && r.readString(value)) {
+                    inn.team = m.intern(value);
+                } else if(key == "super_over") {
+                    r.readBool(superOver);
+                } else if(key == "declared") {
+                    r.readBool(inn.declared);
+                } else if(key == "overs" && r.beginArray()) {
+                    while(r.nextElement()) {
+                        if(!r.beginObject()) break;
+                        int64_t overNumber = 0;
+                        while(r.nextKey(value)) {
+                            if(value == "over") {
+                                r.readInt(overNumber);
+                            } else if(value == "deliveries" && r.beginArray()) {
+                                while(r.nextElement()) parseDelivery(r, m, (uint16_t)overNumber);
+                            } else {
+                                r.skipValue();
+                            }
+                        }
+                    }
+                } else {
+                    r.skipValue();
+                }
+            }
+            inn.deliveryCount = (uint32_t)m.deliveries.size() - inn.firstDelivery;
+            if(superOver) {
+                m.deliveries.resize(inn.firstDelivery); // Super overs are not part of the match record
+            } else {
+                m.innings.push_back(inn);
+            }
+        }
+    }
+
+public:
+    // Parse one document held in m.text. The text is modified in place.
+    static bool parseDocument(ImportedMatch& m) {
+        m.ok = false;
+        JsonReader r(m.text.data(), m.text.size());
+        if(!r.beginObject()) return false;
+        JsonSlice key;
+        while(r.nextKey(key)) {
+            if(key == "info") parseInfo(r, m);
+            else if(key == "innings") parseInnings(r, m);
+            else r.skipValue();
+        }
+        m.ok = !r.failed() && m.teams[0] != IMPORT_NONE && m.teams[1] != IMPORT_NONE;
+        return m.ok;
+    }
+
+    static bool parseFile(const string& path, ImportedMatch& m) {
+        m.clear();
+        m.path = path;
+        if(!readFile(path, m.text)) return false;
+        return parseDocument(m);
+    }
+
+private:
+    // --- Building (runs on the calling thread) ---
+
+    Team* getTeam(const string& name) {
+        auto it = teams.find(name);
+        if(it != teams.end()) return it->second;
+        Team* team = new Team(name, name);
+        teams[name] = team;
+        return team;
+    }
+
+    Venue* getVenue(const string& name, const string& city) {
+        auto it = venues.find(name);
+        if(it != venues.end()) return it->second;
+        Venue* venue = new Venue(name, city, "", 0);
+        venues[name] = venue;
+        return venue;
+    }
+
+    Umpire* getUmpire(const string& name) {
+        auto it = umpires.find(name);
+        if(it != umpires.end()) return it->second;
+        Umpire* umpire = new Umpire(name, 0, "", "", "On-field");
+        umpires[name] = umpire;
+        return umpire;
+    }
+
+    Player* getPlayer(const ImportedMatch& m, uint32_t index, Team* team) {
+        string name = m.names[index].str();
+        string personId = m.personIds[index].empty() ? "name:" + name : m.personIds[index].str();
+        Player* player = registry.createPlayer(name, 0, "", personId, 0);
+        if(team && !team->findPlayerByName(name)) team->addPlayer(player);
+        return player;
+    }
+
+    // Days since 1970-01-01 for a proleptic Gregorian date
+    static int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        int64_t era = (y >= 0 ? y : y - 399) / 400;
+        unsigned yoe = (unsigned)(y - era * 400);
+        unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + (int64_t)doe - 719468;
+    }
+
+    static time_t parseDate(const JsonSlice& date) {
+        int y = 0, mo = 0, d = 0;
+        if(date.length < 10 || sscanf(string(date.data, 10).c_str(), "%d-%d-%d", &y, &mo, &d) != 3) return 0;
+        return (time_t)(daysFromCivil(y, (unsigned)mo, (unsigned)d) * 86400);
+    }
+
+    static void setOutcome(Ball* ball, const ImportedDelivery& d, Player* fielder) {
+        // recordWicket() marks the ball as a plain wicket; the outcome is set after it
+        if(d.wicketType != (uint8_t)WicketType::NONE) {
+            ball->recordWicket((WicketType)d.wicketType, fielder);
+        }
+        if(d.wides) {
+            ball->recordBall(BallOutcome::WIDE, 0, d.wides);
+        } else if(d.noBalls) {
+            ball->recordBall(BallOutcome::NO_BALL, d.batterRuns, d.noBalls);
+        } else if(d.byes) {
+            ball->recordBall(BallOutcome::BYE, d.byes);
+        } else if(d.legByes) {
+            ball->recordBall(BallOutcome::LEG_BYE, d.legByes);
+        } else if(d.wicketType != (uint8_t)WicketType::NONE) {
+            ball->recordBall(d.batterRuns ? BallOutcome::WICKET_AND_RUNS : BallOutcome::WICKET, d.batterRuns);
+        } else {
+            static const BallOutcome byRuns[7] = {
+                BallOutcome::DOT_BALL, BallOutcome::SINGLE, BallOutcome::DOUBLE, BallOutcome::TRIPLE,
+                BallOutcome::FOUR, BallOutcome::TRIPLE, BallOutcome::SIX // 5 is all run
+            };
+            ball->recordBall(d.batterRuns <= 6 ? byRuns[d.batterRuns] : BallOutcome::TRIPLE, d.batterRuns);
+        }
+    }
+
+    Match* buildMatch(const ImportedMatch& m) {
+        Team* team[2] = {getTeam(m.names[m.teams[0]].str()), getTeam(m.names[m.teams[1]].str())};
+        vector<Player*> players(m.names.size(), nullptr);
+        for(int s = 0; s < 2; s++) {
+            if(m.squadTeam[s] == IMPORT_NONE) continue;
+            Team* squadTeam = (m.squadTeam[s] == m.teams[1]) ? team[1] : team[0];
+            for(auto index : m.squads[s]) players[index] = getPlayer(m, index, squadTeam);
+        }
+
+        string id = m.path;
+        size_t slash = id.find_last_of("/\\");
+        if(slash != string::npos) id = id.substr(slash + 1);
+        Venue* venue = getVenue(m.venue.str(), m.city.str());
+
+        Match* match;
+        if(m.matchType == "Test" || m.matchType == "MDM") match = new TestMatch(id, team[0], team[1], venue);
+        else if(m.matchType == "ODI" || m.matchType == "ODM") match = new ODIMatch(id, team[0], team[1], venue);
+        else match = new T20Match(id, team[0], team[1], venue);
+
+        time_t date = parseDate(m.date);
+        match->setMatchDate(date);
+        if(m.tossWinner != IMPORT_NONE) match->setToss(m.names[m.tossWinner].str(), m.tossDecision.str());
+        for(const auto& name : m.umpires) match->addUmpire(getUmpire(name.str()));
+
+        for(const auto& inn : m.innings) {
+            int bat = (inn.team == m.teams[1]) ? 1 : 0;
+            Innings* innings = match->startNewInnings(team[bat], team[1 - bat]);
+            int currentOver = -1, legal = 0;
+            for(uint32_t i = inn.firstDelivery; i < inn.firstDelivery + inn.deliveryCount; i++) {
+                const ImportedDelivery& d = m.deliveries[i];
+                // Players missing from the squad lists (substitutes) are still registered
+                Player* bowler = nullptr;
+                Player* batter = nullptr;
+                Player* nonStriker = nullptr;
+                if(d.bowler != IMPORT_NONE) {
+                    if(!players[d.bowler]) players[d.bowler] = getPlayer(m, d.bowler, nullptr);
+                    bowler = players[d.bowler];
+                }
+                if(d.batter != IMPORT_NONE) {
+                    if(!players[d.batter]) players[d.batter] = getPlayer(m, d.batter, nullptr);
+                    batter = players[d.batter];
+                }
+                if(d.nonStriker != IMPORT_NONE) {
+                    if(!players[d.nonStriker]) players[d.nonStriker] = getPlayer(m, d.nonStriker, nullptr);
+                    nonStriker = players[d.nonStriker];
+                }
+
+                if(d.over != currentOver) {
+                    currentOver = d.over;
+                    legal = 0;
+                    innings->startOver(bowler);
+                    innings->setBatsmen(batter, nonStriker);
+                }
+                Player* fielder = nullptr;
+                if(d.fielder != IMPORT_NONE) {
+                    if(!players[d.fielder]) players[d.fielder] = getPlayer(m, d.fielder, nullptr);
+                    fielder = players[d.fielder];
+                }
+                Ball* ball = new Ball(d.over + 1, legal + 1, bowler, batter, nonStriker);
+                setOutcome(ball, d, fielder);
+                ball->setTimestamp(date);
+                match->recordBall(ball);
+                if(ball->getIsValid()) legal++;
+            }
+            innings->setDeclared(inn.declared);
+            innings->setCompleted(true);
+        }
+
+        if(m.resultKind == "draw") {
+            match->setStatus(MatchStatus::DRAWN);
+            match->setResult("Match drawn");
+        } else if(m.resultKind == "tie") {
+            match->setStatus(MatchStatus::COMPLETED);
+            match->setResult("Match tied");
+        } else if(m.resultKind == "no result") {
+            match->setStatus(MatchStatus::ABANDONED);
+            match->setResult("No result");
+        } else if(m.winner != IMPORT_NONE) {
+            Team* w = (m.winner == m.teams[1]) ? team[1] : team[0];
+            match->setStatus(MatchStatus::COMPLETED);
+            match->setWinner(w);
+            string result = w->getTeamName() + " won by ";
+            if(m.inningsMargin) result += "an innings and ";
+            result += to_string(m.margin) + " " + m.marginKind.str();
+            match->setResult(result);
+        } else {
+            match->setStatus(MatchStatus::COMPLETED);
+        }
+        return match;
+    }
+
+public:
+    MatchImporter(PlayerRegistry& reg, TaskPool& taskPool = TaskPool::shared(), size_t batch = 256)
+        : registry(reg), pool(taskPool), batchSize(batch ? batch : 1) {}
+
+    ~MatchImporter() {
+        for(auto& t : teams) delete t.second;
+        for(auto& v : venues) delete v.second;
+        for(auto& u : umpires) delete u.second;
+    }
+
+    // No copies: matches point at the teams and venues owned here
+    MatchImporter(const MatchImporter&) = delete;
+    MatchImporter& operator=(const MatchImporter&) = delete;
+
+    // Import every file, passing each match to sink, which takes ownership
+    void importFiles(const vector<string>& paths, const function<void(Match*)>& sink) {
+        vector<ImportedMatch> batch(min(batchSize, paths.size()));
+        for(size_t first = 0; first < paths.size(); first += batchSize) {
+            size_t count = min(batchSize, paths.size() - first);
+
+            Clock::time_point start = Clock::now();
+            pool.parallelFor(0, count, 1, [&](size_t lo, size_t hi) {
+                for(size_t i = lo; i < hi; i++) parseFile(paths[first + i], batch[i]);
+            });
+            stats.parseSeconds += secondsSince(start);
+
+            start = Clock::now();
+            for(size_t i = 0; i < count; i++) {
+                ImportedMatch& m = batch[i];
+                stats.files++;
+                stats.bytes += m.text.size();
+                if(!m.ok) {
+                    stats.failedFiles++;
+                    continue;
+                }
+                stats.matches++;
+                stats.deliveries += m.deliveries.size();
+                sink(buildMatch(m));
+            }
+            stats.buildSeconds += secondsSince(start);
+        }
+    }
+
+    vector<Match*> importFiles(const vector<string>& paths) {
+        vector<Match*> matches;
+        importFiles(paths, [&](Match* match) { matches.push_back(match); });
+        return matches;
+    }
+
+    // The .json files in a directory, sorted by name
+    static vector<string> listJsonFiles(const string& dir) {
+        vector<string> files;
+#ifndef _WIN32
+        DIR* d = opendir(dir.c_str());
+        if(!d) return files;
+        while(struct dirent* entry = readdir(d)) {
+            string name = entry->d_name;
+            if(name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+                files.push_back(dir + "/" + name);
+            }
+        }
+        closedir(d);
+        sort(files.begin(), files.end());
+#endif
+        return files;
+    }
+
+    const ImportStats& getStats() const { return stats; }
+    void resetStats() { stats = ImportStats(); }
+    size_t getTeamCount() const { return teams.size(); }
+    size_t getVenueCount() const { return venues.size(); }
+
+    void displayStats() const {
+        cout << "\n===== Import Summary =====" << endl;
+        cout << "Files: " << stats.files << " (" << stats.failedFiles << " failed)" << endl;
+        cout << "Matches: " << stats.matches << ", deliveries: " << stats.deliveries << endl;
+        cout << "Read: " << stats.bytes / (1024 * 1024) << " MB" << endl;
+        cout << "Parse: " << stats.parseSeconds << " s, build: " << stats.buildSeconds << " s" << endl;
+        cout << "Throughput: " << (uint64_t)stats.getDeliveriesPerSecond() << " deliveries/s" << endl;
+    }
+};
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef MATCHSCHEDULER_H
+#define MATCHSCHEDULER_H
+
+#include "Match.h"
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <chrono>
+
+// Single-threaded hashed timer wheel with one-second ticks.
+// Each slot holds the tasks due when the hand reaches it; delays longer than
+// one revolution carry a round count instead of needing a bigger wheel.
+class TimerWheel {
+private:
+    struct Timer {
+        uint32_t taskId;
+        uint32_t rounds;
+    };
+
+    vector<vector<Timer>> slots;
+    uint32_t mask;
+    uint32_t cursor;
+    uint64_t ticks;
+    size_t pending;
+
+public:
+    TimerWheel(uint32_t slotCount = 1024) : mask(0), cursor(0), ticks(0), pending(0) {
+        uint32_t size = 1;
+        while(size < slotCount) size <<= 1; // power of two so we can mask
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    void schedule(uint32_t taskId, uint32_t delay) {
+        if(delay == 0) delay = 1; // earliest is the next tick
+        Timer timer;
+        timer.taskId = taskId;
+        timer.rounds = (delay - 1) / (mask + 1);
+        slots[(cursor + delay) & mask].push_back(timer);
+        pending++;
+    }
+
+    // Advance the hand by one tick and collect every task that is now due
+    void tick(vector<uint32_t>& due) {
+        cursor = (cursor + 1) & mask;
+        ticks++;
+        vector<Timer>& slot = slots[cursor];
+        size_t keep = 0;
+        for(size_t i = 0; i < slot.size(); i++) {
+            if(slot[i].rounds == 0) {
+                due.push_back(slot[i].taskId);
+                pending--;
+            } else {
+                slot[i].rounds--;
+                slot[keep++] = slot[i];
+            }
+        }
+        slot.resize(keep);
+    }
+
+    uint64_t getTicks() const { return ticks; }
+    size_t getPending() const { return pending; }
+};
+
+// Drives one simulated match as a resumable task (a hand-written stackless
+// coroutine). All of its state lives in this small fixed-size object, and
+// every resume() plays exactly one delivery before yielding back with the
+// number of seconds until the next one is due.
+class MatchDriver {
+public:
+    enum State {
+        START_INNINGS,
+        START_OVER,
+        BOWL,
+        FINISHED
+    };
+
+private:
+    Match* match;
+    Innings* innings;
+    Player* bowler;
+    uint32_t rng;
+    State state;
+    int nextBatter;     // Index into the batting XI of the next batter in
+    int overNumber;
+    int validBalls;     // Legal deliveries in the current over
+    int target;         // Runs needed to win in the final innings, -1 otherwise
+    int gapSeconds;     // Mean gap between deliveries
+    uint32_t deliveries;
+
+    uint32_t nextRandom() {
+        // xorshift32 - cheap and good enough for simulated outcomes
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    bool beginInnings() {
+        const vector<Innings*>& played = match->getAllInnings();
+        if((int)played.size() >= match->getMaxInnings()) return false;
+
+        // Team 1 won the toss and bats first; the format picks the side after that
+        Team* batTeam = match->getNextBattingTeam();
+        Team* bowlTeam = batTeam == match->getTeam1() ? match->getTeam2() : match->getTeam1();
+
+        target = -1;
+        if((int)played.size() + 1 == match->getMaxInnings()) {
+            int own = 0, opponent = 0;
+            for(auto inn : played) {
+                if(inn->getBattingTeam() == batTeam) own += inn->getTotalRuns();
+                else opponent += inn->getTotalRuns();
+            }
+            target = opponent - own + 1;
+            // A side that followed on and is still behind has lost by an innings
+            if(target <= 0) return false;
+        }
+
+        innings = match->startNewInnings(batTeam, bowlTeam);
+        const vector<Player*>& xi = batTeam->getPlayingXI();
+        innings->setBatsmen(xi[0], xi[1]);
+        nextBatter = 2;
+        overNumber = 0;
+        return true;
+    }
+
+    void bowlDelivery(time_t now) {
+        Ball* ball = new Ball(overNumber, validBalls + 1, bowler,
+                              innings->getStriker(), innings->getNonStriker());
+        Player* survivor = innings->getNonStriker();
+
+        // Outcome weights per 1000 deliveries
+        uint32_t roll = nextRandom() % 1000;
+        if(roll < 400) ball->recordBall(BallOutcome::DOT_BALL, 0);
+        else if(roll < 650) ball->recordBall(BallOutcome::SINGLE, 1);
+        else if(roll < 720) ball->recordBall(BallOutcome::DOUBLE, 2);
+        else if(roll < 730) ball->recordBall(BallOutcome::TRIPLE, 3);
+        else if(roll < 830) ball->recordBall(BallOutcome::FOUR, 4);
+        else if(roll < 865) ball->recordBall(BallOutcome::SIX, 6);
+        else if(roll < 905) {
+            static const WicketType kinds[] = {
+                WicketType::BOWLED, WicketType::CAUGHT, WicketType::CAUGHT,
+                WicketType::LBW, WicketType::RUN_OUT, WicketType::STUMPED
+            };
+            const vector<Player*>& fielders = innings->getBowlingTeam()->getPlayingXI();
+            ball->recordBall(BallOutcome::WICKET, 0);
+            ball->recordWicket(kinds[nextRandom() % 6], fielders[nextRandom() % fielders.size()]);
+        }
+        else if(roll < 940) ball->recordBall(BallOutcome::WIDE, 0, 1);
+        else if(roll < 950) ball->recordBall(BallOutcome::NO_BALL, 0, 1);
+        else if(roll < 970) ball->recordBall(BallOutcome::BYE, 1);
+        else ball->recordBall(BallOutcome::LEG_BYE, 1);
+
+        ball->setTimestamp(now);
+        match->recordBall(ball);
+        deliveries++;
+        if(ball->getIsValid()) validBalls++;
+
+        if(ball->getWicketType() != WicketType::NONE && !innings->getIsAllOut()) {
+            const vector<Player*>& xi = innings->getBattingTeam()->getPlayingXI();
+            Player* incoming = xi[nextBatter++];
+            if(validBalls >= 6) {
+                innings->setBatsmen(survivor, incoming);
+            } else {
+                innings->setBatsmen(incoming, survivor);
+            }
+        }
+
+        if(target > 0 && innings->getTotalRuns() >= target) {
+            innings->setCompleted(true);
+        }
+    }
+
+    void finishMatch() {
+        const vector<Innings*>& played = match->getAllInnings();
+        int runs1 = 0, runs2 = 0;
+        for(auto inn : played) {
+            if(inn->getBattingTeam() == match->getTeam1()) runs1 += inn->getTotalRuns();
+            else runs2 += inn->getTotalRuns();
+        }
+
+        match->setStatus(MatchStatus::COMPLETED);
+        if(runs1 == runs2) {
+            match->setResult("Match tied");
+        } else {
+            Team* w = runs1 > runs2 ? match->getTeam1() : match->getTeam2();
+            match->setWinner(w);
+            match->setResult(w->getTeamName() + " won");
+        }
+    }
+
+public:
+    MatchDriver(Match* m, uint32_t seed, int gap = 40)
+        : match(m), innings(nullptr), bowler(nullptr), rng(seed ? seed : 2463534242u),
+          state(START_INNINGS), nextBatter(2), overNumber(0), validBalls(0),
+          target(-1), gapSeconds(gap > 1 ? gap : 2), deliveries(0) {}
+
+    // Run until the next delivery has been bowled. Returns the delay in
+    // seconds before this match wants to be resumed, or -1 once it is over.
+    int resume(time_t now) {
+        while(true) {
+            switch(state) {
+                case START_INNINGS:
+                    if(!beginInnings()) {
+                        finishMatch();
+                        state = FINISHED;
+                        return -1;
+                    }
+                    state = START_OVER;
+                    break;
+
+                case START_OVER:
+                    if(match->checkInningsComplete(innings)) {
+                        innings->setCompleted(true);
+                        state = START_INNINGS;
+                        return 600; // Innings break
+                    }
+                    {
+                        const vector<Player*>& xi = innings->getBowlingTeam()->getPlayingXI();
+                        // Rotate the five specialist bowlers at the bottom of the XI
+                        bowler = xi[xi.size() - 1 - (overNumber % 5)];
+                    }
+                    overNumber++;
+                    validBalls = 0;
+                    innings->startOver(bowler);
+                    state = BOWL;
+                    break;
+
+                case BOWL:
+                    bowlDelivery(now);
+                    if(innings->getIsCompleted() || validBalls >= 6) {
+                        state = START_OVER;
+                        return 60; // Change of ends
+                    }
+                    return gapSeconds / 2 + (int)(nextRandom() % gapSeconds);
+
+                case FINISHED:
+                default:
+                    return -1;
+            }
+        }
+    }
+
+    Match* getMatch() const { return match; }
+    State getState() const { return state; }
+    uint32_t getDeliveries() const { return deliveries; }
+};
+
+// Cooperative scheduler running many matches on the calling thread.
+// Matches are resumed from the timer wheel whenever their next delivery is
+// due; time is virtual unless a real-time tick length is set.
+class MatchScheduler {
+private:
+    vector<MatchDriver> drivers;
+    TimerWheel wheel;
+    time_t clockStart;
+    int activeMatches;
+    unsigned int tickMillis;
+    uint32_t nextSeed;
+
+public:
+    MatchScheduler(time_t start = time(0))
+        : wheel(1024), clockStart(start), activeMatches(0), tickMillis(0), nextSeed(1) {}
+
+    // Queue a match (which must already have both playing XIs) to start after startDelay seconds
+    void addMatch(Match* match, uint32_t startDelay = 0, int gapSeconds = 40) {
+        uint32_t id = drivers.size();
+        nextSeed = nextSeed * 1103515245u + 12345u;
+        drivers.push_back(MatchDriver(match, nextSeed, gapSeconds));
+        wheel.schedule(id, startDelay);
+        activeMatches++;
+    }
+
+    // Advance up to maxTicks seconds of match time. Returns false once every match has finished.
+    bool runFor(uint64_t maxTicks) {
+        vector<uint32_t> due;
+        for(uint64_t t = 0; t < maxTicks && activeMatches > 0; t++) {
+            due.clear();
+            wheel.tick(due);
+            time_t now = clockStart + (time_t)wheel.getTicks();
+            for(auto id : due) {
+                int delay = drivers[id].resume(now);
+                if(delay < 0) {
+                    activeMatches--;
+                } else {
+                    wheel.schedule(id, (uint32_t)delay);
+                }
+            }
+            if(tickMillis > 0) {
+                this_thread::sleep_for(chrono::milliseconds(tickMillis));
+            }
+        }
+        return activeMatches > 0;
+    }
+
+    void run() {
+        while(runFor(UINT64_MAX)) {}
+    }
+
+    void setTickMillis(unsigned int ms) { tickMillis = ms; }
+
+    int getActiveMatches() const { return activeMatches; }
+    size_t getMatchCount() const { return drivers.size(); }
+    uint64_t getElapsedSeconds() const { return wheel.getTicks(); }
+
+    uint64_t getDeliveriesPlayed() const {
+        uint64_t total = 0;
+        for(const auto& d : drivers) total += d.getDeliveries();
+        return total;
+    }
+};
+
+#endif
@@ -0,0 +1,621 @@
+#ifndef MATCHSNAPSHOT_H
+#define MATCHSNAPSHOT_H
+
+#include "Match.h"
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Binary match snapshot format (version 2)
+//
+// A snapshot is a header followed by sections of fixed-width records.
+// Records refer to each other by index and to text by (offset, length) into
+// the string section, never by pointer, so a mapped file can be read in
+// place. Sections start on 8-byte boundaries and integers are stored in the
+// host's (little-endian) byte order.
+//
+// Version 2 added the packed deliveries section. A packed snapshot (see
+// DeliveryCodec.h) leaves the overs and balls sections empty and stores
+// them bit-packed there instead. Version 1 files are still readable.
+// ---------------------------------------------------------------------------
+
+const uint32_t SNAPSHOT_VERSION = 2;
+const uint32_t SNAPSHOT_V1_HEADER_SIZE = 216;
+const uint32_t SNAPSHOT_NONE = 0xFFFFFFFF; // Null record index
+const char SNAPSHOT_MAGIC[8] = {'F', 'S', 'B', 'S', 'N', 'A', 'P', 0};
+
+enum SnapshotSectionId {
+    SECTION_TEAMS,
+    SECTION_PLAYERS,
+    SECTION_OFFICIALS,
+    SECTION_INNINGS,
+    SECTION_OVERS,
+    SECTION_BALLS,
+    SECTION_STRINGS,
+    SECTION_PACKED_DELIVERIES,  // Version 2
+    SECTION_COUNT
+};
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotSection {
+    uint64_t offset;
+    uint32_t count;
+    uint32_t recordSize;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t fileSize;
+    int64_t matchDate;
+    uint32_t matchType;     // MatchType
+    uint32_t status;        // MatchStatus
+    SnapshotString matchId;
+    SnapshotString venueName;
+    SnapshotString venueCity;
+    SnapshotString venueCountry;
+    SnapshotString tossWinner;
+    SnapshotString tossDecision;
+    SnapshotString result;
+    uint32_t winnerTeam;    // Team index or SNAPSHOT_NONE
+    uint32_t reserved;
+    SnapshotSection sections[SECTION_COUNT];
+};
+
+struct TeamRecord {
+    SnapshotString name;
+    SnapshotString country;
+    uint32_t firstPlayer;   // Squad occupies [firstPlayer, firstPlayer + playerCount)
+    uint32_t playerCount;
+    int32_t worldRanking;
+    uint32_t captain;       // Player index or SNAPSHOT_NONE
+};
+
+enum SnapshotPlayerFlags {
+    PLAYER_IN_XI = 1,
+    PLAYER_LEFT_HANDED = 2
+};
+
+struct PlayerRecord {
+    SnapshotString name;
+    SnapshotString personId;
+    uint32_t registryId;    // PlayerId for joins across snapshots
+    uint32_t team;
+    int32_t jerseyNumber;
+    uint32_t flags;         // SnapshotPlayerFlags
+};
+
+enum SnapshotOfficialKind {
+    OFFICIAL_UMPIRE,
+    OFFICIAL_COMMENTATOR,
+    OFFICIAL_BROADCASTER
+};
+
+struct OfficialRecord {
+    uint32_t kind;          // SnapshotOfficialKind
+    uint32_t reserved;
+    SnapshotString name;
+    SnapshotString detail;  // Umpire type, commentary language or region
+};
+
+struct PhaseRecord {
+    int32_t runs;
+    int32_t balls;
+    int32_t wickets;
+    int32_t dotBalls;
+    int32_t fours;
+    int32_t sixes;
+};
+
+enum SnapshotInningsFlags {
+    INNINGS_COMPLETED = 1,
+    INNINGS_ALL_OUT = 2,
+    INNINGS_DECLARED = 4
+};
+
+struct InningsRecord {
+    uint32_t inningsNumber;
+    uint32_t battingTeam;
+    uint32_t bowlingTeam;
+    uint32_t flags;         // SnapshotInningsFlags
+    uint32_t firstOver;     // Overs occupy [firstOver, firstOver + overCount)
+    uint32_t overCount;
+    int32_t totalRuns;
+    int32_t totalWickets;
+    int32_t totalExtras;
+    int32_t wides;
+    int32_t noBalls;
+    int32_t byes;
+    int32_t legByes;
+    int32_t powerplayOvers;
+    int32_t deathStartOver;
+    uint32_t reserved;
+    PhaseRecord phases[PHASE_COUNT];
+};
+
+struct OverRecord {
+    uint32_t overNumber;
+    uint32_t bowler;
+    uint32_t firstBall;     // Balls occupy [firstBall, firstBall + ballCount)
+    uint32_t ballCount;
+    int32_t runs;
+    int32_t wickets;
+    uint32_t isMaiden;
+    uint32_t reserved;
+};
+
+enum SnapshotBallFlags {
+    BALL_VALID = 1
+};
+
+struct BallRecord {
+    int64_t timestamp;
+    uint32_t bowler;
+    uint32_t batsman;
+    uint32_t nonStriker;
+    uint32_t fielder;
+    SnapshotString commentary;
+    int16_t overNumber;
+    uint8_t ballNumber;
+    uint8_t outcome;        // BallOutcome
+    uint8_t wicketType;     // WicketType
+    uint8_t runs;
+    uint8_t extras;
+    uint8_t flags;          // SnapshotBallFlags
+};
+
+static_assert(sizeof(SnapshotHeader) == 232, "snapshot header layout changed");
+static_assert(sizeof(TeamRecord) == 32, "team record layout changed");
+static_assert(sizeof(PlayerRecord) == 32, "player record layout changed");
+static_assert(sizeof(OfficialRecord) == 24, "official record layout changed");
+static_assert(sizeof(InningsRecord) == 136, "innings record layout changed");
+static_assert(sizeof(OverRecord) == 32, "over record layout changed");
+static_assert(sizeof(BallRecord) == 40, "ball record layout changed");
+
+// Flattens a Match into the snapshot layout
+class MatchSnapshotWriter {
+private:
+    SnapshotHeader header;
+    vector<TeamRecord> teams;
+    vector<PlayerRecord> players;
+    vector<OfficialRecord> officials;
+    vector<InningsRecord> innings;
+    vector<OverRecord> overs;
+    vector<BallRecord> balls;
+    vector<char> strings;
+    unordered_map<const Player*, uint32_t> playerIndex;
+    unordered_map<const Team*, uint32_t> teamIndex;
+
+    SnapshotString addString(const string& text) {
+        SnapshotString ref;
+        ref.offset = text.empty() ? 0 : (uint32_t)strings.size(); // Empty strings are always {0, 0}
+        ref.length = (uint32_t)text.size();
+        strings.insert(strings.end(), text.begin(), text.end());
+        return ref;
+    }
+
+    uint32_t indexOf(const Player* player) const {
+        auto it = playerIndex.find(player);
+        return it != playerIndex.end() ? it->second : SNAPSHOT_NONE;
+    }
+
+    uint32_t indexOf(const Team* team) const {
+        auto it = teamIndex.find(team);
+        return it != teamIndex.end() ? it->second : SNAPSHOT_NONE;
+    }
+
+    void addTeam(const Team* team) {
+        if(!team) return;
+        uint32_t index = (uint32_t)teams.size();
+        teamIndex[team] = index;
+
+        TeamRecord record;
+        record.name = addString(team->getTeamName());
+        record.country = addString(team->getCountry());
+        record.firstPlayer = (uint32_t)players.size();
+        record.playerCount = (uint32_t)team->getSquad().size();
+        record.worldRanking = team->getWorldRanking();
+
+        for(auto player : team->getSquad()) {
+            playerIndex[player] = (uint32_t)players.size();
+            PlayerRecord p;
+            p.name = addString(player->getName());
+            p.personId = addString(player->getId());
+            p.registryId = player->getRegistryId();
+            p.team = index;
+            p.jerseyNumber = player->getJerseyNumber();
+            p.flags = 0;
+            if(player->getIsPlaying()) p.flags |= PLAYER_IN_XI;
+            if(player->getBattingStyle() == "Left-handed") p.flags |= PLAYER_LEFT_HANDED;
+            players.push_back(p);
+        }
+        record.captain = indexOf(team->getCaptain());
+        teams.push_back(record);
+    }
+
+    void addOfficial(SnapshotOfficialKind kind, const string& name, const string& detail) {
+        OfficialRecord record;
+        record.kind = kind;
+        record.reserved = 0;
+        record.name = addString(name);
+        record.detail = addString(detail);
+        officials.push_back(record);
+    }
+
+    void addInnings(const Innings* inn) {
+        InningsRecord record;
+        memset(&record, 0, sizeof(record));
+        record.inningsNumber = inn->getInningsNumber();
+        record.battingTeam = indexOf(inn->getBattingTeam());
+        record.bowlingTeam = indexOf(inn->getBowlingTeam());
+        if(inn->getIsCompleted()) record.flags |= INNINGS_COMPLETED;
+        if(inn->getIsAllOut()) record.flags |= INNINGS_ALL_OUT;
+        if(inn->getIsDeclared()) record.flags |= INNINGS_DECLARED;
+        record.firstOver = (uint32_t)overs.size();
+        record.overCount = (uint32_t)inn->getOvers().size();
+        record.totalRuns = inn->getTotalRuns();
+        record.totalWickets = inn->getTotalWickets();
+        record.totalExtras = inn->getTotalExtras();
+        record.wides = inn->getWides();
+        record.noBalls = inn->getNoBalls();
+        record.byes = inn->getByes();
+        record.legByes = inn->getLegByes();
+        record.powerplayOvers = inn->getPowerplayOvers();
+        record.deathStartOver = inn->getDeathStartOver();
+        for(int p = 0; p < PHASE_COUNT; p++) {
+            const PhaseStats& stats = inn->getPhaseTotals((InningsPhase)p);
+            PhaseRecord& phase = record.phases[p];
+            phase.runs = stats.runs;
+            phase.balls = stats.balls;
+            phase.wickets = stats.wickets;
+            phase.dotBalls = stats.dotBalls;
+            phase.fours = stats.fours;
+            phase.sixes = stats.sixes;
+        }
+        innings.push_back(record);
+
+        for(auto over : inn->getOvers()) {
+            OverRecord o;
+            o.overNumber = over->getOverNumber();
+            o.bowler = indexOf(over->getBowler());
+            o.firstBall = (uint32_t)balls.size();
+            o.ballCount = (uint32_t)over->getBalls().size();
+            o.runs = over->getRunsInOver();
+            o.wickets = over->getWicketsInOver();
+            o.isMaiden = over->getIsMaidenOver() ? 1 : 0;
+            o.reserved = 0;
+            overs.push_back(o);
+
+            for(auto ball : over->getBalls()) {
+                BallRecord b;
+                b.timestamp = (int64_t)ball->getTimestamp();
+                b.bowler = indexOf(ball->getBowler());
+                b.batsman = indexOf(ball->getBatsman());
+                b.nonStriker = indexOf(ball->getNonStriker());
+                b.fielder = indexOf(ball->getFielder());
+                b.commentary = addString(ball->getCommentary());
+                b.overNumber = (int16_t)ball->getOverNumber();
+                b.ballNumber = (uint8_t)ball->getBallNumber();
+                b.outcome = (uint8_t)ball->getOutcome();
+                b.wicketType = (uint8_t)ball->getWicketType();
+                b.runs = (uint8_t)ball->getRuns();
+                b.extras = (uint8_t)ball->getExtras();
+                b.flags = ball->getIsValid() ? BALL_VALID : 0;
+                balls.push_back(b);
+            }
+        }
+    }
+
+    static size_t alignUp(size_t n) { return (n + 7) & ~(size_t)7; }
+
+    template<typename T>
+    void placeSection(SnapshotSectionId id, const vector<T>& records, size_t& cursor) {
+        cursor = alignUp(cursor);
+        header.sections[id].offset = cursor;
+        header.sections[id].count = (uint32_t)records.size();
+        header.sections[id].recordSize = sizeof(T);
+        cursor += records.size() * sizeof(T);
+    }
+
+    template<typename T>
+    void copySection(SnapshotSectionId id, const vector<T>& records, vector<char>& out) const {
+        if(records.empty()) return;
+        memcpy(&out[header.sections[id].offset], records.data(), records.size() * sizeof(T));
+    }
+
+public:
+    MatchSnapshotWriter() {}
+
+    // Serialize a complete match into out (replacing its contents)
+    void write(const Match& match, vector<char>& out) {
+        teams.clear(); players.clear(); officials.clear();
+        innings.clear(); overs.clear(); balls.clear(); strings.clear();
+        playerIndex.clear(); teamIndex.clear();
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.headerSize = sizeof(SnapshotHeader);
+        header.matchDate = (int64_t)match.getMatchDate();
+        header.matchType = (uint32_t)match.getMatchType();
+        header.status = (uint32_t)match.getStatus();
+        header.matchId = addString(match.getMatchId());
+        if(match.getVenue()) {
+            header.venueName = addString(match.getVenue()->getStadiumName());
+            header.venueCity = addString(match.getVenue()->getCity());
+            header.venueCountry = addString(match.getVenue()->getCountry());
+        }
+        header.tossWinner = addString(match.getTossWinner());
+        header.tossDecision = addString(match.getTossDecision());
+        header.result = addString(match.getResult());
+
+        addTeam(match.getTeam1());
+        addTeam(match.getTeam2());
+        header.winnerTeam = indexOf(match.getWinner());
+
+        for(auto umpire : match.getUmpires()) {
+            addOfficial(OFFICIAL_UMPIRE, umpire->getName(), umpire->getUmpireType());
+        }
+        for(auto comm : match.getCommentators()) {
+            addOfficial(OFFICIAL_COMMENTATOR, comm->getName(), comm->getLanguage());
+        }
+        for(auto agency : match.getBroadcasters()) {
+            addOfficial(OFFICIAL_BROADCASTER, agency->getAgencyName(), agency->getRegion());
+        }
+        for(auto inn : match.getAllInnings()) {
+            addInnings(inn);
+        }
+
+        size_t cursor = sizeof(SnapshotHeader);
+        placeSection(SECTION_TEAMS, teams, cursor);
+        placeSection(SECTION_PLAYERS, players, cursor);
+        placeSection(SECTION_OFFICIALS, officials, cursor);
+        placeSection(SECTION_INNINGS, innings, cursor);
+        placeSection(SECTION_OVERS, overs, cursor);
+        placeSection(SECTION_BALLS, balls, cursor);
+        placeSection(SECTION_STRINGS, strings, cursor);
+        placeSection(SECTION_PACKED_DELIVERIES, vector<uint8_t>(), cursor);
+        header.fileSize = alignUp(cursor);
+
+        out.assign(header.fileSize, 0);
+        memcpy(&out[0], &header, sizeof(header));
+        copySection(SECTION_TEAMS, teams, out);
+        copySection(SECTION_PLAYERS, players, out);
+        copySection(SECTION_OFFICIALS, officials, out);
+        copySection(SECTION_INNINGS, innings, out);
+        copySection(SECTION_OVERS, overs, out);
+        copySection(SECTION_BALLS, balls, out);
+        copySection(SECTION_STRINGS, strings, out);
+    }
+
+    bool writeFile(const Match& match, const string& path) {
+        vector<char> buffer;
+        write(match, buffer);
+        ofstream file(path.c_str(), ios::binary | ios::trunc);
+        if(!file) return false;
+        file.write(buffer.data(), buffer.size());
+        return file.good();
+    }
+};
+
+// Read-only view of a snapshot, queried in place.
+// open() memory-maps the file (read into memory where mmap is unavailable);
+// openRange() does the same for one snapshot stored inside a larger file,
+// and load() wraps a buffer the caller keeps alive. Validation only checks
+// the header and section bounds, so opening costs the same for any match size.
+class MatchSnapshot {
+private:
+    const char* base;
+    size_t length;
+    void* mapping;
+    size_t mappingLength;
+    vector<char> owned;
+    SnapshotHeader headerCopy; // Header upgraded to the current layout
+
+    bool validate() {
+        if(length < SNAPSHOT_V1_HEADER_SIZE) return false;
+        const SnapshotHeader* stored = reinterpret_cast<const SnapshotHeader*>(base);
+        if(memcmp(stored->magic, SNAPSHOT_MAGIC, sizeof(stored->magic)) != 0) return false;
+        if(stored->version == 1 && stored->headerSize == SNAPSHOT_V1_HEADER_SIZE) {
+            // Version 1 headers end before the packed deliveries section
+            memset(&headerCopy, 0, sizeof(headerCopy));
+            memcpy(&headerCopy, base, SNAPSHOT_V1_HEADER_SIZE);
+            headerCopy.sections[SECTION_PACKED_DELIVERIES].recordSize = 1;
+        } else if(stored->version == SNAPSHOT_VERSION && stored->headerSize == sizeof(SnapshotHeader) &&
+                  length >= sizeof(SnapshotHeader)) {
+            memcpy(&headerCopy, base, sizeof(SnapshotHeader));
+        } else {
+            return false;
+        }
+        const SnapshotHeader& h = headerCopy;
+        if(h.fileSize > length) return false;
+
+        static const uint32_t recordSizes[SECTION_COUNT] = {
+            sizeof(TeamRecord), sizeof(PlayerRecord), sizeof(OfficialRecord),
+            sizeof(InningsRecord), sizeof(OverRecord), sizeof(BallRecord), 1, 1
+        };
+        for(int i = 0; i < SECTION_COUNT; i++) {
+            const SnapshotSection& s = h.sections[i];
+            if(s.recordSize != recordSizes[i] || s.offset % 8 != 0) return false;
+            if(s.offset > h.fileSize || (uint64_t)s.count * s.recordSize > h.fileSize - s.offset) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    MatchSnapshot() : base(nullptr), length(0), mapping(nullptr), mappingLength(0) {
+        memset(&headerCopy, 0, sizeof(headerCopy));
+    }
+
+    // No copies: the view owns its mapping
+    MatchSnapshot(const MatchSnapshot&) = delete;
+    MatchSnapshot& operator=(const MatchSnapshot&) = delete;
+
+    ~MatchSnapshot() {
+        close();
+    }
+
+    bool open(const string& path) {
+        return openRange(path, 0, 0);
+    }
+
+    // Map size bytes starting at offset (size 0 = to the end of the file).
+    // offset must be a multiple of 8 so the records stay aligned.
+    bool openRange(const string& path, uint64_t offset, uint64_t size) {
+        close();
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) return false;
+        struct stat info;
+        if(fstat(fd, &info) != 0 || (uint64_t)info.st_size <= offset) {
+            ::close(fd);
+            return false;
+        }
+        if(size == 0 || offset + size > (uint64_t)info.st_size) {
+            size = (uint64_t)info.st_size - offset;
+        }
+
+        // mmap offsets must be page aligned
+        uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t mapStart = offset - offset % page;
+        size_t mapLength = (size_t)(offset - mapStart + size);
+        void* mapped = mmap(nullptr, mapLength, PROT_READ, MAP_PRIVATE, fd, (off_t)mapStart);
+        ::close(fd);
+        if(mapped == MAP_FAILED) return false;
+        mapping = mapped;
+        mappingLength = mapLength;
+        base = (const char*)mapped + (offset - mapStart);
+        length = (size_t)size;
+#else
+        ifstream file(path.c_str(), ios::binary);
+        if(!file) return false;
+        if(size == 0) {
+            file.seekg(0, ios::end);
+            size = (uint64_t)file.tellg() - offset;
+        }
+        owned.resize((size_t)size);
+        file.seekg((streamoff)offset);
+        file.read(owned.data(), owned.size());
+        if(!file) return false;
+        base = owned.data();
+        length = owned.size();
+#endif
+        if(!validate()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // View over caller-owned memory (must be 8-byte aligned and outlive the snapshot)
+    bool load(const char* data, size_t size) {
+        close();
+        base = data;
+        length = size;
+        if(!validate()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifndef _WIN32
+        if(mapping) munmap(mapping, mappingLength);
+#endif
+        mapping = nullptr;
+        mappingLength = 0;
+        owned.clear();
+        base = nullptr;
+        length = 0;
+        memset(&headerCopy, 0, sizeof(headerCopy));
+    }
+
+    bool isOpen() const { return base != nullptr; }
+
+    const SnapshotHeader& header() const {
+        return headerCopy;
+    }
+
+    uint32_t count(SnapshotSectionId id) const {
+        return header().sections[id].count;
+    }
+
+    template<typename T>
+    const T* section(SnapshotSectionId id) const {
+        return reinterpret_cast<const T*>(base + header().sections[id].offset);
+    }
+
+    const TeamRecord& team(uint32_t i) const { return section<TeamRecord>(SECTION_TEAMS)[i]; }
+    const PlayerRecord& player(uint32_t i) const { return section<PlayerRecord>(SECTION_PLAYERS)[i]; }
+    const OfficialRecord& official(uint32_t i) const { return section<OfficialRecord>(SECTION_OFFICIALS)[i]; }
+    const InningsRecord& innings(uint32_t i) const { return section<InningsRecord>(SECTION_INNINGS)[i]; }
+    const OverRecord& over(uint32_t i) const { return section<OverRecord>(SECTION_OVERS)[i]; }
+    const BallRecord& ball(uint32_t i) const { return section<BallRecord>(SECTION_BALLS)[i]; }
+
+    // Packed snapshots have no over or ball records; unpack them with DeliveryCodec
+    bool isPacked() const { return count(SECTION_PACKED_DELIVERIES) > 0; }
+
+    // Range of ball records bowled in an innings (unpacked snapshots only)
+    uint32_t firstBallOfInnings(uint32_t i) const {
+        const InningsRecord& inn = innings(i);
+        return inn.overCount ? over(inn.firstOver).firstBall : 0;
+    }
+
+    uint32_t ballCountOfInnings(uint32_t i) const {
+        const InningsRecord& inn = innings(i);
+        if(inn.overCount == 0) return 0;
+        const OverRecord& last = over(inn.firstOver + inn.overCount - 1);
+        return last.firstBall + last.ballCount - firstBallOfInnings(i);
+    }
+
+    // Pointer into the string section; empty for out-of-range references
+    const char* stringData(SnapshotString ref) const {
+        const SnapshotSection& s = header().sections[SECTION_STRINGS];
+        if((uint64_t)ref.offset + ref.length > s.count) return "";
+        return base + s.offset + ref.offset;
+    }
+
+    string getString(SnapshotString ref) const {
+        const SnapshotSection& s = header().sections[SECTION_STRINGS];
+        if((uint64_t)ref.offset + ref.length > s.count) return "";
+        return string(base + s.offset + ref.offset, ref.length);
+    }
+
+    size_t getSize() const { return length; }
+
+    void displaySummary() const {
+        const SnapshotHeader& h = header();
+        cout << "\n===== Snapshot: " << getString(h.matchId) << " =====" << endl;
+        cout << "Venue: " << getString(h.venueName) << ", " << getString(h.venueCity) << endl;
+        for(uint32_t i = 0; i < count(SECTION_INNINGS); i++) {
+            const InningsRecord& inn = innings(i);
+            cout << "Innings " << inn.inningsNumber << ": "
+                 << getString(team(inn.battingTeam).name) << " "
+                 << inn.totalRuns << "/" << inn.totalWickets
+                 << " (" << inn.overCount << " overs)" << endl;
+        }
+        if(h.result.length > 0) cout << "Result: " << getString(h.result) << endl;
+        cout << "Size: " << length << " bytes" << endl;
+    }
+};
+
+#endif
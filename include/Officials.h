@@ -26,21 +26,43 @@ public:
 };
 
 // Commentator class
+class EventCursor;
+
 class Commentator : public Person {
 private:
     string language;
     string specialization; // TV, Radio, Digital
+    EventCursor* feed;     // Match events, read through EventBus::catchUp
+    int ballsCalled;
+    int wicketsCalled;
     
 public:
-    Commentator() : Person(), language("English"), specialization("TV") {}
+    Commentator() : Person(), language("English"), specialization("TV"), feed(nullptr),
+                    ballsCalled(0), wicketsCalled(0) {}
     
     Commentator(string n, int a, string nat, string i, string lang, string spec)
-        : Person(n, a, nat, i), language(lang), specialization(spec) {}
+        : Person(n, a, nat, i), language(lang), specialization(spec), feed(nullptr),
+          ballsCalled(0), wicketsCalled(0) {}
     
     void displayInfo() const override {
         cout << "Commentator: " << name << endl;
         cout << "Language: " << language << " | Platform: " << specialization << endl;
+        if(ballsCalled > 0) {
+            cout << "Called " << ballsCalled << " deliveries, " << wicketsCalled << " wickets" << endl;
+        }
+    }
+    
+    void callDelivery(bool wicket) {
+        ballsCalled++;
+        if(wicket) wicketsCalled++;
     }
+    
+    void setFeed(EventCursor* cursor) { feed = cursor; }
+    EventCursor* getFeed() const { return feed; }
+    string getLanguage() const { return language; }
+    string getSpecialization() const { return specialization; }
+    int getBallsCalled() const { return ballsCalled; }
+    int getWicketsCalled() const { return wicketsCalled; }
 };
 
 // Ground Staff class
@@ -77,6 +99,7 @@ public:
     }
     
     void resolveConflict() { conflictsResolved++; }
+    int getConflictsResolved() const { return conflictsResolved; }
     string getUsername() const { return username; }
 };
 
@@ -25,7 +25,7 @@ public:
     virtual void displayInfo() const = 0;
     
     // Getters
-    string getName() const { return name; }
+    const string& getName() const { return name; }
     int getAge() const { return age; }
     string getNationality() const { return nationality; }
     string getId() const { return id; }
@@ -3,6 +3,11 @@
 
 #include "Person.h"
 #include <vector>
+#include <cstdint>
+
+// Dense tournament-wide player identifier assigned by PlayerRegistry
+typedef uint32_t PlayerId;
+const PlayerId INVALID_PLAYER_ID = 0xFFFFFFFF;
 
 // Enum for player roles
 enum class PlayerRole {
@@ -47,14 +52,18 @@ private:
     string bowlingStyle;  // Fast, Medium, Spin, Off-spin, Leg-spin
     PlayerStats stats;
     bool isPlaying;
+    PlayerId registryId;
+    
+    friend class PlayerRegistry; // Assigns registryId
 
 public:
     Player() : Person(), jerseyNumber(0), battingStyle(""), 
-               bowlingStyle(""), isPlaying(false) {}
+               bowlingStyle(""), isPlaying(false), registryId(INVALID_PLAYER_ID) {}
     
     Player(string n, int a, string nat, string i, int jersey)
         : Person(n, a, nat, i), jerseyNumber(jersey), 
-          battingStyle("Right-handed"), bowlingStyle(""), isPlaying(false) {}
+          battingStyle("Right-handed"), bowlingStyle(""), isPlaying(false),
+          registryId(INVALID_PLAYER_ID) {}
     
     void addRole(PlayerRole role) {
         roles.push_back(role);
@@ -106,6 +115,7 @@ public:
     PlayerStats& getStats() { return stats; }
     const PlayerStats& getStats() const { return stats; }
     bool getIsPlaying() const { return isPlaying; }
+    PlayerId getRegistryId() const { return registryId; }
     
     void setBattingStyle(string style) { battingStyle = style; }
     void setBowlingStyle(string style) { bowlingStyle = style; }
@@ -0,0 +1,89 @@
+#ifndef PLAYERREGISTRY_H
+#define PLAYERREGISTRY_H
+
+#include "Player.h"
+#include <deque>
+#include <unordered_map>
+
+// Tournament-wide owner of every Player record.
+// Players are stored in fixed-size chunks (std::deque), so records stay
+// packed together while their addresses never move as the registry grows.
+// Each player gets a dense 32-bit PlayerId equal to its position, which
+// makes ID lookups an index and lets stat tables key on a small integer.
+class PlayerRegistry {
+private:
+    deque<Player> players;
+    unordered_map<string, PlayerId> byName;
+    unordered_map<string, PlayerId> byPersonId;
+
+public:
+    PlayerRegistry() {}
+
+    // No copies: Teams and Balls point into the registry
+    PlayerRegistry(const PlayerRegistry&) = delete;
+    PlayerRegistry& operator=(const PlayerRegistry&) = delete;
+
+    void reserve(size_t expectedPlayers) {
+        byName.reserve(expectedPlayers);
+        byPersonId.reserve(expectedPlayers);
+    }
+
+    // Create a player, or return the existing record for this person ID
+    Player* createPlayer(string name, int age, string nationality, string personId, int jersey) {
+        auto existing = byPersonId.find(personId);
+        if(existing != byPersonId.end()) {
+            return &players[existing->second];
+        }
+
+        PlayerId id = (PlayerId)players.size();
+        players.push_back(Player(name, age, nationality, personId, jersey));
+        Player* player = &players.back();
+        player->registryId = id;
+
+        byPersonId[personId] = id;
+        // Name lookups resolve to the first player registered with that name
+        byName.insert(make_pair(name, id));
+        return player;
+    }
+
+    Player* getPlayer(PlayerId id) {
+        return id < players.size() ? &players[id] : nullptr;
+    }
+
+    const Player* getPlayer(PlayerId id) const {
+        return id < players.size() ? &players[id] : nullptr;
+    }
+
+    Player* findByName(const string& name) {
+        auto it = byName.find(name);
+        return it != byName.end() ? &players[it->second] : nullptr;
+    }
+
+    Player* findByPersonId(const string& personId) {
+        auto it = byPersonId.find(personId);
+        return it != byPersonId.end() ? &players[it->second] : nullptr;
+    }
+
+    PlayerId getIdByName(const string& name) const {
+        auto it = byName.find(name);
+        return it != byName.end() ? it->second : INVALID_PLAYER_ID;
+    }
+
+    PlayerId getIdByPersonId(const string& personId) const {
+        auto it = byPersonId.find(personId);
+        return it != byPersonId.end() ? it->second : INVALID_PLAYER_ID;
+    }
+
+    size_t size() const { return players.size(); }
+
+    void displayRegistry() const {
+        cout << "\n===== Player Registry =====" << endl;
+        cout << "Registered Players: " << players.size() << endl;
+        for(const auto& player : players) {
+            cout << "  [" << player.getRegistryId() << "] " << player.getName()
+                 << " (" << player.getId() << ")" << endl;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef SCOREWIRE_H
+#define SCOREWIRE_H
+
+#include "Scorebook.h"
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// Scorer wire protocol
+//
+// Every frame is  uint32 payload length | uint8 type | payload
+// with all integers little-endian. Clients send HELLO once (the server
+// closes a connection that sends another), then ENTRY frames; the server
+// answers every ENTRY with an ACK carrying the client's sequence number,
+// and streams UPDATE frames (deliveries, conflicts, resolutions) to
+// clients that subscribed in their HELLO.
+//
+//   HELLO   flags u8, user id (u8 length + bytes), user name (same)
+//   ENTRY   seq u32 (from 1 per scorer; 0 = unnumbered), over i32, ball u8, outcome u8, wicket u8, runs u8,
+//           extras u8, timestamp i64
+//   ACK     seq u32, status u8 (WireAckStatus), retry-after ms u32 (THROTTLED only)
+//   UPDATE  sequence u64, kind u8, innings u8, over i32, ball u8,
+//           outcome u8, wicket u8, runs u8, extras u8, innings runs i32,
+//           innings wickets u8, entry count u16
+// ---------------------------------------------------------------------------
+
+enum WireFrameType {
+    FRAME_HELLO = 1,
+    FRAME_ENTRY = 2,
+    FRAME_ACK = 16,
+    FRAME_UPDATE = 17,
+    FRAME_SYNC_DIGEST = 32,     // Replica sync: version vector
+    FRAME_SYNC_RECORDS = 33,    // Replica sync: run of one origin's log
+    FRAME_AUDIT_ENTRY = 48,     // Audit journal: one scorer's entry
+    FRAME_AUDIT_RULING = 49     // Audit journal: a supervisor ruling
+};
+
+enum WireHelloFlags {
+    HELLO_SUBSCRIBE = 1     // Stream UPDATE frames to this client
+};
+
+enum WireAckStatus {
+    ACK_ACCEPTED = 0,
+    ACK_CONFLICT = 1,       // Accepted, but the ball is in conflict
+    ACK_REJECTED = 2,       // No HELLO yet, malformed, or sync disabled
+    ACK_DUPLICATE = 3,      // Sequence already seen; the earlier copy stands
+    ACK_THROTTLED = 4       // Over a rate limit and not recorded; resend after the given delay
+};
+
+const size_t FRAME_HEADER_SIZE = 5;
+const uint32_t MAX_FRAME_PAYLOAD = 1024;
+const size_t MAX_WIRE_STRING = 255;        // Longer strings are cut by WireWriter::str
+
+struct FrameView {
+    uint8_t type;
+    const char* payload;
+    uint32_t length;
+};
+
+// Bytes taken by the complete frame at data; 0 if more bytes are needed,
+// -1 if the stream is corrupt
+inline long parseFrame(const char* data, size_t available, FrameView& frame) {
+    if(available < FRAME_HEADER_SIZE) return 0;
+    uint32_t length;
+    memcpy(&length, data, 4);
+    if(length > MAX_FRAME_PAYLOAD) return -1;
+    if(available < FRAME_HEADER_SIZE + length) return 0;
+    frame.type = (uint8_t)data[4];
+    frame.payload = data + FRAME_HEADER_SIZE;
+    frame.length = length;
+    return (long)(FRAME_HEADER_SIZE + length);
+}
+
+// Appends frames to a byte buffer
+class WireWriter {
+private:
+    vector<char>& out;
+    size_t frameStart;
+
+    void put(const void* data, size_t n) {
+        const char* p = (const char*)data;
+        out.insert(out.end(), p, p + n);
+    }
+
+public:
+    WireWriter(vector<char>& buffer) : out(buffer), frameStart(0) {}
+
+    void begin(WireFrameType type) {
+        frameStart = out.size();
+        uint32_t length = 0;
+        put(&length, 4);
+        out.push_back((char)type);
+    }
+
+    // Patch the payload length into the frame header
+    void end() {
+        uint32_t length = (uint32_t)(out.size() - frameStart - FRAME_HEADER_SIZE);
+        memcpy(&out[frameStart], &length, 4);
+    }
+
+    void u8(uint8_t v) { out.push_back((char)v); }
+    void u16(uint16_t v) { put(&v, 2); }
+    void u32(uint32_t v) { put(&v, 4); }
+    void i32(int32_t v) { put(&v, 4); }
+    void i64(int64_t v) { put(&v, 8); }
+    void u64(uint64_t v) { put(&v, 8); }
+
+    void raw(const char* data, size_t n) { put(data, n); }
+
+    void str(const string& s) {
+        size_t n = s.size() < MAX_WIRE_STRING ? s.size() : MAX_WIRE_STRING;
+        u8((uint8_t)n);
+        put(s.data(), n);
+    }
+};
+
+class WireReader {
+private:
+    const char* p;
+    const char* end;
+    bool error;
+
+    bool take(void* into, size_t n) {
+        if((size_t)(end - p) < n) {
+            error = true;
+            return false;
+        }
+        memcpy(into, p, n);
+        p += n;
+        return true;
+    }
+
+public:
+    WireReader(const FrameView& frame) : p(frame.payload), end(frame.payload + frame.length), error(false) {}
+
+    uint8_t u8() { uint8_t v = 0; take(&v, 1); return v; }
+    uint16_t u16() { uint16_t v = 0; take(&v, 2); return v; }
+    uint32_t u32() { uint32_t v = 0; take(&v, 4); return v; }
+    int32_t i32() { int32_t v = 0; take(&v, 4); return v; }
+    int64_t i64() { int64_t v = 0; take(&v, 8); return v; }
+    uint64_t u64() { uint64_t v = 0; take(&v, 8); return v; }
+
+    string str() {
+        uint8_t n = u8();
+        if(error || (size_t)(end - p) < n) {
+            error = true;
+            return "";
+        }
+        string s(p, n);
+        p += n;
+        return s;
+    }
+
+    bool failed() const { return error; }
+};
+
+// One scorer's reading of a ball, as sent over the wire
+struct WireEntry {
+    uint32_t seq;
+    int32_t overNumber;
+    uint8_t ballNumber;
+    uint8_t outcome;
+    uint8_t wicketType;
+    uint8_t runs;
+    uint8_t extras;
+    int64_t timestamp;
+
+    WireEntry() : seq(0), overNumber(0), ballNumber(0), outcome(0), wicketType(0),
+                  runs(0), extras(0), timestamp(0) {}
+
+    void write(WireWriter& out) const {
+        out.begin(FRAME_ENTRY);
+        out.u32(seq);
+        out.i32(overNumber);
+        out.u8(ballNumber);
+        out.u8(outcome);
+        out.u8(wicketType);
+        out.u8(runs);
+        out.u8(extras);
+        out.i64(timestamp);
+        out.end();
+    }
+
+    bool read(WireReader& in) {
+        seq = in.u32();
+        overNumber = in.i32();
+        ballNumber = in.u8();
+        outcome = in.u8();
+        wicketType = in.u8();
+        runs = in.u8();
+        extras = in.u8();
+        timestamp = in.i64();
+        return !in.failed() && outcome <= (uint8_t)BallOutcome::WICKET_AND_RUNS &&
+               wicketType <= (uint8_t)WicketType::TIMED_OUT;
+    }
+
+    ScoreEntry toScoreEntry(const string& userId, const string& userName) const {
+        ScoreEntry e(userId, userName, overNumber, ballNumber, (BallOutcome)outcome,
+                     runs, extras, (WicketType)wicketType);
+        e.timestamp = (time_t)timestamp;
+        e.sequence = seq;
+        return e;
+    }
+};
+
+inline void writeHello(WireWriter& out, const string& userId, const string& userName, uint8_t flags) {
+    out.begin(FRAME_HELLO);
+    out.u8(flags);
+    out.str(userId);
+    out.str(userName);
+    out.end();
+}
+
+// Throttled acks carry a u32 retry-after in milliseconds
+inline void writeAck(WireWriter& out, uint32_t seq, WireAckStatus status, uint32_t retryAfterMs = 0) {
+    out.begin(FRAME_ACK);
+    out.u32(seq);
+    out.u8((uint8_t)status);
+    if(status == ACK_THROTTLED) out.u32(retryAfterMs);
+    out.end();
+}
+
+inline void writeUpdate(WireWriter& out, const MatchEvent& e) {
+    out.begin(FRAME_UPDATE);
+    out.u64(e.sequence);
+    out.u8((uint8_t)e.kind);
+    out.u8(e.inningsNumber);
+    out.i32(e.overNumber);
+    out.u8((uint8_t)e.ballNumber);
+    out.u8(e.outcome);
+    out.u8(e.wicketType);
+    out.u8((uint8_t)e.runs);
+    out.u8((uint8_t)e.extras);
+    out.i32(e.inningsRuns);
+    out.u8((uint8_t)e.inningsWickets);
+    out.u16((uint16_t)e.entryCount);
+    out.end();
+}
+
+inline bool readUpdate(WireReader& in, MatchEvent& e) {
+    e.sequence = in.u64();
+    e.kind = (MatchEventKind)in.u8();
+    e.inningsNumber = in.u8();
+    e.overNumber = in.i32();
+    e.ballNumber = in.u8();
+    e.outcome = in.u8();
+    e.wicketType = in.u8();
+    e.runs = in.u8();
+    e.extras = in.u8();
+    e.inningsRuns = in.i32();
+    e.inningsWickets = in.u8();
+    e.entryCount = in.u16();
+    return !in.failed();
+}
+
+#endif
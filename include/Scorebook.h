@@ -3,9 +3,15 @@
 
 #include "Match.h"
 #include "Officials.h"
+#include "EventBus.h"
+#include "ScorerReliability.h"
+#include "AdmissionControl.h"
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
+#include <algorithm>
 
 // Structure to hold a score entry from a user
 struct ScoreEntry {
@@ -18,15 +24,17 @@ struct ScoreEntry {
     int extras;
     WicketType wicketType;
     time_t timestamp;
+    uint64_t sequence;  // Scorer's own counter, from 1; 0 if the client does not number entries
     
     ScoreEntry() : userId(""), userName(""), overNumber(0), ballNumber(0),
                    outcome(BallOutcome::DOT_BALL), runs(0), extras(0),
-                   wicketType(WicketType::NONE), timestamp(time(0)) {}
+                   wicketType(WicketType::NONE), timestamp(time(0)), sequence(0) {}
     
     ScoreEntry(string uid, string uname, int over, int ball, BallOutcome out, 
-               int r, int ext, WicketType wType)
+               int r, int ext, WicketType wType, uint64_t seq = 0)
         : userId(uid), userName(uname), overNumber(over), ballNumber(ball),
-          outcome(out), runs(r), extras(ext), wicketType(wType), timestamp(time(0)) {}
+          outcome(out), runs(r), extras(ext), wicketType(wType), timestamp(time(0)),
+          sequence(seq) {}
     
     bool operator==(const ScoreEntry& other) const {
         return (overNumber == other.overNumber && 
@@ -97,6 +105,102 @@ struct Conflict {
     }
 };
 
+// Sequence numbers already seen from one scorer: the highest one plus a
+// bitmap of the 64 below it. Retries inside the window are caught exactly;
+// anything older than the window is treated as a retry too.
+struct SequenceWindow {
+    static const uint64_t SIZE = 64;
+    
+    uint64_t highest;
+    uint64_t seen;      // Bit i set: highest - i has arrived
+    
+    SequenceWindow() : highest(0), seen(0) {}
+    
+    // True the first time seq is offered
+    bool admit(uint64_t seq) {
+        if(seq > highest) {
+            uint64_t shift = seq - highest;
+            seen = shift >= SIZE ? 0 : seen << shift;
+            seen |= 1;
+            highest = seq;
+            return true;
+        }
+        uint64_t offset = highest - seq;
+        if(offset >= SIZE) return false;
+        uint64_t bit = 1ULL << offset;
+        if(seen & bit) return false;
+        seen |= bit;
+        return true;
+    }
+};
+
+// Receives the full detail of deliveries the scorebook compacts away
+class AuditSink {
+public:
+    virtual ~AuditSink() {}
+    // Every scorer's entry for a finalized ball, and its conflict if it had one
+    virtual void onFinalized(const vector<ScoreEntry>& entries, const Conflict* conflict) = 0;
+    // An entry for a ball that was already finalized
+    virtual void onLateEntry(const ScoreEntry& entry, bool agreed) = 0;
+    // A ruling that replaces the one a finalized ball was compacted with
+    virtual void onRulingReplaced(const Conflict& conflict) = 0;
+};
+
+// What remains in memory of a finalized ball: the agreed reading and how
+// many scorers gave it, so late entries can still be checked
+struct FinalizedBall {
+    uint8_t outcome;
+    uint8_t wicketType;
+    uint8_t runs;
+    uint8_t extras;
+    uint16_t scorers;
+    bool disputed;      // Settled by a supervisor ruling
+    
+    FinalizedBall() : outcome(0), wicketType(0), runs(0), extras(0), scorers(0), disputed(false) {}
+    
+    FinalizedBall(const ScoreEntry& agreed, size_t count, bool wasDisputed)
+        : outcome((uint8_t)agreed.outcome), wicketType((uint8_t)agreed.wicketType),
+          runs((uint8_t)agreed.runs), extras((uint8_t)agreed.extras),
+          scorers((uint16_t)count), disputed(wasDisputed) {}
+    
+    bool matches(const ScoreEntry& e) const {
+        return outcome == (uint8_t)e.outcome && wicketType == (uint8_t)e.wicketType &&
+               runs == e.runs && extras == e.extras;
+    }
+};
+
+// When balls are compacted. Off by default: every entry stays in memory.
+struct CompactionPolicy {
+    bool enabled;
+    int finalizeAfterOvers;     // Agreed or resolved balls this many overs behind the newest are compacted
+    int lateWindowOvers;        // Summaries kept this long for late entries; older entries only go to the audit
+    
+    CompactionPolicy(bool on = false, int finalizeAfter = 2, int lateWindow = 10)
+        : enabled(on), finalizeAfterOvers(finalizeAfter), lateWindowOvers(lateWindow) {}
+};
+
+struct ScorebookMemoryReport {
+    size_t liveEntries;
+    size_t liveBalls;
+    size_t openConflicts;
+    size_t finalizedSummaries;
+    uint64_t compactedBalls;
+    uint64_t compactedEntries;
+    uint64_t lateEntries;
+    size_t approxBytes;
+    
+    ScorebookMemoryReport() : liveEntries(0), liveBalls(0), openConflicts(0), finalizedSummaries(0),
+                              compactedBalls(0), compactedEntries(0), lateEntries(0), approxBytes(0) {}
+    
+    void display() const {
+        cout << "Scorebook memory: ~" << approxBytes / 1024 << " KB live (" << liveEntries
+             << " entries over " << liveBalls << " balls, " << openConflicts << " open conflicts, "
+             << finalizedSummaries << " finalized summaries)" << endl;
+        cout << "  Compacted: " << compactedEntries << " entries from " << compactedBalls
+             << " balls, " << lateEntries << " late entries" << endl;
+    }
+};
+
 // Main Scorebook class
 class Scorebook {
 private:
@@ -107,39 +211,265 @@ private:
     bool isNetworkSyncEnabled;
     int totalConflicts;
     int resolvedConflicts;
+    uint64_t duplicateEntries;
+    EventBus* eventBus;
+    // Entries and conflicts by ball, so each new entry only looks at its own ball
+    unordered_map<int64_t, vector<ScoreEntry>> entriesByBall;
+    unordered_map<int64_t, size_t> conflictByBall;   // Index into conflicts
+    unordered_map<string, SequenceWindow> sequenceWindows;  // userId -> retries filter
+    // Compaction of finalized balls
+    CompactionPolicy compaction;
+    AuditSink* auditSink;
+    unordered_map<int64_t, FinalizedBall> finalizedBalls;
+    int newestOver;
+    uint64_t compactedBalls;
+    uint64_t compactedEntries;
+    uint64_t lateEntries;
+    // Weighted voting and automatic rulings
+    ScorerReliability* reliability;
+    double autoResolveConfidence;
+    int autoResolvedConflicts;
+    // Entry rate limits
+    AdmissionControl* admission;
+    AdmissionVerdict lastAdmission;
+    uint64_t throttledEntries;
     
     // Helper function to generate ball key
-    string getBallKey(int over, int ball) const {
-        return to_string(over) + "." + to_string(ball);
+    static int64_t getBallKey(int over, int ball) {
+        return ((int64_t)over << 32) | (uint32_t)ball;
+    }
+    
+    static int getKeyOver(int64_t ballKey) {
+        return (int)(ballKey >> 32);
+    }
+    
+    // Heap bytes of an entry, counting strings too long for inline storage
+    static size_t entryBytes(const ScoreEntry& e) {
+        size_t bytes = sizeof(ScoreEntry);
+        if(e.userId.capacity() > 15) bytes += e.userId.capacity() + 1;
+        if(e.userName.capacity() > 15) bytes += e.userName.capacity() + 1;
+        return bytes;
+    }
+    
+    // An entry for a ball that is no longer live; true if it was handled here
+    bool handleLateEntry(const ScoreEntry& entry) {
+        int64_t ballKey = getBallKey(entry.overNumber, entry.ballNumber);
+        if(entriesByBall.count(ballKey)) return false;
+        auto finalized = finalizedBalls.find(ballKey);
+        if(finalized != finalizedBalls.end()) {
+            bool agreed = finalized->second.matches(entry);
+            lateEntries++;
+            if(auditSink) auditSink->onLateEntry(entry, agreed);
+            if(agreed) {
+                finalized->second.scorers++;
+            } else if(!finalized->second.disputed) {
+                reopenBall(ballKey, finalized->second, entry);
+            }
+            // A dissent on a ruled ball is audited; the ruling stands
+            return true;
+        }
+        if(entry.overNumber < newestOver - compaction.lateWindowOvers) {
+            lateEntries++;
+            if(auditSink) auditSink->onLateEntry(entry, false);
+            return true;
+        }
+        return false;
+    }
+    
+    // A ruling for a ball compaction already took out of memory replaces
+    // the summary left for late entries and is journaled after the old
+    // one. Past the late window only the journal is left to update.
+    bool applyCompactedResolution(int64_t ballKey, const ScoreEntry& correctEntry, const string& resolvedBy) {
+        if(!compaction.enabled) return false;
+        auto finalized = finalizedBalls.find(ballKey);
+        if(finalized == finalizedBalls.end()) {
+            if(getKeyOver(ballKey) >= newestOver - compaction.lateWindowOvers) return false;
+        } else {
+            if(finalized->second.disputed && finalized->second.matches(correctEntry)) return true;
+            finalized->second = FinalizedBall(correctEntry, finalized->second.scorers, true);
+        }
+        Conflict replacement(correctEntry.overNumber, correctEntry.ballNumber);
+        replacement.resolve(correctEntry, resolvedBy);
+        if(auditSink) auditSink->onRulingReplaced(replacement);
+        publishConflictEvent(MatchEventKind::RESOLUTION, replacement, &correctEntry);
+        return true;
+    }
+    
+    // Rulings teach the reliability model who was right. Confident
+    // automatic rulings count too: disputes left to supervisors are the
+    // hardest ones, and learning from those alone underrates everyone.
+    void learnFromRuling(int64_t ballKey, const ScoreEntry& correctEntry) {
+        if(!reliability) return;
+        for(const auto& e : entriesByBall[ballKey]) {
+            reliability->recordOutcome(e.userId, e == correctEntry);
+        }
+    }
+    
+    // Rule on an open conflict without a supervisor when the weighted vote is clear enough
+    void tryAutoResolve(int64_t ballKey) {
+        auto it = conflictByBall.find(ballKey);
+        if(it == conflictByBall.end()) return;
+        Conflict& conflict = conflicts[it->second];
+        if(conflict.isResolved) return;
+        
+        double confidence = 0;
+        ScoreEntry winner = resolveByWeightedVoting(conflict.overNumber, conflict.ballNumber, &confidence);
+        if(confidence < autoResolveConfidence) return;
+        
+        conflict.resolve(winner, "Auto (" + to_string((int)(confidence * 100)) + "% confidence)");
+        resolvedConflicts++;
+        autoResolvedConflicts++;
+        learnFromRuling(ballKey, winner);
+        publishConflictEvent(MatchEventKind::RESOLUTION, conflict, &winner, nullptr, EVENT_AUTOMATIC);
+    }
+    
+    // A late entry disagrees with a ball everyone had agreed on
+    void reopenBall(int64_t ballKey, const FinalizedBall& finalized, const ScoreEntry& dissent) {
+        ScoreEntry agreed("agreed", "Agreed by " + to_string(finalized.scorers) + " scorers",
+                          dissent.overNumber, dissent.ballNumber, (BallOutcome)finalized.outcome,
+                          finalized.runs, finalized.extras, (WicketType)finalized.wicketType);
+        finalizedBalls.erase(ballKey);
+        vector<ScoreEntry>& entries = entriesByBall[ballKey];
+        entries.push_back(agreed);
+        entries.push_back(dissent);
+        userEntries[dissent.userId].push_back(dissent);
+        raiseConflict(ballKey, dissent.overNumber, dissent.ballNumber);
+    }
+    
+    void raiseConflict(int64_t ballKey, int over, int ball) {
+        Conflict newConflict(over, ball);
+        for(auto& entry : entriesByBall[ballKey]) {
+            newConflict.addEntry(entry);
+        }
+        conflictByBall[ballKey] = conflicts.size();
+        conflicts.push_back(newConflict);
+        totalConflicts++;
+        publishConflictEvent(MatchEventKind::CONFLICT, newConflict, nullptr);
+        TRACE_COUNTER("open conflicts", totalConflicts - resolvedConflicts);
+    }
+    
+    // Tell bus subscribers about a new or resolved conflict. Console output
+    // is left to subscribers (ConsoleConflictLogger), off the scoring thread.
+    void publishConflictEvent(MatchEventKind kind, const Conflict& conflict, const ScoreEntry* entry,
+                              const Supervisor* by = nullptr, uint8_t flags = 0) {
+        if(!eventBus) return;
+        MatchEvent e;
+        e.kind = kind;
+        e.match = match;
+        e.timestamp = (int64_t)time(0);
+        e.overNumber = conflict.overNumber;
+        e.ballNumber = conflict.ballNumber;
+        e.entryCount = (int32_t)conflict.conflictingEntries.size();
+        e.supervisor = by;
+        e.flags = flags;
+        if(entry) {
+            e.outcome = (uint8_t)entry->outcome;
+            e.wicketType = (uint8_t)entry->wicketType;
+            e.runs = entry->runs;
+            e.extras = entry->extras;
+        }
+        eventBus->publish(e);
+    }
+    
+    void publishConsensus(const ScoreEntry& agreed, size_t scorers) {
+        MatchEvent e;
+        e.kind = MatchEventKind::CONSENSUS;
+        e.match = match;
+        e.timestamp = (int64_t)agreed.timestamp;
+        e.overNumber = agreed.overNumber;
+        e.ballNumber = agreed.ballNumber;
+        e.entryCount = (int32_t)scorers;
+        e.outcome = (uint8_t)agreed.outcome;
+        e.wicketType = (uint8_t)agreed.wicketType;
+        e.runs = agreed.runs;
+        e.extras = agreed.extras;
+        eventBus->publish(e);
     }
     
 public:
     Scorebook() : match(nullptr), supervisor(nullptr), 
-                  isNetworkSyncEnabled(true), totalConflicts(0), resolvedConflicts(0) {}
+                  isNetworkSyncEnabled(true), totalConflicts(0), resolvedConflicts(0),
+                  duplicateEntries(0), eventBus(nullptr), auditSink(nullptr), newestOver(0),
+                  compactedBalls(0), compactedEntries(0), lateEntries(0), reliability(nullptr),
+                  autoResolveConfidence(0), autoResolvedConflicts(0), admission(nullptr),
+                  lastAdmission(AdmissionVerdict::ADMITTED), throttledEntries(0) {}
     
     Scorebook(Match* m, Supervisor* sup)
         : match(m), supervisor(sup), isNetworkSyncEnabled(true),
-          totalConflicts(0), resolvedConflicts(0) {}
+          totalConflicts(0), resolvedConflicts(0), duplicateEntries(0), eventBus(nullptr),
+          auditSink(nullptr), newestOver(0), compactedBalls(0), compactedEntries(0), lateEntries(0),
+          reliability(nullptr), autoResolveConfidence(0), autoResolvedConflicts(0), admission(nullptr),
+          lastAdmission(AdmissionVerdict::ADMITTED), throttledEntries(0) {}
+    
+    // Compact finalized balls as play moves on, spilling detail to sink
+    void setCompaction(const CompactionPolicy& policy, AuditSink* sink = nullptr) {
+        compaction = policy;
+        auditSink = sink;
+    }
+    const CompactionPolicy& getCompaction() const { return compaction; }
+    
+    // Learn scorer accuracy from rulings; with a confidence above zero,
+    // conflicts whose weighted vote reaches it are ruled on automatically
+    void setReliabilityModel(ScorerReliability* model, double autoConfidence = 0) {
+        reliability = model;
+        autoResolveConfidence = autoConfidence;
+    }
+    ScorerReliability* getReliabilityModel() const { return reliability; }
+    
+    // Rate-limit scorer entries; nullptr admits everything
+    void setAdmissionControl(AdmissionControl* control) { admission = control; }
+    AdmissionControl* getAdmissionControl() const { return admission; }
     
-    void addScoreEntry(const ScoreEntry& entry) {
+    // Publish conflicts and resolutions to a bus (scoring thread only)
+    void setEventBus(EventBus* bus) { eventBus = bus; }
+    EventBus* getEventBus() const { return eventBus; }
+    
+    // Returns false for an entry that is dropped: a retransmission, or one
+    // refused by admission control (getLastAdmission says which)
+    bool addScoreEntry(const ScoreEntry& entry) {
+        TRACE_SPAN("Scorebook::addScoreEntry");
+        if(!admitEntry(entry)) return false;
+        mergeScoreEntry(entry);
+        return true;
+    }
+    
+    // Rate limits, then the retransmission check
+    bool admitEntry(const ScoreEntry& entry) {
+        lastAdmission = AdmissionVerdict::ADMITTED;
+        if(admission) {
+            lastAdmission = admission->admit(entry.userId);
+            if(lastAdmission != AdmissionVerdict::ADMITTED) {
+                throttledEntries++;
+                return false;
+            }
+        }
+        return admitSequence(entry);
+    }
+    
+    // Record an entry that was admitted elsewhere, such as at another replica
+    void mergeScoreEntry(const ScoreEntry& entry) {
+        if(compaction.enabled && handleLateEntry(entry)) return;
         userEntries[entry.userId].push_back(entry);
         checkForConflicts(entry);
+        if(entry.overNumber > newestOver) {
+            newestOver = entry.overNumber;
+            if(compaction.enabled) compactFinalized();
+        }
+    }
+    
+    // First sighting of this scorer's sequence number? Unnumbered entries always pass.
+    bool admitSequence(const ScoreEntry& entry) {
+        if(entry.sequence == 0) return true;
+        if(sequenceWindows[entry.userId].admit(entry.sequence)) return true;
+        duplicateEntries++;
+        return false;
     }
     
     void checkForConflicts(const ScoreEntry& newEntry) {
-        string ballKey = getBallKey(newEntry.overNumber, newEntry.ballNumber);
-        
-        // Check if any existing entry for this ball differs
-        vector<ScoreEntry> entriesForThisBall;
-        
-        for(auto& userPair : userEntries) {
-            for(auto& entry : userPair.second) {
-                if(entry.overNumber == newEntry.overNumber && 
-                   entry.ballNumber == newEntry.ballNumber) {
-                    entriesForThisBall.push_back(entry);
-                }
-            }
-        }
+        TRACE_SPAN("Scorebook::checkForConflicts");
+        int64_t ballKey = getBallKey(newEntry.overNumber, newEntry.ballNumber);
+        vector<ScoreEntry>& entriesForThisBall = entriesByBall[ballKey];
+        entriesForThisBall.push_back(newEntry);
         
         // If we have multiple entries, check if they agree
         if(entriesForThisBall.size() > 1) {
@@ -153,30 +483,58 @@ public:
             
             if(hasConflict) {
                 // Check if conflict already exists
-                bool conflictExists = false;
-                for(auto& conflict : conflicts) {
-                    if(conflict.overNumber == newEntry.overNumber &&
-                       conflict.ballNumber == newEntry.ballNumber) {
-                        conflictExists = true;
-                        break;
-                    }
-                }
-                
-                if(!conflictExists) {
-                    Conflict newConflict(newEntry.overNumber, newEntry.ballNumber);
-                    for(auto& entry : entriesForThisBall) {
-                        newConflict.addEntry(entry);
-                    }
-                    conflicts.push_back(newConflict);
-                    totalConflicts++;
-                    
-                    cout << "\n!!! CONFLICT DETECTED for ball " 
-                         << newEntry.overNumber << "." << newEntry.ballNumber << " !!!" << endl;
+                if(conflictByBall.count(ballKey) == 0) {
+                    raiseConflict(ballKey, newEntry.overNumber, newEntry.ballNumber);
                 }
+                // Every further entry may settle the vote
+                if(reliability && autoResolveConfidence > 0) tryAutoResolve(ballKey);
+            } else if(entriesForThisBall.size() == 2 && eventBus) {
+                publishConsensus(entriesForThisBall[0], 2);
             }
         }
     }
     
+    // Replace a scorer's earlier entry for the same ball (a replicated
+    // correction); adds the entry if the scorer had none for that ball
+    void replaceScoreEntry(const ScoreEntry& entry) {
+        int64_t ballKey = getBallKey(entry.overNumber, entry.ballNumber);
+        vector<ScoreEntry>& entriesForThisBall = entriesByBall[ballKey];
+        auto sameScorer = [&](const ScoreEntry& e) { return e.userId == entry.userId; };
+        auto it = find_if(entriesForThisBall.begin(), entriesForThisBall.end(), sameScorer);
+        if(it == entriesForThisBall.end()) {
+            mergeScoreEntry(entry);
+            return;
+        }
+        *it = entry;
+        
+        vector<ScoreEntry>& mine = userEntries[entry.userId];
+        for(auto e = mine.rbegin(); e != mine.rend(); ++e) {
+            if(e->overNumber == entry.overNumber && e->ballNumber == entry.ballNumber) {
+                *e = entry;
+                break;
+            }
+        }
+        
+        auto existing = conflictByBall.find(ballKey);
+        if(existing != conflictByBall.end()) {
+            vector<ScoreEntry>& listed = conflicts[existing->second].conflictingEntries;
+            auto c = find_if(listed.begin(), listed.end(), sameScorer);
+            if(c != listed.end()) *c = entry;
+            else listed.push_back(entry);
+            return;
+        }
+        for(const auto& e : entriesForThisBall) {
+            if(e != entriesForThisBall[0]) {
+                raiseConflict(ballKey, entry.overNumber, entry.ballNumber);
+                break;
+            }
+        }
+    }
+    
+    bool hasConflict(int over, int ball) const {
+        return conflictByBall.count(getBallKey(over, ball)) > 0;
+    }
+    
     void displayUnresolvedConflicts() const {
         cout << "\n========== UNRESOLVED CONFLICTS ==========" << endl;
         int unresolvedCount = 0;
@@ -207,52 +565,195 @@ public:
     }
     
     bool resolveConflict(int over, int ball, const ScoreEntry& correctEntry) {
-        for(auto& conflict : conflicts) {
-            if(conflict.overNumber == over && conflict.ballNumber == ball) {
-                if(!conflict.isResolved) {
-                    conflict.resolve(correctEntry, supervisor->getName());
-                    supervisor->resolveConflict();
-                    resolvedConflicts++;
-                    
-                    cout << "\n✓ Conflict for ball " << over << "." << ball 
-                         << " resolved by " << supervisor->getName() << endl;
-                    return true;
-                }
+        return resolveConflict(over, ball, correctEntry, supervisor);
+    }
+    
+    // Ruling by one of several supervisors on the match
+    bool resolveConflict(int over, int ball, const ScoreEntry& correctEntry, Supervisor* by) {
+        TRACE_SPAN("Scorebook::resolveConflict");
+        auto it = conflictByBall.find(getBallKey(over, ball));
+        if(it == conflictByBall.end()) return false;
+        Conflict& conflict = conflicts[it->second];
+        if(conflict.isResolved) return false;
+        
+        conflict.resolve(correctEntry, by->getName());
+        by->resolveConflict();
+        resolvedConflicts++;
+        learnFromRuling(it->first, correctEntry);
+        publishConflictEvent(MatchEventKind::RESOLUTION, conflict, &correctEntry, by);
+        TRACE_COUNTER("open conflicts", totalConflicts - resolvedConflicts);
+        return true;
+    }
+    
+    const Conflict* findConflict(int over, int ball) const {
+        auto it = conflictByBall.find(getBallKey(over, ball));
+        return it == conflictByBall.end() ? nullptr : &conflicts[it->second];
+    }
+    
+    // Apply a resolution made by a supervisor on another replica. A later
+    // ruling replaces an earlier one; false if the conflict is not known yet.
+    bool applyResolution(int over, int ball, const ScoreEntry& correctEntry, const string& resolvedBy) {
+        int64_t ballKey = getBallKey(over, ball);
+        auto it = conflictByBall.find(ballKey);
+        if(it == conflictByBall.end()) return applyCompactedResolution(ballKey, correctEntry, resolvedBy);
+        Conflict& conflict = conflicts[it->second];
+        // Already holds this ruling; nothing new to tell subscribers
+        if(conflict.isResolved && conflict.resolvedEntry == correctEntry && conflict.resolvedBy == resolvedBy) return true;
+        // Only the first ruling teaches the model; one that supersedes it is not a second lesson
+        if(!conflict.isResolved) {
+            resolvedConflicts++;
+            learnFromRuling(ballKey, correctEntry);
+        }
+        conflict.resolve(correctEntry, resolvedBy);
+        publishConflictEvent(MatchEventKind::RESOLUTION, conflict, &correctEntry);
+        TRACE_COUNTER("open conflicts", totalConflicts - resolvedConflicts);
+        return true;
+    }
+    
+    // Move agreed and resolved balls far enough behind play out of memory:
+    // their entries go to the audit sink and a FinalizedBall stays behind
+    // for late entries until it falls out of the late window. Open
+    // conflicts stay live however old they are. Returns balls compacted.
+    size_t compactFinalized() {
+        int finalizeBefore = newestOver - compaction.finalizeAfterOvers;
+        vector<int64_t> finished;
+        for(const auto& ball : entriesByBall) {
+            if(getKeyOver(ball.first) >= finalizeBefore || ball.second.empty()) continue;
+            auto c = conflictByBall.find(ball.first);
+            const Conflict* conflict = c == conflictByBall.end() ? nullptr : &conflicts[c->second];
+            if(conflict && !conflict->isResolved) continue;
+            
+            const ScoreEntry& agreed = conflict ? conflict->resolvedEntry : ball.second[0];
+            finalizedBalls[ball.first] = FinalizedBall(agreed, ball.second.size(), conflict != nullptr);
+            if(auditSink) auditSink->onFinalized(ball.second, conflict);
+            compactedEntries += ball.second.size();
+            finished.push_back(ball.first);
+        }
+        
+        if(!finished.empty()) {
+            unordered_set<int64_t> done(finished.begin(), finished.end());
+            for(auto& user : userEntries) {
+                vector<ScoreEntry>& entries = user.second;
+                entries.erase(remove_if(entries.begin(), entries.end(), [&](const ScoreEntry& e) {
+                    return done.count(getBallKey(e.overNumber, e.ballNumber)) > 0;
+                }), entries.end());
             }
+            for(auto key : finished) entriesByBall.erase(key);
+            
+            // Resolved conflicts now live in the audit; reindex the rest
+            vector<Conflict> open;
+            for(auto& conflict : conflicts) {
+                if(!done.count(getBallKey(conflict.overNumber, conflict.ballNumber))) open.push_back(conflict);
+            }
+            conflicts.swap(open);
+            conflictByBall.clear();
+            for(size_t i = 0; i < conflicts.size(); i++) {
+                conflictByBall[getBallKey(conflicts[i].overNumber, conflicts[i].ballNumber)] = i;
+            }
+            compactedBalls += finished.size();
         }
-        return false;
+        
+        // Slide the late-entry window
+        int expireBefore = newestOver - compaction.lateWindowOvers;
+        for(auto it = finalizedBalls.begin(); it != finalizedBalls.end();) {
+            if(getKeyOver(it->first) < expireBefore) it = finalizedBalls.erase(it);
+            else ++it;
+        }
+        return finished.size();
+    }
+    
+    ScorebookMemoryReport getMemoryReport() const {
+        ScorebookMemoryReport report;
+        for(const auto& user : userEntries) {
+            report.liveEntries += user.second.size();
+            for(const auto& e : user.second) report.approxBytes += entryBytes(e);
+        }
+        for(const auto& ball : entriesByBall) {
+            for(const auto& e : ball.second) report.approxBytes += entryBytes(e);
+        }
+        for(const auto& conflict : conflicts) {
+            if(!conflict.isResolved) report.openConflicts++;
+            report.approxBytes += sizeof(Conflict);
+            for(const auto& e : conflict.conflictingEntries) report.approxBytes += entryBytes(e);
+        }
+        // Hash nodes: key, value and two pointers
+        report.approxBytes += finalizedBalls.size() * (sizeof(int64_t) + sizeof(FinalizedBall) + 16);
+        report.approxBytes += conflictByBall.size() * (sizeof(int64_t) + sizeof(size_t) + 16);
+        report.approxBytes += sequenceWindows.size() * (sizeof(SequenceWindow) + 48);
+        report.liveBalls = entriesByBall.size();
+        report.finalizedSummaries = finalizedBalls.size();
+        report.compactedBalls = compactedBalls;
+        report.compactedEntries = compactedEntries;
+        report.lateEntries = lateEntries;
+        return report;
+    }
+    
+    void displayMemoryReport() const {
+        getMemoryReport().display();
+    }
+    
+    // Voting weighted by each scorer's record: every distinct reading of
+    // the ball scores the summed log-odds weights of the scorers who gave
+    // it. confidence receives the winner's share of the likelihood.
+    ScoreEntry resolveByWeightedVoting(int over, int ball, double* confidence = nullptr) const {
+        auto it = entriesByBall.find(getBallKey(over, ball));
+        if(confidence) *confidence = 0;
+        if(it == entriesByBall.end() || it->second.empty()) return ScoreEntry();
+        const vector<ScoreEntry>& entries = it->second;
+        
+        vector<const ScoreEntry*> readings;
+        vector<double> scores;
+        for(const auto& e : entries) {
+            double weight = reliability ? reliability->getWeight(e.userId) : 1.0;
+            size_t r = 0;
+            while(r < readings.size() && *readings[r] != e) r++;
+            if(r == readings.size()) {
+                readings.push_back(&e);
+                scores.push_back(0);
+            }
+            scores[r] += weight;
+        }
+        
+        size_t best = 0;
+        for(size_t r = 1; r < scores.size(); r++) {
+            if(scores[r] > scores[best]) best = r;
+        }
+        if(confidence) {
+            double total = 0;
+            for(double score : scores) total += exp(score - scores[best]);
+            *confidence = 1 / total;
+        }
+        return *readings[best];
     }
     
     // Voting mechanism - majority wins
     ScoreEntry resolveByVoting(int over, int ball) {
-        for(auto& conflict : conflicts) {
-            if(conflict.overNumber == over && conflict.ballNumber == ball) {
-                map<string, int> votes; // entry signature -> count
-                
-                for(const auto& entry : conflict.conflictingEntries) {
-                    string signature = to_string(entry.runs) + "_" + 
-                                     to_string(entry.extras) + "_" +
-                                     to_string((int)entry.outcome);
-                    votes[signature]++;
-                }
-                
-                // Find entry with most votes
-                int maxVotes = 0;
-                ScoreEntry mostVotedEntry;
-                for(const auto& entry : conflict.conflictingEntries) {
-                    string signature = to_string(entry.runs) + "_" + 
-                                     to_string(entry.extras) + "_" +
-                                     to_string((int)entry.outcome);
-                    if(votes[signature] > maxVotes) {
-                        maxVotes = votes[signature];
-                        mostVotedEntry = entry;
-                    }
-                }
-                
-                return mostVotedEntry;
+        auto it = conflictByBall.find(getBallKey(over, ball));
+        if(it == conflictByBall.end()) return ScoreEntry();
+        const Conflict& conflict = conflicts[it->second];
+        
+        map<string, int> votes; // entry signature -> count
+        for(const auto& entry : conflict.conflictingEntries) {
+            string signature = to_string(entry.runs) + "_" + 
+                             to_string(entry.extras) + "_" +
+                             to_string((int)entry.outcome);
+            votes[signature]++;
+        }
+        
+        // Find entry with most votes
+        int maxVotes = 0;
+        ScoreEntry mostVotedEntry;
+        for(const auto& entry : conflict.conflictingEntries) {
+            string signature = to_string(entry.runs) + "_" + 
+                             to_string(entry.extras) + "_" +
+                             to_string((int)entry.outcome);
+            if(votes[signature] > maxVotes) {
+                maxVotes = votes[signature];
+                mostVotedEntry = entry;
             }
         }
-        return ScoreEntry();
+        
+        return mostVotedEntry;
     }
     
     void displayScorebookSummary() const {
@@ -266,18 +767,40 @@ public:
                  << " - Entries: " << userPair.second.size() << endl;
         }
         
+        if(duplicateEntries > 0) {
+            cout << "  Retransmissions dropped: " << duplicateEntries << endl;
+        }
+        if(throttledEntries > 0) {
+            cout << "  Throttled by admission control: " << throttledEntries << endl;
+        }
+        
+        if(compactedEntries > 0) {
+            cout << "  Compacted to audit: " << compactedEntries << " entries from "
+                 << compactedBalls << " balls" << endl;
+        }
+        
         cout << "\nConflict Statistics:" << endl;
         cout << "  Total Conflicts: " << totalConflicts << endl;
         cout << "  Resolved: " << resolvedConflicts << endl;
+        if(autoResolvedConflicts > 0) {
+            cout << "  Auto-resolved: " << autoResolvedConflicts << endl;
+        }
         cout << "  Pending: " << (totalConflicts - resolvedConflicts) << endl;
         cout << "========================================" << endl;
     }
     
     // Getters
     Match* getMatch() const { return match; }
+    Supervisor* getSupervisor() const { return supervisor; }
     const vector<Conflict>& getConflicts() const { return conflicts; }
     int getTotalConflicts() const { return totalConflicts; }
     int getResolvedConflicts() const { return resolvedConflicts; }
+    uint64_t getDuplicateEntries() const { return duplicateEntries; }
+    uint64_t getThrottledEntries() const { return throttledEntries; }
+    AdmissionVerdict getLastAdmission() const { return lastAdmission; }
+    int getAutoResolvedConflicts() const { return autoResolvedConflicts; }
+    bool getIsNetworkSyncEnabled() const { return isNetworkSyncEnabled; }
+    void setNetworkSyncEnabled(bool enabled) { isNetworkSyncEnabled = enabled; }
     bool hasUnresolvedConflicts() const { 
         return resolvedConflicts < totalConflicts; 
     }
@@ -0,0 +1,182 @@
+#ifndef SCOREBOOKJOURNAL_H
+#define SCOREBOOKJOURNAL_H
+
+#include "ScoreWire.h"
+#include <fstream>
+#include <iterator>
+
+// Audit flags on journaled entries
+enum AuditEntryFlags {
+    AUDIT_LATE = 1,         // Arrived after its ball was finalized
+    AUDIT_DISSENT = 2       // Late, and disagreed with the finalized reading
+};
+
+// One record read back from a journal
+struct AuditRecord {
+    WireFrameType kind;     // FRAME_AUDIT_ENTRY or FRAME_AUDIT_RULING
+    uint8_t flags;          // Entries: AuditEntryFlags
+    ScoreEntry entry;       // The scorer's entry, or the ruled-correct entry
+    string resolvedBy;      // Rulings only
+    time_t resolutionTime;
+    uint16_t entryCount;    // Rulings: entries in the conflict
+
+    AuditRecord() : kind(FRAME_AUDIT_ENTRY), flags(0), resolutionTime(0), entryCount(0) {}
+};
+
+// Append-only audit file for a compacting Scorebook. Every entry of a
+// finalized ball is written as a frame in the scorer wire format,
+// followed by the ruling if the ball was disputed. A ruling that arrives
+// after compaction is appended as another AUDIT_RULING; the last one for
+// a ball stands. Frames are buffered and written in blocks.
+//
+//   AUDIT_ENTRY   flags u8, over i32, ball u8, outcome u8, wicket u8,
+//                 runs u8, extras u8, timestamp i64, sequence u64,
+//                 user id str, user name str
+//   AUDIT_RULING  over i32, ball u8, outcome u8, wicket u8, runs u8,
+//                 extras u8, resolution time i64, entry count u16,
+//                 resolved by str
+class ScorebookJournal : public AuditSink {
+public:
+    static const size_t FLUSH_BYTES = 64 * 1024;
+
+private:
+    ofstream file;
+    vector<char> pending;
+    uint64_t entriesWritten;
+    uint64_t rulingsWritten;
+    uint64_t bytesWritten;
+
+    void writeEntry(const ScoreEntry& e, uint8_t flags) {
+        WireWriter out(pending);
+        out.begin(FRAME_AUDIT_ENTRY);
+        out.u8(flags);
+        out.i32(e.overNumber);
+        out.u8((uint8_t)e.ballNumber);
+        out.u8((uint8_t)e.outcome);
+        out.u8((uint8_t)e.wicketType);
+        out.u8((uint8_t)e.runs);
+        out.u8((uint8_t)e.extras);
+        out.i64((int64_t)e.timestamp);
+        out.u64(e.sequence);
+        out.str(e.userId);
+        out.str(e.userName);
+        out.end();
+        entriesWritten++;
+    }
+
+    void writeRuling(const Conflict& c) {
+        const ScoreEntry& e = c.resolvedEntry;
+        WireWriter out(pending);
+        out.begin(FRAME_AUDIT_RULING);
+        out.i32(c.overNumber);
+        out.u8((uint8_t)c.ballNumber);
+        out.u8((uint8_t)e.outcome);
+        out.u8((uint8_t)e.wicketType);
+        out.u8((uint8_t)e.runs);
+        out.u8((uint8_t)e.extras);
+        out.i64((int64_t)c.resolutionTime);
+        out.u16((uint16_t)c.conflictingEntries.size());
+        out.str(c.resolvedBy);
+        out.end();
+        rulingsWritten++;
+    }
+
+    void maybeFlush() {
+        if(pending.size() >= FLUSH_BYTES) flush();
+    }
+
+public:
+    ScorebookJournal() : entriesWritten(0), rulingsWritten(0), bytesWritten(0) {}
+    ~ScorebookJournal() { close(); }
+
+    // No copies: owns the file
+    ScorebookJournal(const ScorebookJournal&) = delete;
+    ScorebookJournal& operator=(const ScorebookJournal&) = delete;
+
+    bool open(const string& path) {
+        file.open(path.c_str(), ios::binary | ios::app);
+        return file.is_open();
+    }
+
+    void close() {
+        flush();
+        if(file.is_open()) file.close();
+    }
+
+    void flush() {
+        if(pending.empty() || !file.is_open()) return;
+        file.write(pending.data(), pending.size());
+        file.flush();
+        bytesWritten += pending.size();
+        pending.clear();
+    }
+
+    void onFinalized(const vector<ScoreEntry>& entries, const Conflict* conflict) override {
+        for(const auto& e : entries) writeEntry(e, 0);
+        if(conflict) writeRuling(*conflict);
+        maybeFlush();
+    }
+
+    void onLateEntry(const ScoreEntry& entry, bool agreed) override {
+        writeEntry(entry, agreed ? AUDIT_LATE : AUDIT_LATE | AUDIT_DISSENT);
+        maybeFlush();
+    }
+
+    void onRulingReplaced(const Conflict& conflict) override {
+        writeRuling(conflict);
+        maybeFlush();
+    }
+
+    // Call fn(const AuditRecord&) for every record in a journal file
+    template<typename Fn>
+    static bool replay(const string& path, Fn fn) {
+        ifstream in(path.c_str(), ios::binary);
+        if(!in.is_open()) return false;
+        vector<char> data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+        size_t offset = 0;
+        FrameView frame;
+        long taken;
+        while((taken = parseFrame(data.data() + offset, data.size() - offset, frame)) > 0) {
+            offset += (size_t)taken;
+            WireReader r(frame);
+            AuditRecord record;
+            record.kind = (WireFrameType)frame.type;
+            ScoreEntry& e = record.entry;
+            if(frame.type == FRAME_AUDIT_ENTRY) {
+                record.flags = r.u8();
+                e.overNumber = r.i32();
+                e.ballNumber = r.u8();
+                e.outcome = (BallOutcome)r.u8();
+                e.wicketType = (WicketType)r.u8();
+                e.runs = r.u8();
+                e.extras = r.u8();
+                e.timestamp = (time_t)r.i64();
+                e.sequence = r.u64();
+                e.userId = r.str();
+                e.userName = r.str();
+            } else if(frame.type == FRAME_AUDIT_RULING) {
+                e.overNumber = r.i32();
+                e.ballNumber = r.u8();
+                e.outcome = (BallOutcome)r.u8();
+                e.wicketType = (WicketType)r.u8();
+                e.runs = r.u8();
+                e.extras = r.u8();
+                record.resolutionTime = (time_t)r.i64();
+                record.entryCount = r.u16();
+                record.resolvedBy = r.str();
+            } else {
+                return false;
+            }
+            if(r.failed()) return false;
+            fn(record);
+        }
+        return taken == 0 && offset == data.size();
+    }
+
+    uint64_t getEntriesWritten() const { return entriesWritten; }
+    uint64_t getRulingsWritten() const { return rulingsWritten; }
+    uint64_t getBytesWritten() const { return bytesWritten + pending.size(); }
+};
+
+#endif
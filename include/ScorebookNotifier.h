@@ -0,0 +1,167 @@
+#ifndef SCOREBOOKNOTIFIER_H
+#define SCOREBOOKNOTIFIER_H
+
+#include "EventBus.h"
+#include <vector>
+#include <chrono>
+
+// Two or more scorers disagree on a ball
+struct ConflictDetected {
+    const Match* match;
+    int overNumber;
+    int ballNumber;
+    int entryCount;
+    int64_t timestamp;
+};
+
+// A disputed ball has a ruling
+struct ConflictResolved {
+    const Match* match;
+    int overNumber;
+    int ballNumber;
+    BallOutcome outcome;
+    WicketType wicketType;
+    int runs;
+    int extras;
+    const Supervisor* supervisor;   // nullptr for automatic and replicated rulings
+    bool automatic;
+    int64_t timestamp;
+};
+
+// The scorers of a ball agree, so far with no dissent
+struct ConsensusReached {
+    const Match* match;
+    int overNumber;
+    int ballNumber;
+    BallOutcome outcome;
+    WicketType wicketType;
+    int runs;
+    int extras;
+    int scorers;
+    int64_t timestamp;
+};
+
+// Override the notifications of interest; all run on the notifier's thread
+class ScorebookListener {
+public:
+    virtual ~ScorebookListener() {}
+    virtual void onConflictDetected(const ConflictDetected&) {}
+    virtual void onConflictResolved(const ConflictResolved&) {}
+    virtual void onConsensusReached(const ConsensusReached&) {}
+};
+
+// The scorebook's old console messages, as a subscriber
+class ConsoleConflictLogger : public ScorebookListener {
+private:
+    ostream& out;
+
+public:
+    ConsoleConflictLogger(ostream& stream = cout) : out(stream) {}
+
+    void onConflictDetected(const ConflictDetected& e) override {
+        out << "\n!!! CONFLICT DETECTED for ball " << e.overNumber << "." << e.ballNumber << " !!!" << endl;
+    }
+
+    void onConflictResolved(const ConflictResolved& e) override {
+        out << "\n✓ Conflict for ball " << e.overNumber << "." << e.ballNumber;
+        if(e.automatic) out << " auto-resolved by weighted vote" << endl;
+        else if(e.supervisor) out << " resolved by " << e.supervisor->getName() << endl;
+        else out << " resolved at another replica" << endl;
+    }
+};
+
+// Delivers a Scorebook's conflict events to typed listeners on a thread
+// of its own, so handlers (and the console) never hold up ingestion. It
+// reads the scorebook's EventBus through one cursor; with the default
+// DROP policy a listener that falls a full ring behind misses events
+// rather than stalling the scoring thread, and BLOCK trades that for
+// never missing one. Add listeners before start().
+class ScorebookNotifier {
+private:
+    EventBus& bus;
+    EventCursor* cursor;
+    vector<ScorebookListener*> listeners;
+    thread worker;
+    atomic<bool> stopRequested;
+    atomic<uint64_t> delivered;
+
+    void dispatch(const MatchEvent& e) {
+        if(e.kind == MatchEventKind::CONFLICT) {
+            ConflictDetected n = {e.match, e.overNumber, e.ballNumber, e.entryCount, e.timestamp};
+            for(auto l : listeners) l->onConflictDetected(n);
+        } else if(e.kind == MatchEventKind::RESOLUTION) {
+            ConflictResolved n = {e.match, e.overNumber, e.ballNumber, (BallOutcome)e.outcome,
+                                  (WicketType)e.wicketType, e.runs, e.extras, e.supervisor,
+                                  (e.flags & EVENT_AUTOMATIC) != 0, e.timestamp};
+            for(auto l : listeners) l->onConflictResolved(n);
+        } else if(e.kind == MatchEventKind::CONSENSUS) {
+            ConsensusReached n = {e.match, e.overNumber, e.ballNumber, (BallOutcome)e.outcome,
+                                  (WicketType)e.wicketType, e.runs, e.extras, e.entryCount, e.timestamp};
+            for(auto l : listeners) l->onConsensusReached(n);
+        } else {
+            return;
+        }
+        delivered.fetch_add(1, memory_order_relaxed);
+    }
+
+    // Spin briefly when idle, then sleep, so a quiet match costs no CPU
+    void run() {
+        int idle = 0;
+        while(!stopRequested.load(memory_order_acquire)) {
+            if(pollOnce() > 0) {
+                idle = 0;
+            } else if(++idle < 64) {
+                this_thread::yield();
+            } else {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        }
+        pollOnce();
+    }
+
+public:
+    ScorebookNotifier(EventBus& eventBus, SlowConsumerPolicy policy = SlowConsumerPolicy::DROP)
+        : bus(eventBus), cursor(eventBus.subscribe("scorebook notifier", policy)),
+          stopRequested(false), delivered(0) {}
+
+    ~ScorebookNotifier() {
+        stop();
+        bus.unsubscribe(cursor);
+    }
+
+    // No copies: owns a thread
+    ScorebookNotifier(const ScorebookNotifier&) = delete;
+    ScorebookNotifier& operator=(const ScorebookNotifier&) = delete;
+
+    void addListener(ScorebookListener* listener) { listeners.push_back(listener); }
+
+    void start() {
+        if(worker.joinable() || !cursor) return;
+        stopRequested.store(false, memory_order_release);
+        worker = thread([this]() { run(); });
+    }
+
+    // Deliver what is pending, then stop the thread
+    void stop() {
+        stopRequested.store(true, memory_order_release);
+        if(worker.joinable()) worker.join();
+    }
+
+    // Deliver pending events on the caller's thread; for use without start()
+    size_t pollOnce() {
+        if(!cursor) return 0;
+        return bus.poll(*cursor, [this](const MatchEvent& e) { dispatch(e); });
+    }
+
+    // Wait until every event published so far has been handled
+    void waitUntilIdle() const {
+        if(!cursor) return;
+        uint64_t target = bus.getPublished();
+        while(cursor->getNext() < target && worker.joinable()) this_thread::yield();
+    }
+
+    uint64_t getDelivered() const { return delivered.load(memory_order_relaxed); }
+    uint64_t getDropped() const { return cursor ? cursor->getDropped() : 0; }
+};
+
+#endif
@@ -0,0 +1,527 @@
+#ifndef SCOREBOOKREPLICA_H
+#define SCOREBOOKREPLICA_H
+
+#include "ScoreWire.h"
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <set>
+
+// ---------------------------------------------------------------------------
+// Replica sync between scorebooks
+//
+// Each replica keeps an append-only log of the operations it originated
+// (scorer entries it received and resolutions its supervisor made). A
+// record is identified by (origin replica, counter), and a replica's
+// version vector holds, per origin, how many of that origin's records it
+// has applied. Records are always applied in counter order, so the vector
+// describes exactly what a replica has seen.
+//
+// The merged state is two last-writer-wins maps:
+//   (scorer, over, ball) -> that scorer's entry for the ball
+//   (over, ball)         -> the supervisor ruling for the ball
+// ordered by (timestamp, origin, counter). Every replica that has applied
+// the same records ends up with the same maps, whatever the order.
+//
+// Anti-entropy: a replica sends its version vector (SYNC_DIGEST); the
+// peer answers with only the records past that vector (SYNC_RECORDS),
+// and with its own digest if the sender has records it lacks. A vector
+// too big for one frame is split by origin; each frame says which range
+// of origins it covers, so the peer can answer it on its own.
+// ---------------------------------------------------------------------------
+
+enum class SyncRecordKind : uint8_t {
+    ENTRY = 1,
+    RESOLUTION = 2
+};
+
+struct SyncRecord {
+    SyncRecordKind kind;
+    ScoreEntry entry;       // The scorer's entry, or the ruled-correct entry
+    string resolvedBy;      // Resolutions only
+
+    SyncRecord() : kind(SyncRecordKind::ENTRY) {}
+    SyncRecord(SyncRecordKind k, const ScoreEntry& e, const string& by = "")
+        : kind(k), entry(e), resolvedBy(by) {}
+};
+
+// Total order used to pick the winner between concurrent writes
+struct SyncStamp {
+    int64_t timestamp;
+    string origin;
+    uint64_t counter;
+
+    SyncStamp() : timestamp(0), counter(0) {}
+    SyncStamp(int64_t t, const string& o, uint64_t c) : timestamp(t), origin(o), counter(c) {}
+
+    bool operator<(const SyncStamp& other) const {
+        if(timestamp != other.timestamp) return timestamp < other.timestamp;
+        if(origin != other.origin) return origin < other.origin;
+        return counter < other.counter;
+    }
+};
+
+struct ReplicaStats {
+    uint64_t recordsSent;
+    uint64_t recordsApplied;
+    uint64_t duplicatesSkipped;     // Already covered by the version vector
+    uint64_t gapsSkipped;           // Arrived ahead of an earlier record; resent later
+    uint64_t digestsSent;
+    uint64_t bytesSent;
+
+    ReplicaStats() : recordsSent(0), recordsApplied(0), duplicatesSkipped(0), gapsSkipped(0),
+                     digestsSent(0), bytesSent(0) {}
+};
+
+// One scorebook taking part in replica sync. All local scoring goes
+// through the replica so it can be logged; remote records are applied to
+// the scorebook as they are merged.
+class ScorebookReplica {
+private:
+    struct Winner {
+        SyncStamp stamp;
+        SyncRecord record;
+    };
+
+    string replicaId;
+    Scorebook& scorebook;
+    map<string, vector<SyncRecord>> logs;           // Origin -> its records, counter = index + 1
+    unordered_map<string, Winner> entries;          // Scorer and ball -> winning entry
+    unordered_map<int64_t, Winner> resolutions;     // Ball -> winning ruling
+    set<int64_t> pendingResolutions;                // Rulings for conflicts not seen here yet
+    ReplicaStats stats;
+
+    static int64_t getBallKey(int over, int ball) {
+        return ((int64_t)over << 32) | (uint32_t)ball;
+    }
+
+    static string getEntryKey(const ScoreEntry& e) {
+        return e.userId + '\0' + to_string(e.overNumber) + '.' + to_string(e.ballNumber);
+    }
+
+    // Try to hand a winning ruling to the scorebook
+    void applyResolutionToScorebook(int64_t ballKey) {
+        const Winner& w = resolutions[ballKey];
+        const ScoreEntry& e = w.record.entry;
+        if(scorebook.applyResolution(e.overNumber, e.ballNumber, e, w.record.resolvedBy)) {
+            pendingResolutions.erase(ballKey);
+        } else {
+            pendingResolutions.insert(ballKey);
+        }
+    }
+
+    void merge(const string& origin, uint64_t counter, const SyncRecord& record) {
+        SyncStamp stamp((int64_t)record.entry.timestamp, origin, counter);
+        const ScoreEntry& e = record.entry;
+        if(record.kind == SyncRecordKind::ENTRY) {
+            string key = getEntryKey(e);
+            auto it = entries.find(key);
+            // Retries were filtered where the entry arrived; the key dedupes here
+            ScoreEntry merged = e;
+            merged.sequence = 0;
+            if(it == entries.end()) {
+                Winner& w = entries[key];
+                w.stamp = stamp;
+                w.record = record;
+                scorebook.mergeScoreEntry(merged);
+            } else if(it->second.stamp < stamp) {
+                bool changed = it->second.record.entry != e;
+                it->second.stamp = stamp;
+                it->second.record = record;
+                if(changed) scorebook.replaceScoreEntry(merged);
+            }
+            int64_t ballKey = getBallKey(e.overNumber, e.ballNumber);
+            if(pendingResolutions.count(ballKey)) applyResolutionToScorebook(ballKey);
+        } else {
+            int64_t ballKey = getBallKey(e.overNumber, e.ballNumber);
+            auto it = resolutions.find(ballKey);
+            if(it != resolutions.end() && !(it->second.stamp < stamp)) {
+                // A local ruling that loses is taken back off the scorebook
+                if(origin == replicaId) applyResolutionToScorebook(ballKey);
+                return;
+            }
+            Winner& w = resolutions[ballKey];
+            w.stamp = stamp;
+            w.record = record;
+            // Our own rulings were made on the scorebook before they were logged
+            if(origin != replicaId) applyResolutionToScorebook(ballKey);
+        }
+    }
+
+    // Append to our own log and merge locally
+    void originate(const SyncRecord& record) {
+        vector<SyncRecord>& log = logs[replicaId];
+        log.push_back(record);
+        merge(replicaId, log.size(), record);
+        stats.recordsApplied++;
+    }
+
+    static size_t strSize(const string& s) { return 1 + min(s.size(), MAX_WIRE_STRING); }
+
+    // Bytes writeRecord takes for r
+    static size_t encodedSize(const SyncRecord& r) {
+        size_t n = 18 + strSize(r.entry.userId) + strSize(r.entry.userName);
+        if(r.kind == SyncRecordKind::RESOLUTION) n += strSize(r.resolvedBy);
+        return n;
+    }
+
+    // SYNC_RECORDS payload ahead of the records: origin, first counter, count
+    static size_t recordsHeaderSize(const string& origin) { return strSize(origin) + 8 + 2; }
+
+    // A record of ours must go whole into a SYNC_RECORDS frame on its own,
+    // or no peer could ever take it and sync with us would stop at it
+    bool fitsFrame(const SyncRecord& r) const {
+        const ScoreEntry& e = r.entry;
+        if(e.userId.size() > MAX_WIRE_STRING || e.userName.size() > MAX_WIRE_STRING ||
+           r.resolvedBy.size() > MAX_WIRE_STRING) return false;
+        return recordsHeaderSize(replicaId) + encodedSize(r) <= MAX_FRAME_PAYLOAD;
+    }
+
+    static void writeRecord(WireWriter& out, const SyncRecord& r) {
+        const ScoreEntry& e = r.entry;
+        out.u8((uint8_t)r.kind);
+        out.i32(e.overNumber);
+        out.u8((uint8_t)e.ballNumber);
+        out.u8((uint8_t)e.outcome);
+        out.u8((uint8_t)e.wicketType);
+        out.u8((uint8_t)e.runs);
+        out.u8((uint8_t)e.extras);
+        out.i64((int64_t)e.timestamp);
+        out.str(e.userId);
+        out.str(e.userName);
+        if(r.kind == SyncRecordKind::RESOLUTION) out.str(r.resolvedBy);
+    }
+
+    static bool readRecord(WireReader& in, SyncRecord& r) {
+        ScoreEntry& e = r.entry;
+        r.kind = (SyncRecordKind)in.u8();
+        e.overNumber = in.i32();
+        e.ballNumber = in.u8();
+        e.outcome = (BallOutcome)in.u8();
+        e.wicketType = (WicketType)in.u8();
+        e.runs = in.u8();
+        e.extras = in.u8();
+        e.timestamp = (time_t)in.i64();
+        e.userId = in.str();
+        e.userName = in.str();
+        r.resolvedBy = r.kind == SyncRecordKind::RESOLUTION ? in.str() : "";
+        return !in.failed() && (r.kind == SyncRecordKind::ENTRY || r.kind == SyncRecordKind::RESOLUTION);
+    }
+
+    // SYNC_DIGEST flags: the frame's origin range is open at that end
+    static const uint8_t DIGEST_FROM_START = 1;
+    static const uint8_t DIGEST_TO_END = 2;
+
+    // SYNC_DIGEST payload ahead of the origins: sender, flags, range start, count
+    size_t digestHeaderSize(const string* after) const {
+        return strSize(replicaId) + 1 + (after ? strSize(*after) : 0) + 2;
+    }
+
+    // Every record past the peer's version vector, in runs per origin,
+    // for the origins after 'after' up to and including 'upTo' (null for
+    // an open end)
+    void writeDelta(WireWriter& out, const map<string, uint64_t>& peer,
+                    const string* after, const string* upTo) {
+        auto begin = after ? logs.upper_bound(*after) : logs.begin();
+        auto end = upTo ? logs.upper_bound(*upTo) : logs.end();
+        for(auto it = begin; it != end; ++it) {
+            const auto& log = *it;
+            auto seen = peer.find(log.first);
+            uint64_t from = seen == peer.end() ? 0 : seen->second;
+            uint64_t to = log.second.size();
+            size_t header = recordsHeaderSize(log.first);
+            while(from < to) {
+                // SYNC_RECORDS: origin, first counter, count, records
+                out.begin(FRAME_SYNC_RECORDS);
+                out.str(log.first);
+                out.u64(from + 1);
+                vector<char> records;
+                WireWriter body(records);
+                uint16_t count = 0;
+                // Fill up to the peer's frame limit; every record fits alone
+                while(from < to && (count == 0 || header + records.size() +
+                                    encodedSize(log.second[from]) <= MAX_FRAME_PAYLOAD)) {
+                    writeRecord(body, log.second[from++]);
+                    count++;
+                }
+                out.u16(count);
+                out.raw(records.data(), records.size());
+                out.end();
+                stats.recordsSent += count;
+            }
+        }
+    }
+
+    void handleRecords(WireReader& in) {
+        string origin = in.str();
+        uint64_t counter = in.u64();
+        uint16_t count = in.u16();
+        if(in.failed()) return;
+        vector<SyncRecord>& log = logs[origin];
+        for(uint16_t i = 0; i < count; i++, counter++) {
+            SyncRecord record;
+            if(!readRecord(in, record)) return;
+            if(counter <= log.size()) {
+                stats.duplicatesSkipped++;
+            } else if(counter > log.size() + 1) {
+                stats.gapsSkipped++;
+            } else {
+                log.push_back(record);
+                merge(origin, counter, record);
+                stats.recordsApplied++;
+            }
+        }
+    }
+
+public:
+    // Ids are cut to the wire limit, as every frame would carry them cut
+    ScorebookReplica(const string& id, Scorebook& book)
+        : replicaId(id.substr(0, MAX_WIRE_STRING)), scorebook(book) {}
+
+    // No copies: the logs are the replica's identity
+    ScorebookReplica(const ScorebookReplica&) = delete;
+    ScorebookReplica& operator=(const ScorebookReplica&) = delete;
+
+    // A scorer's entry received at this replica; false for a retransmission,
+    // an entry refused by the scorebook's admission control, or one whose
+    // names are too long to replicate
+    bool addScoreEntry(const ScoreEntry& entry) {
+        SyncRecord record(SyncRecordKind::ENTRY, entry);
+        if(!fitsFrame(record) || !scorebook.admitEntry(entry)) return false;
+        originate(record);
+        return true;
+    }
+
+    // This replica's supervisor rules on a conflict
+    bool resolveConflict(int over, int ball, const ScoreEntry& correctEntry) {
+        ScoreEntry ruling = correctEntry;
+        ruling.overNumber = over;
+        ruling.ballNumber = ball;
+        ruling.timestamp = time(0);
+        Supervisor* supervisor = scorebook.getSupervisor();
+        SyncRecord record(SyncRecordKind::RESOLUTION, ruling, supervisor ? supervisor->getName() : replicaId);
+        if(!fitsFrame(record) || !scorebook.resolveConflict(over, ball, correctEntry)) return false;
+        originate(record);
+        return true;
+    }
+
+    map<string, uint64_t> getVersionVector() const {
+        map<string, uint64_t> versions;
+        for(const auto& log : logs) versions[log.first] = log.second.size();
+        return versions;
+    }
+
+    // Start an anti-entropy exchange with a peer. Origins go out in order,
+    // as many per frame as fit; a frame's range runs from just after the
+    // last origin of the previous frame to its own last origin.
+    void writeDigest(vector<char>& out) {
+        WireWriter writer(out);
+        size_t before = out.size();
+        auto log = logs.begin();
+        const string* after = nullptr;
+        do {
+            size_t size = digestHeaderSize(after);
+            auto last = log;
+            uint16_t count = 0;
+            // One origin always fits: both strings are cut to the wire limit
+            while(last != logs.end() &&
+                  size + strSize(last->first) + 8 <= MAX_FRAME_PAYLOAD) {
+                size += strSize(last->first) + 8;
+                ++last;
+                count++;
+            }
+            uint8_t flags = (after ? 0 : DIGEST_FROM_START) | (last == logs.end() ? DIGEST_TO_END : 0);
+            writer.begin(FRAME_SYNC_DIGEST);
+            writer.str(replicaId);
+            writer.u8(flags);
+            if(after) writer.str(*after);
+            writer.u16(count);
+            for(; log != last; ++log) {
+                writer.str(log->first);
+                writer.u64(log->second.size());
+                after = &log->first;
+            }
+            writer.end();
+        } while(log != logs.end());
+        stats.digestsSent++;
+        stats.bytesSent += out.size() - before;
+    }
+
+    // Handle a message from a peer; anything to send back goes to reply
+    bool receive(const vector<char>& message, vector<char>& reply) {
+        size_t offset = 0;
+        size_t before = reply.size();
+        FrameView frame;
+        long taken;
+        bool behind = false;
+        while((taken = parseFrame(message.data() + offset, message.size() - offset, frame)) > 0) {
+            offset += (size_t)taken;
+            WireReader in(frame);
+            if(frame.type == FRAME_SYNC_RECORDS) {
+                handleRecords(in);
+            } else if(frame.type == FRAME_SYNC_DIGEST) {
+                in.str();
+                uint8_t flags = in.u8();
+                string after = flags & DIGEST_FROM_START ? "" : in.str();
+                map<string, uint64_t> peer;
+                uint16_t origins = in.u16();
+                for(uint16_t i = 0; i < origins && !in.failed(); i++) {
+                    string origin = in.str();
+                    peer[origin] = in.u64();
+                }
+                if(in.failed()) return false;
+
+                // Answer for the origins this frame covers, listed or not
+                bool toEnd = (flags & DIGEST_TO_END) != 0;
+                if(!toEnd && peer.empty()) continue;
+                string upTo = toEnd ? "" : peer.rbegin()->first;
+                WireWriter out(reply);
+                writeDelta(out, peer, flags & DIGEST_FROM_START ? nullptr : &after, toEnd ? nullptr : &upTo);
+                for(const auto& p : peer) {
+                    auto mine = logs.find(p.first);
+                    if(p.second > (mine == logs.end() ? 0 : mine->second.size())) behind = true;
+                }
+            }
+        }
+        stats.bytesSent += reply.size() - before;
+        // One digest back however many frames the peer's took
+        if(behind) writeDigest(reply);
+        return taken == 0 && offset == message.size();
+    }
+
+    // Order-independent fingerprint of the merged state; equal on converged replicas
+    uint64_t getStateHash() const {
+        auto mix = [](uint64_t h, const string& s) {
+            for(unsigned char c : s) h = (h ^ c) * 1099511628211ULL;
+            return h;
+        };
+        auto recordHash = [&](const SyncRecord& r) {
+            const ScoreEntry& e = r.entry;
+            uint64_t h = 14695981039346656037ULL;
+            h = mix(h, e.userId);
+            h = mix(h, to_string(e.overNumber) + '.' + to_string(e.ballNumber) + ':' +
+                       to_string((int)e.outcome) + ',' + to_string(e.runs) + ',' +
+                       to_string(e.extras) + ',' + to_string((int)e.wicketType));
+            return mix(h, r.resolvedBy);
+        };
+        uint64_t hash = 0;
+        for(const auto& e : entries) hash += recordHash(e.second.record);
+        for(const auto& r : resolutions) hash += recordHash(r.second.record) * 31;
+        return hash;
+    }
+
+    void displayStatus() const {
+        cout << "Replica " << replicaId << ": " << entries.size() << " entries, "
+             << resolutions.size() << " rulings, version {";
+        bool first = true;
+        for(const auto& log : logs) {
+            cout << (first ? "" : ", ") << log.first << ":" << log.second.size();
+            first = false;
+        }
+        cout << "}, " << stats.recordsSent << " records sent, " << stats.duplicatesSkipped
+             << " duplicates, " << stats.gapsSkipped << " gaps" << endl;
+    }
+
+    const string& getReplicaId() const { return replicaId; }
+    Scorebook& getScorebook() const { return scorebook; }
+    const ReplicaStats& getStats() const { return stats; }
+    size_t getEntryCount() const { return entries.size(); }
+    size_t getResolutionCount() const { return resolutions.size(); }
+    size_t getPendingResolutionCount() const { return pendingResolutions.size(); }
+};
+
+// Runs replicas in one process over an in-memory transport. Links can be
+// cut and healed to simulate partitions; messages sent across a cut link
+// are lost, as they would be on a real network.
+class ReplicaNetwork {
+private:
+    struct Message {
+        size_t from;
+        size_t to;
+        vector<char> bytes;
+    };
+
+    vector<ScorebookReplica*> replicas;
+    set<pair<size_t, size_t>> cutLinks;
+    deque<Message> inFlight;
+    uint64_t messagesDelivered;
+    uint64_t messagesLost;
+    uint64_t bytesDelivered;
+
+    static pair<size_t, size_t> link(size_t a, size_t b) {
+        return a < b ? make_pair(a, b) : make_pair(b, a);
+    }
+
+public:
+    ReplicaNetwork() : messagesDelivered(0), messagesLost(0), bytesDelivered(0) {}
+
+    size_t addReplica(ScorebookReplica* replica) {
+        replicas.push_back(replica);
+        return replicas.size() - 1;
+    }
+
+    void partition(size_t a, size_t b) { cutLinks.insert(link(a, b)); }
+    void heal(size_t a, size_t b) { cutLinks.erase(link(a, b)); }
+    void healAll() { cutLinks.clear(); }
+    bool isConnected(size_t a, size_t b) const { return cutLinks.count(link(a, b)) == 0; }
+
+    // Every replica opens an exchange with every other one in turn, each
+    // run until the link is quiet, so later exchanges already see what
+    // earlier ones delivered. Returns the bytes moved.
+    uint64_t antiEntropyRound() {
+        uint64_t before = bytesDelivered;
+        for(size_t i = 0; i < replicas.size(); i++) {
+            for(size_t j = 0; j < replicas.size(); j++) {
+                if(i != j) exchange(i, j);
+            }
+        }
+        return bytesDelivered - before;
+    }
+
+    // One anti-entropy exchange started by replica from
+    void exchange(size_t from, size_t to) {
+        Message m;
+        m.from = from;
+        m.to = to;
+        replicas[from]->writeDigest(m.bytes);
+        inFlight.push_back(std::move(m));
+        while(!inFlight.empty()) {
+            Message next = std::move(inFlight.front());
+            inFlight.pop_front();
+            if(!isConnected(next.from, next.to)) {
+                messagesLost++;
+                continue;
+            }
+            Message reply;
+            reply.from = next.to;
+            reply.to = next.from;
+            replicas[next.to]->receive(next.bytes, reply.bytes);
+            messagesDelivered++;
+            bytesDelivered += next.bytes.size();
+            if(!reply.bytes.empty()) inFlight.push_back(std::move(reply));
+        }
+    }
+
+    bool isConverged() const {
+        for(size_t i = 1; i < replicas.size(); i++) {
+            if(replicas[i]->getStateHash() != replicas[0]->getStateHash()) return false;
+            if(replicas[i]->getVersionVector() != replicas[0]->getVersionVector()) return false;
+        }
+        return true;
+    }
+
+    void displayStatus() const {
+        cout << "Replica network: " << replicas.size() << " replicas, " << messagesDelivered
+             << " messages delivered (" << bytesDelivered / 1024 << " KB), " << messagesLost
+             << " lost to partitions" << endl;
+        for(auto r : replicas) {
+            cout << "  ";
+            r->displayStatus();
+        }
+    }
+
+    uint64_t getBytesDelivered() const { return bytesDelivered; }
+    uint64_t getMessagesLost() const { return messagesLost; }
+};
+
+#endif
@@ -0,0 +1,448 @@
+#ifndef SCORECARDDELTA_H
+#define SCORECARDDELTA_H
+
+#include "Match.h"
+#include <vector>
+#include <unordered_map>
+
+// ---------------------------------------------------------------------------
+// Per-delivery scorecard deltas
+//
+// Every message starts with kind (1 byte) and sequence number (varint).
+//
+//   DELTA:    mask (1 byte), then one block per bit set in the mask:
+//             DELTA_INNINGS  innings number
+//             DELTA_TOTALS   field mask + changed ScoreTotals fields
+//             DELTA_STRIKER  player id, field mask + changed PhaseStats fields
+//             DELTA_BOWLER   player id, field mask + changed PhaseStats fields
+//             DELTA_BALL     over, ball, outcome, wicket type, runs, extras,
+//                            fielder id (wickets only)
+//   SNAPSHOT: innings number, all totals, then every batter and bowler
+//             line of the current innings
+//
+// All numbers are unsigned LEB128 varints. Player ids are registry ids.
+// ---------------------------------------------------------------------------
+
+enum DeltaMessageKind {
+    MESSAGE_DELTA = 1,
+    MESSAGE_SNAPSHOT = 2
+};
+
+enum DeltaBlock {
+    DELTA_INNINGS = 1,
+    DELTA_TOTALS = 2,
+    DELTA_STRIKER = 4,
+    DELTA_BOWLER = 8,
+    DELTA_BALL = 16
+};
+
+const size_t DELTA_MAX_MESSAGE = 192;   // Upper bound for one DELTA message
+
+// Team totals for the current innings
+struct ScoreTotals {
+    int runs;
+    int wickets;
+    int extras;
+    int balls;      // Legal deliveries
+
+    ScoreTotals() : runs(0), wickets(0), extras(0), balls(0) {}
+
+    static const int FIELDS = 4;
+    int& field(int i) { return i == 0 ? runs : i == 1 ? wickets : i == 2 ? extras : balls; }
+    int field(int i) const { return i == 0 ? runs : i == 1 ? wickets : i == 2 ? extras : balls; }
+
+    bool operator==(const ScoreTotals& o) const {
+        return runs == o.runs && wickets == o.wickets && extras == o.extras && balls == o.balls;
+    }
+};
+
+const int LINE_FIELDS = 6;
+
+// Player line fields in wire order
+inline int& lineField(PhaseStats& s, int i) {
+    switch(i) {
+        case 0: return s.runs;
+        case 1: return s.balls;
+        case 2: return s.wickets;
+        case 3: return s.dotBalls;
+        case 4: return s.fours;
+        default: return s.sixes;
+    }
+}
+
+inline int lineField(const PhaseStats& s, int i) {
+    return lineField(const_cast<PhaseStats&>(s), i);
+}
+
+inline bool sameLine(const PhaseStats& a, const PhaseStats& b) {
+    for(int i = 0; i < LINE_FIELDS; i++) {
+        if(lineField(a, i) != lineField(b, i)) return false;
+    }
+    return true;
+}
+
+// Varint writer over a caller buffer; overflow() reports a short buffer
+class DeltaWriter {
+private:
+    char* start;
+    char* p;
+    char* end;
+    bool overflowed;
+
+public:
+    DeltaWriter(char* buffer, size_t capacity)
+        : start(buffer), p(buffer), end(buffer + capacity), overflowed(false) {}
+
+    void byte(uint8_t v) {
+        if(p >= end) { overflowed = true; return; }
+        *p++ = (char)v;
+    }
+
+    void varint(uint64_t v) {
+        while(v >= 0x80) {
+            byte((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        byte((uint8_t)v);
+    }
+
+    // Reserve one byte now and fill it in later (field masks)
+    char* placeholder() {
+        char* at = p;
+        byte(0);
+        return overflowed ? nullptr : at;
+    }
+
+    bool overflow() const { return overflowed; }
+    size_t size() const { return (size_t)(p - start); }
+};
+
+class DeltaReader {
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+    bool error;
+
+public:
+    DeltaReader(const char* data, size_t length)
+        : p((const uint8_t*)data), end((const uint8_t*)data + length), error(false) {}
+
+    uint8_t byte() {
+        if(p >= end) { error = true; return 0; }
+        return *p++;
+    }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for(int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = byte();
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if(!(b & 0x80)) return v;
+        }
+        error = true;
+        return 0;
+    }
+
+    bool failed() const { return error; }
+    bool atEnd() const { return p == end; }
+};
+
+// Encodes a delta for every delivery of one match and keeps the most
+// recent ones, so a consumer that is slightly behind can catch up from
+// history and one that is too far behind gets a snapshot instead.
+class ScorecardFeed : public DeliveryListener {
+private:
+    struct Slot {
+        uint64_t seq;
+        uint32_t length;
+        char data[DELTA_MAX_MESSAGE];
+    };
+
+    Match* match;
+    vector<Slot> history;
+    uint64_t seq;
+    uint64_t bytesEncoded;
+
+    // What subscribers have been told so far
+    int inningsNumber;
+    ScoreTotals totals;
+    unordered_map<PlayerId, PhaseStats> batters;
+    unordered_map<PlayerId, PhaseStats> bowlers;
+
+    static ScoreTotals totalsOf(const Innings& innings) {
+        ScoreTotals t;
+        t.runs = innings.getTotalRuns();
+        t.wickets = innings.getTotalWickets();
+        t.extras = innings.getTotalExtras();
+        for(int p = 0; p < PHASE_COUNT; p++) t.balls += innings.getPhaseTotals((InningsPhase)p).balls;
+        return t;
+    }
+
+    static void writeLineChanges(DeltaWriter& out, const PhaseStats& before, const PhaseStats& now) {
+        char* mask = out.placeholder();
+        uint8_t bits = 0;
+        for(int i = 0; i < LINE_FIELDS; i++) {
+            if(lineField(before, i) != lineField(now, i)) {
+                bits |= (uint8_t)(1 << i);
+                out.varint((uint64_t)lineField(now, i));
+            }
+        }
+        if(mask) *mask = (char)bits;
+    }
+
+    static void writeLine(DeltaWriter& out, PlayerId id, const PhaseStats& line) {
+        out.varint(id);
+        for(int i = 0; i < LINE_FIELDS; i++) out.varint((uint64_t)lineField(line, i));
+    }
+
+    // Encode the change a delivery made to one player line
+    void writePlayerBlock(DeltaWriter& out, unordered_map<PlayerId, PhaseStats>& known,
+                          PlayerId id, const PhaseStats& now) {
+        PhaseStats& before = known[id];
+        out.varint(id);
+        writeLineChanges(out, before, now);
+        before = now;
+    }
+
+public:
+    ScorecardFeed(Match* m, size_t historySize = 256)
+        : match(m), history(historySize ? historySize : 1), seq(0), bytesEncoded(0), inningsNumber(0) {
+        for(auto& slot : history) slot.seq = 0;
+        if(match) match->addDeliveryListener(this);
+    }
+
+    ~ScorecardFeed() {
+        if(match) match->removeDeliveryListener(this);
+    }
+
+    // No copies: the match points at this feed
+    ScorecardFeed(const ScorecardFeed&) = delete;
+    ScorecardFeed& operator=(const ScorecardFeed&) = delete;
+
+    void onDelivery(const Match&, const Innings& innings, const Ball& ball) override {
+        Slot& slot = history[seq % history.size()];
+        DeltaWriter out(slot.data, sizeof(slot.data));
+        out.byte(MESSAGE_DELTA);
+        out.varint(seq + 1);
+        char* mask = out.placeholder();
+        uint8_t bits = 0;
+
+        if(innings.getInningsNumber() != inningsNumber) {
+            inningsNumber = innings.getInningsNumber();
+            totals = ScoreTotals();
+            batters.clear();
+            bowlers.clear();
+            bits |= DELTA_INNINGS;
+            out.varint((uint64_t)inningsNumber);
+        }
+
+        ScoreTotals now = totalsOf(innings);
+        if(!(now == totals)) {
+            bits |= DELTA_TOTALS;
+            char* fieldMask = out.placeholder();
+            uint8_t fields = 0;
+            for(int i = 0; i < ScoreTotals::FIELDS; i++) {
+                if(now.field(i) != totals.field(i)) {
+                    fields |= (uint8_t)(1 << i);
+                    out.varint((uint64_t)now.field(i));
+                }
+            }
+            if(fieldMask) *fieldMask = (char)fields;
+            totals = now;
+        }
+
+        if(ball.getBatsmanId() != INVALID_PLAYER_ID) {
+            bits |= DELTA_STRIKER;
+            writePlayerBlock(out, batters, ball.getBatsmanId(), innings.getBatterLine(ball.getBatsmanId()).total());
+        }
+        if(ball.getBowlerId() != INVALID_PLAYER_ID) {
+            bits |= DELTA_BOWLER;
+            writePlayerBlock(out, bowlers, ball.getBowlerId(), innings.getBowlerLine(ball.getBowlerId()).total());
+        }
+
+        bits |= DELTA_BALL;
+        out.varint((uint64_t)ball.getOverNumber());
+        out.byte((uint8_t)ball.getBallNumber());
+        out.byte((uint8_t)ball.getOutcome());
+        out.byte((uint8_t)ball.getWicketType());
+        out.varint((uint64_t)ball.getRuns());
+        out.varint((uint64_t)ball.getExtras());
+        if(ball.getWicketType() != WicketType::NONE) out.varint(ball.getFielderId());
+
+        if(mask) *mask = (char)bits;
+        seq++;
+        slot.seq = seq;
+        slot.length = out.overflow() ? 0 : (uint32_t)out.size();
+        bytesEncoded += slot.length;
+    }
+
+    // Full state of the current innings; returns 0 if the buffer is too small
+    size_t writeSnapshot(char* buffer, size_t capacity) const {
+        DeltaWriter out(buffer, capacity);
+        out.byte(MESSAGE_SNAPSHOT);
+        out.varint(seq);
+        out.varint((uint64_t)inningsNumber);
+        for(int i = 0; i < ScoreTotals::FIELDS; i++) out.varint((uint64_t)totals.field(i));
+        out.varint(batters.size());
+        for(const auto& b : batters) writeLine(out, b.first, b.second);
+        out.varint(bowlers.size());
+        for(const auto& b : bowlers) writeLine(out, b.first, b.second);
+        return out.overflow() ? 0 : out.size();
+    }
+
+    // Next message for a consumer that has applied everything up to
+    // lastSeen: the following delta while it is still in history, or a
+    // snapshot. Returns 0 when the consumer is up to date.
+    size_t next(uint64_t lastSeen, char* buffer, size_t capacity) const {
+        if(lastSeen >= seq) return 0;
+        const Slot& slot = history[lastSeen % history.size()];
+        if(slot.seq == lastSeen + 1 && slot.length > 0 && slot.length <= capacity) {
+            memcpy(buffer, slot.data, slot.length);
+            return slot.length;
+        }
+        return writeSnapshot(buffer, capacity);
+    }
+
+    uint64_t getSequence() const { return seq; }
+    uint64_t getBytesEncoded() const { return bytesEncoded; }
+    size_t getHistorySize() const { return history.size(); }
+};
+
+enum class DeltaResult {
+    APPLIED,
+    STALE,      // Already applied; ignored
+    GAP,        // Messages were missed; ask the feed for a snapshot
+    MALFORMED
+};
+
+// Consumer-side copy of the scorecard, rebuilt from feed messages
+class ScorecardMirror {
+private:
+    uint64_t seq;
+    int inningsNumber;
+    ScoreTotals totals;
+    unordered_map<PlayerId, PhaseStats> batters;
+    unordered_map<PlayerId, PhaseStats> bowlers;
+    int lastOver;
+    int lastBall;
+    BallOutcome lastOutcome;
+    WicketType lastWicket;
+    int resyncs;
+
+    static void readLineChanges(DeltaReader& in, PhaseStats& line) {
+        uint8_t fields = in.byte();
+        for(int i = 0; i < LINE_FIELDS; i++) {
+            if(fields & (1 << i)) lineField(line, i) = (int)in.varint();
+        }
+    }
+
+    static void readLines(DeltaReader& in, unordered_map<PlayerId, PhaseStats>& lines) {
+        lines.clear();
+        uint64_t count = in.varint();
+        for(uint64_t n = 0; n < count && !in.failed(); n++) {
+            PhaseStats& line = lines[(PlayerId)in.varint()];
+            for(int i = 0; i < LINE_FIELDS; i++) lineField(line, i) = (int)in.varint();
+        }
+    }
+
+    DeltaResult applySnapshot(DeltaReader& in, uint64_t messageSeq) {
+        if(messageSeq < seq) return DeltaResult::STALE;
+        inningsNumber = (int)in.varint();
+        for(int i = 0; i < ScoreTotals::FIELDS; i++) totals.field(i) = (int)in.varint();
+        readLines(in, batters);
+        readLines(in, bowlers);
+        if(in.failed()) return DeltaResult::MALFORMED;
+        seq = messageSeq;
+        resyncs++;
+        return DeltaResult::APPLIED;
+    }
+
+    DeltaResult applyDelta(DeltaReader& in, uint64_t messageSeq) {
+        if(messageSeq <= seq) return DeltaResult::STALE;
+        if(messageSeq != seq + 1) return DeltaResult::GAP;
+        uint8_t bits = in.byte();
+        if(bits & DELTA_INNINGS) {
+            inningsNumber = (int)in.varint();
+            totals = ScoreTotals();
+            batters.clear();
+            bowlers.clear();
+        }
+        if(bits & DELTA_TOTALS) {
+            uint8_t fields = in.byte();
+            for(int i = 0; i < ScoreTotals::FIELDS; i++) {
+                if(fields & (1 << i)) totals.field(i) = (int)in.varint();
+            }
+        }
+        if(bits & DELTA_STRIKER) readLineChanges(in, batters[(PlayerId)in.varint()]);
+        if(bits & DELTA_BOWLER) readLineChanges(in, bowlers[(PlayerId)in.varint()]);
+        if(bits & DELTA_BALL) {
+            lastOver = (int)in.varint();
+            lastBall = in.byte();
+            lastOutcome = (BallOutcome)in.byte();
+            lastWicket = (WicketType)in.byte();
+            in.varint();    // Runs and extras are already in the lines and totals
+            in.varint();
+            if(lastWicket != WicketType::NONE) in.varint();
+        }
+        if(in.failed()) return DeltaResult::MALFORMED;
+        seq = messageSeq;
+        return DeltaResult::APPLIED;
+    }
+
+public:
+    ScorecardMirror() : seq(0), inningsNumber(0), lastOver(0), lastBall(0),
+                        lastOutcome(BallOutcome::DOT_BALL), lastWicket(WicketType::NONE), resyncs(0) {}
+
+    DeltaResult apply(const char* data, size_t length) {
+        DeltaReader in(data, length);
+        uint8_t kind = in.byte();
+        uint64_t messageSeq = in.varint();
+        if(in.failed()) return DeltaResult::MALFORMED;
+        if(kind == MESSAGE_DELTA) return applyDelta(in, messageSeq);
+        if(kind == MESSAGE_SNAPSHOT) return applySnapshot(in, messageSeq);
+        return DeltaResult::MALFORMED;
+    }
+
+    // Pull everything this mirror is missing from a feed
+    void catchUp(const ScorecardFeed& feed) {
+        char buffer[4096];
+        size_t length;
+        while((length = feed.next(seq, buffer, sizeof(buffer))) > 0) {
+            if(apply(buffer, length) != DeltaResult::APPLIED) break;
+        }
+    }
+
+    // Whether this mirror agrees with the live innings
+    bool matches(const Innings& innings) const {
+        if(innings.getTotalRuns() != totals.runs || innings.getTotalWickets() != totals.wickets ||
+           innings.getTotalExtras() != totals.extras) return false;
+        for(const auto& b : batters) {
+            if(!sameLine(b.second, innings.getBatterLine(b.first).total())) return false;
+        }
+        for(const auto& b : bowlers) {
+            if(!sameLine(b.second, innings.getBowlerLine(b.first).total())) return false;
+        }
+        return true;
+    }
+
+    void displayScore() const {
+        cout << "Innings " << inningsNumber << ": " << totals.runs << "/" << totals.wickets
+             << " (" << totals.balls / 6 << "." << totals.balls % 6 << " overs), last ball "
+             << lastOver << "." << lastBall << " " << Ball::outcomeToString(lastOutcome) << endl;
+    }
+
+    uint64_t getSequence() const { return seq; }
+    int getInningsNumber() const { return inningsNumber; }
+    const ScoreTotals& getTotals() const { return totals; }
+    const PhaseStats* getBatter(PlayerId id) const {
+        auto it = batters.find(id);
+        return it != batters.end() ? &it->second : nullptr;
+    }
+    const PhaseStats* getBowler(PlayerId id) const {
+        auto it = bowlers.find(id);
+        return it != bowlers.end() ? &it->second : nullptr;
+    }
+    int getResyncCount() const { return resyncs; }
+};
+
+#endif
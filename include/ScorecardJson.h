@@ -0,0 +1,208 @@
+#ifndef SCORECARDJSON_H
+#define SCORECARDJSON_H
+
+#include "Match.h"
+#include "JsonWriter.h"
+
+// How much of the scorecard to write
+enum class ScorecardDetail {
+    SUMMARY,    // Match and innings totals
+    OVERS,      // Plus one entry per over
+    BALLS       // Plus every delivery
+};
+
+// JSON token for an enum value, quotes included, computed once
+struct JsonToken {
+    const char* text;
+    size_t length;
+};
+
+#define JSON_TOKEN(s) {"\"" s "\"", sizeof(s) + 1}
+
+static const JsonToken OUTCOME_TOKENS[] = {
+    JSON_TOKEN("dot"), JSON_TOKEN("single"), JSON_TOKEN("double"), JSON_TOKEN("triple"),
+    JSON_TOKEN("four"), JSON_TOKEN("six"), JSON_TOKEN("wicket"), JSON_TOKEN("wide"),
+    JSON_TOKEN("no_ball"), JSON_TOKEN("bye"), JSON_TOKEN("leg_bye"), JSON_TOKEN("wicket_and_runs")
+};
+
+static const JsonToken WICKET_TOKENS[] = {
+    JSON_TOKEN("none"), JSON_TOKEN("bowled"), JSON_TOKEN("caught"), JSON_TOKEN("lbw"),
+    JSON_TOKEN("run_out"), JSON_TOKEN("stumped"), JSON_TOKEN("hit_wicket"),
+    JSON_TOKEN("caught_and_bowled"), JSON_TOKEN("caught_behind"), JSON_TOKEN("obstructing_field"),
+    JSON_TOKEN("hit_ball_twice"), JSON_TOKEN("timed_out")
+};
+
+static const JsonToken MATCH_TYPE_TOKENS[] = {
+    JSON_TOKEN("test"), JSON_TOKEN("odi"), JSON_TOKEN("t20"), JSON_TOKEN("first_class"),
+    JSON_TOKEN("three_day"), JSON_TOKEN("list_a")
+};
+
+static const JsonToken STATUS_TOKENS[] = {
+    JSON_TOKEN("not_started"), JSON_TOKEN("in_progress"), JSON_TOKEN("innings_break"),
+    JSON_TOKEN("completed"), JSON_TOKEN("abandoned"), JSON_TOKEN("drawn")
+};
+
+#undef JSON_TOKEN
+
+// Writes a match scorecard as JSON into a caller-owned buffer.
+// Nothing is allocated per call: names are copied straight from the
+// objects and enum values come from the token tables above.
+class ScorecardJson {
+private:
+    static void token(JsonWriter& out, const JsonToken* table, size_t count, int value) {
+        if(value >= 0 && (size_t)value < count) out.raw(table[value].text, table[value].length);
+        else out.null();
+    }
+
+    static void name(JsonWriter& out, const Person* person) {
+        if(person) out.str(person->getName());
+        else out.null();
+    }
+
+    static void teamName(JsonWriter& out, const Team* team) {
+        if(team) out.str(team->getTeamName());
+        else out.null();
+    }
+
+    static int legalBalls(const Over* over) {
+        int n = 0;
+        for(auto ball : over->getBalls()) {
+            if(ball->getIsValid()) n++;
+        }
+        return n;
+    }
+
+public:
+    static void writeBall(JsonWriter& out, const Ball& ball) {
+        out.lit("{\"ball\":");
+        out.integer(ball.getBallNumber());
+        out.lit(",\"batter\":");
+        name(out, ball.getBatsman());
+        out.lit(",\"runs\":");
+        out.integer(ball.getRuns());
+        out.lit(",\"extras\":");
+        out.integer(ball.getExtras());
+        out.lit(",\"outcome\":");
+        token(out, OUTCOME_TOKENS, sizeof(OUTCOME_TOKENS) / sizeof(JsonToken), (int)ball.getOutcome());
+        if(ball.getWicketType() != WicketType::NONE) {
+            out.lit(",\"wicket\":");
+            token(out, WICKET_TOKENS, sizeof(WICKET_TOKENS) / sizeof(JsonToken), (int)ball.getWicketType());
+            if(ball.getFielder()) {
+                out.lit(",\"fielder\":");
+                name(out, ball.getFielder());
+            }
+        }
+        out.ch('}');
+    }
+
+    static void writeOver(JsonWriter& out, const Over& over, ScorecardDetail detail) {
+        out.lit("{\"over\":");
+        out.integer(over.getOverNumber());
+        out.lit(",\"bowler\":");
+        name(out, over.getBowler());
+        out.lit(",\"runs\":");
+        out.integer(over.getRunsInOver());
+        out.lit(",\"wickets\":");
+        out.integer(over.getWicketsInOver());
+        out.lit(",\"maiden\":");
+        out.boolean(over.getIsMaidenOver());
+        if(detail == ScorecardDetail::BALLS) {
+            out.lit(",\"balls\":[");
+            bool first = true;
+            for(auto ball : over.getBalls()) {
+                if(!first) out.ch(',');
+                first = false;
+                writeBall(out, *ball);
+            }
+            out.ch(']');
+        }
+        out.ch('}');
+    }
+
+    static void writeInnings(JsonWriter& out, const Innings& innings, ScorecardDetail detail) {
+        const vector<Over*>& overs = innings.getOvers();
+        int completeOvers = (int)overs.size();
+        int extraBalls = 0;
+        if(!overs.empty() && !overs.back()->isComplete()) {
+            completeOvers--;
+            extraBalls = legalBalls(overs.back());
+        }
+
+        out.lit("{\"number\":");
+        out.integer(innings.getInningsNumber());
+        out.lit(",\"batting\":");
+        teamName(out, innings.getBattingTeam());
+        out.lit(",\"bowling\":");
+        teamName(out, innings.getBowlingTeam());
+        out.lit(",\"runs\":");
+        out.integer(innings.getTotalRuns());
+        out.lit(",\"wickets\":");
+        out.integer(innings.getTotalWickets());
+        out.lit(",\"overs\":\"");
+        out.integer(completeOvers);
+        out.ch('.');
+        out.integer(extraBalls);
+        out.lit("\",\"run_rate\":");
+        out.decimal2(innings.getCurrentRunRate());
+        out.lit(",\"extras\":{\"total\":");
+        out.integer(innings.getTotalExtras());
+        out.lit(",\"wides\":");
+        out.integer(innings.getWides());
+        out.lit(",\"no_balls\":");
+        out.integer(innings.getNoBalls());
+        out.lit(",\"byes\":");
+        out.integer(innings.getByes());
+        out.lit(",\"leg_byes\":");
+        out.integer(innings.getLegByes());
+        out.lit("},\"completed\":");
+        out.boolean(innings.getIsCompleted());
+        out.lit(",\"all_out\":");
+        out.boolean(innings.getIsAllOut());
+        out.lit(",\"declared\":");
+        out.boolean(innings.getIsDeclared());
+        if(detail != ScorecardDetail::SUMMARY) {
+            out.lit(",\"over_list\":[");
+            for(size_t i = 0; i < overs.size(); i++) {
+                if(i) out.ch(',');
+                writeOver(out, *overs[i], detail);
+            }
+            out.ch(']');
+        }
+        out.ch('}');
+    }
+
+    static void writeMatch(JsonWriter& out, const Match& match, ScorecardDetail detail) {
+        out.lit("{\"id\":");
+        out.str(match.getMatchId());
+        out.lit(",\"type\":");
+        token(out, MATCH_TYPE_TOKENS, sizeof(MATCH_TYPE_TOKENS) / sizeof(JsonToken), (int)match.getMatchType());
+        out.lit(",\"status\":");
+        token(out, STATUS_TOKENS, sizeof(STATUS_TOKENS) / sizeof(JsonToken), (int)match.getStatus());
+        out.lit(",\"team1\":");
+        teamName(out, match.getTeam1());
+        out.lit(",\"team2\":");
+        teamName(out, match.getTeam2());
+        out.lit(",\"venue\":");
+        if(match.getVenue()) out.str(match.getVenue()->getStadiumName());
+        else out.null();
+        out.lit(",\"result\":");
+        out.str(match.getResult());
+        out.lit(",\"innings\":[");
+        const vector<Innings*>& innings = match.getAllInnings();
+        for(size_t i = 0; i < innings.size(); i++) {
+            if(i) out.ch(',');
+            writeInnings(out, *innings[i], detail);
+        }
+        out.lit("]}");
+    }
+
+    // Serialize into buffer; returns the JSON length, or 0 if it did not fit
+    static size_t serialize(const Match& match, char* buffer, size_t capacity,
+                            ScorecardDetail detail = ScorecardDetail::BALLS) {
+        JsonWriter out(buffer, capacity);
+        writeMatch(out, match, detail);
+        return out.overflowed() ? 0 : out.size();
+    }
+};
+
+#endif
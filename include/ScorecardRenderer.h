@@ -0,0 +1,212 @@
+#ifndef SCORECARDRENDERER_H
+#define SCORECARDRENDERER_H
+
+#include "Match.h"
+#include <string>
+#include <unordered_map>
+
+// Formats scorecards into one reusable text buffer and writes each screen
+// with a single write. The text matches Match::displayMatchSummary and
+// Match::displayFullMatch. Overs that are finished (a later over has
+// started) never change, so their lines are rendered once per innings and
+// reused; only the current over and the totals are formatted again.
+class ScorecardRenderer {
+private:
+    struct InningsCache {
+        size_t overs;           // Overs rendered into lines
+        const Over* lastOver;   // Detects an Innings reused at the same address
+        string lines;
+
+        InningsCache() : overs(0), lastOver(nullptr) {}
+    };
+
+    string text;
+    unordered_map<const Innings*, InningsCache> cache;
+    uint64_t oversRendered;
+    uint64_t oversReused;
+
+    static void appendInt(string& out, int value) {
+        char digits[12];
+        int n = 0;
+        unsigned int v = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+        do {
+            digits[n++] = (char)('0' + v % 10);
+            v /= 10;
+        } while(v);
+        if(value < 0) out += '-';
+        while(n) out += digits[--n];
+    }
+
+    void renderOver(string& out, const Over& over) {
+        TRACE_SPAN("ScorecardRenderer::renderOver");
+        out += "\nOver ";
+        appendInt(out, over.getOverNumber());
+        out += " (";
+        out += over.getBowler()->getName();
+        out += "): ";
+        for(auto ball : over.getBalls()) {
+            if(ball->getWicketType() != WicketType::NONE) {
+                out += "W ";
+            } else if(ball->getOutcome() == BallOutcome::WIDE) {
+                out += "Wd ";
+            } else if(ball->getOutcome() == BallOutcome::NO_BALL) {
+                out += "Nb ";
+            } else {
+                appendInt(out, ball->getRuns());
+                out += ' ';
+            }
+        }
+        out += " | ";
+        appendInt(out, over.getRunsInOver());
+        out += " runs";
+        if(over.getIsMaidenOver()) out += " (Maiden)";
+        out += '\n';
+        oversRendered++;
+    }
+
+    void renderInningsScore(const Innings& innings) {
+        text += "\n===== Innings ";
+        appendInt(text, innings.getInningsNumber());
+        text += " =====\n";
+        text += innings.getBattingTeam()->getTeamName();
+        text += ": ";
+        appendInt(text, innings.getTotalRuns());
+        text += '/';
+        appendInt(text, innings.getTotalWickets());
+        if(innings.getIsDeclared()) text += " dec";
+        text += " (";
+        appendInt(text, (int)innings.getOvers().size());
+        text += " overs)\nExtras: ";
+        appendInt(text, innings.getTotalExtras());
+        text += " (wd ";
+        appendInt(text, innings.getWides());
+        text += ", nb ";
+        appendInt(text, innings.getNoBalls());
+        text += ", b ";
+        appendInt(text, innings.getByes());
+        text += ", lb ";
+        appendInt(text, innings.getLegByes());
+        text += ")\n";
+    }
+
+    void renderPhaseBreakdown(const Innings& innings) {
+        text += "\nPhase Breakdown:\n";
+        for(int i = 0; i < PHASE_COUNT; i++) {
+            const PhaseStats& p = innings.getPhaseTotals((InningsPhase)i);
+            if(p.balls == 0 && p.runs == 0) continue;
+            text += "  ";
+            text += Innings::getPhaseString((InningsPhase)i);
+            text += ": ";
+            appendInt(text, p.runs);
+            text += '/';
+            appendInt(text, p.wickets);
+            text += " off ";
+            appendInt(text, p.balls);
+            text += " balls (dots ";
+            appendInt(text, p.dotBalls);
+            text += ", 4s ";
+            appendInt(text, p.fours);
+            text += ", 6s ";
+            appendInt(text, p.sixes);
+            text += ")\n";
+        }
+    }
+
+    // Finished overs come from the cache; the over in progress is formatted fresh
+    void renderOvers(const Innings& innings) {
+        const vector<Over*>& overs = innings.getOvers();
+        size_t finished = overs.empty() ? 0 : overs.size() - 1;
+        if(innings.getIsCompleted()) finished = overs.size();
+
+        InningsCache& c = cache[&innings];
+        if(c.overs > overs.size() || (c.overs > 0 && overs[c.overs - 1] != c.lastOver)) {
+            c.overs = 0;
+            c.lines.clear();
+        }
+        oversReused += c.overs;
+        while(c.overs < finished) {
+            renderOver(c.lines, *overs[c.overs]);
+            c.lastOver = overs[c.overs];
+            c.overs++;
+        }
+        text += c.lines;
+        for(size_t i = c.overs; i < overs.size(); i++) renderOver(text, *overs[i]);
+    }
+
+    void renderSummaryText(const Match& match) {
+        text += "\n========================================\n"
+                "       MATCH SUMMARY\n"
+                "========================================\n"
+                "Match ID: ";
+        text += match.getMatchId();
+        text += "\nType: ";
+        text += match.getMatchTypeString();
+        text += "\nVenue: ";
+        text += match.getVenue()->getStadiumName();
+        text += ", ";
+        text += match.getVenue()->getCity();
+        text += "\nStatus: ";
+        text += match.getStatusString();
+        text += "\n\nToss: ";
+        text += match.getTossWinner();
+        text += " won and chose to ";
+        text += match.getTossDecision();
+        text += "\n\n--- SCORECARD ---\n";
+        for(auto innings : match.getAllInnings()) renderInningsScore(*innings);
+        if(match.getStatus() == MatchStatus::COMPLETED) {
+            text += "\nResult: ";
+            text += match.getResult();
+            text += '\n';
+        }
+        text += "========================================\n";
+    }
+
+public:
+    ScorecardRenderer() : oversRendered(0), oversReused(0) {}
+
+    const string& renderSummary(const Match& match) {
+        TRACE_SPAN("ScorecardRenderer::renderSummary");
+        text.clear();
+        renderSummaryText(match);
+        return text;
+    }
+
+    const string& renderFullMatch(const Match& match) {
+        TRACE_SPAN("ScorecardRenderer::renderFullMatch");
+        text.clear();
+        renderSummaryText(match);
+        text += "\n\n--- BALL BY BALL COMMENTARY ---\n";
+        for(auto innings : match.getAllInnings()) {
+            renderInningsScore(*innings);
+            if(innings->getPowerplayOvers() > 0) renderPhaseBreakdown(*innings);
+            text += "\nOver by Over:\n";
+            renderOvers(*innings);
+        }
+        return text;
+    }
+
+    // One write and one flush per screen
+    void displaySummary(const Match& match, ostream& out = cout) {
+        const string& screen = renderSummary(match);
+        out.write(screen.data(), screen.size());
+        out.flush();
+    }
+
+    void displayFullMatch(const Match& match, ostream& out = cout) {
+        const string& screen = renderFullMatch(match);
+        out.write(screen.data(), screen.size());
+        out.flush();
+    }
+
+    // Drop cached overs; call before the match is deleted
+    void forget(const Match& match) {
+        for(auto innings : match.getAllInnings()) cache.erase(innings);
+    }
+
+    void clear() { cache.clear(); }
+
+    uint64_t getOversRendered() const { return oversRendered; }
+    uint64_t getOversReused() const { return oversReused; }
+};
+
+#endif
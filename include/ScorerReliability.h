@@ -0,0 +1,120 @@
+#ifndef SCORERRELIABILITY_H
+#define SCORERRELIABILITY_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <map>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+// Running record of how often one scorer's entry matched the ruling
+struct ScorerTrack {
+    double correct;         // Decayed count of entries that matched the ruling
+    double wrong;
+    uint64_t rulings;       // Rulings seen, undecayed
+
+    ScorerTrack() : correct(0), wrong(0), rulings(0) {}
+};
+
+// Streaming per-scorer accuracy, learned from conflict rulings.
+// Each scorer's accuracy is the mean of a Beta posterior: a prior worth
+// PRIOR_WEIGHT rulings at PRIOR_ACCURACY, plus their record, where older
+// rulings decay so the estimate follows a scorer who gets better or worse.
+// A vote then carries the log-odds of that accuracy, the weighting that
+// makes a vote of independent scorers most likely to be right.
+class ScorerReliability {
+public:
+    static constexpr double PRIOR_ACCURACY = 0.8;
+    static constexpr double PRIOR_WEIGHT = 5.0;
+    static constexpr double MIN_ACCURACY = 0.5;      // A worse scorer carries no weight
+    static constexpr double MAX_ACCURACY = 0.995;    // Nobody's vote is decisive on its own record
+
+private:
+    unordered_map<string, ScorerTrack> tracks;
+    double decay;
+
+public:
+    ScorerReliability(double decayPerRuling = 0.995) : decay(decayPerRuling) {}
+
+    // One of the scorer's entries was ruled on
+    void recordOutcome(const string& userId, bool correct) {
+        ScorerTrack& t = tracks[userId];
+        t.correct *= decay;
+        t.wrong *= decay;
+        if(correct) t.correct += 1;
+        else t.wrong += 1;
+        t.rulings++;
+    }
+
+    double getAccuracy(const string& userId) const {
+        auto it = tracks.find(userId);
+        double correct = PRIOR_ACCURACY * PRIOR_WEIGHT;
+        double total = PRIOR_WEIGHT;
+        if(it != tracks.end()) {
+            correct += it->second.correct;
+            total += it->second.correct + it->second.wrong;
+        }
+        double p = correct / total;
+        if(p < MIN_ACCURACY) p = MIN_ACCURACY;
+        if(p > MAX_ACCURACY) p = MAX_ACCURACY;
+        return p;
+    }
+
+    // Log-odds vote weight
+    double getWeight(const string& userId) const {
+        double p = getAccuracy(userId);
+        return log(p / (1 - p));
+    }
+
+    uint64_t getRulings(const string& userId) const {
+        auto it = tracks.find(userId);
+        return it == tracks.end() ? 0 : it->second.rulings;
+    }
+
+    size_t size() const { return tracks.size(); }
+
+    // One line per scorer: user id, correct, wrong, rulings
+    bool save(const string& path) const {
+        ofstream file(path.c_str(), ios::trunc);
+        if(!file.is_open()) return false;
+        map<string, ScorerTrack> sorted(tracks.begin(), tracks.end());
+        for(const auto& t : sorted) {
+            file << t.first << "\t" << t.second.correct << "\t" << t.second.wrong << "\t"
+                 << t.second.rulings << "\n";
+        }
+        return file.good();
+    }
+
+    // Replace the records of every scorer in the file; false if it cannot be read
+    bool load(const string& path) {
+        ifstream file(path.c_str());
+        if(!file.is_open()) return false;
+        string line;
+        while(getline(file, line)) {
+            size_t tab = line.find('\t');
+            if(tab == string::npos) continue;
+            ScorerTrack t;
+            istringstream fields(line.substr(tab + 1));
+            if(fields >> t.correct >> t.wrong >> t.rulings) tracks[line.substr(0, tab)] = t;
+        }
+        return true;
+    }
+
+    void displayScorers() const {
+        cout << "\n========== SCORER RELIABILITY ==========" << endl;
+        map<string, ScorerTrack> sorted(tracks.begin(), tracks.end());
+        for(const auto& t : sorted) {
+            cout << "  " << t.first << ": " << (int)(getAccuracy(t.first) * 1000 + 0.5) / 10.0
+                 << "% over " << t.second.rulings << " rulings (weight "
+                 << (int)(getWeight(t.first) * 100 + 0.5) / 100.0 << ")" << endl;
+        }
+        cout << "========================================" << endl;
+    }
+};
+
+#endif
@@ -0,0 +1,672 @@
+#ifndef SCORINGSERVER_H
+#define SCORINGSERVER_H
+
+#include "ScoreWire.h"
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <unordered_map>
+
+// "5800" is a loopback TCP port; anything else is a Unix socket path
+inline bool isTcpAddress(const string& address) {
+    if(address.empty()) return false;
+    for(char c : address) {
+        if(c < '0' || c > '9') return false;
+    }
+    return true;
+}
+
+// Non-blocking, epoll-driven ingestion of scorer entries into a Scorebook.
+// One thread runs pollOnce() in a loop; that thread is also the one that
+// feeds the Scorebook and publishes its events, so nothing here locks.
+// Updates from the scorebook's event bus are streamed to subscribed
+// clients. A client whose unsent output passes OUTPUT_LIMIT stops being
+// read until it drains, so a stalled scorer cannot grow server memory.
+// A client refused by the scorebook's admission control gets a THROTTLED
+// ack and is not read again until its back-off has passed; entries it
+// keeps sending wait in its socket, so the flood slows its own sends.
+class ScoringServer {
+public:
+    static const size_t OUTPUT_LIMIT = 1 << 20;
+    static const int MAX_EVENTS = 64;
+
+private:
+    struct Client {
+        int fd;
+        string userId;
+        string userName;
+        bool helloDone;
+        bool subscribed;
+        bool readPaused;
+        bool writeArmed;
+        bool heldBack;          // Throttled; not read until resumeAt
+        chrono::steady_clock::time_point resumeAt;
+        vector<char> in;
+        size_t inUsed;
+        vector<char> out;
+        size_t outSent;
+        uint64_t entries;
+
+        Client(int f) : fd(f), helloDone(false), subscribed(false), readPaused(false),
+                        writeArmed(false), heldBack(false), in(64 * 1024), inUsed(0), outSent(0), entries(0) {}
+
+        size_t pendingOutput() const { return out.size() - outSent; }
+    };
+
+    Scorebook& scorebook;
+    EventBus ownBus;
+    EventBus* bus;
+    EventCursor* cursor;
+    int listenFd;
+    int epollFd;
+    bool tcp;
+    string unixPath;
+    unordered_map<int, Client*> clients;
+    vector<Client*> pendingWrites;
+    vector<Client*> heldClients;
+
+    uint64_t connections;
+    uint64_t entriesAccepted;
+    uint64_t entriesRejected;
+    uint64_t entriesDuplicate;
+    uint64_t entriesThrottled;
+    uint64_t updatesSent;
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+
+    static bool setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    void updateInterest(Client& c) {
+        epoll_event ev;
+        uint32_t events = EPOLLRDHUP;
+        if(!c.readPaused && !c.heldBack) events |= EPOLLIN;
+        if(c.writeArmed) events |= EPOLLOUT;
+        ev.events = events;
+        ev.data.fd = c.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+    }
+
+    void closeClient(Client* c) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, c->fd, nullptr);
+        ::close(c->fd);
+        clients.erase(c->fd);
+        pendingWrites.erase(remove(pendingWrites.begin(), pendingWrites.end(), c), pendingWrites.end());
+        heldClients.erase(remove(heldClients.begin(), heldClients.end(), c), heldClients.end());
+        delete c;
+    }
+
+    void queueOutput(Client& c) {
+        if(c.pendingOutput() > 0 && find(pendingWrites.begin(), pendingWrites.end(), &c) == pendingWrites.end()) {
+            pendingWrites.push_back(&c);
+        }
+    }
+
+    // Write as much pending output as the socket takes; false if the client died
+    bool flushClient(Client& c) {
+        while(c.outSent < c.out.size()) {
+            ssize_t n = ::send(c.fd, c.out.data() + c.outSent, c.out.size() - c.outSent, MSG_NOSIGNAL);
+            if(n > 0) {
+                c.outSent += (size_t)n;
+                bytesOut += (uint64_t)n;
+            } else if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else if(n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return false;
+            }
+        }
+        if(c.outSent == c.out.size()) {
+            c.out.clear();
+            c.outSent = 0;
+        }
+
+        bool wantWrite = c.pendingOutput() > 0;
+        bool pause = c.pendingOutput() > OUTPUT_LIMIT;
+        if(wantWrite != c.writeArmed || pause != c.readPaused) {
+            c.writeArmed = wantWrite;
+            c.readPaused = pause;
+            updateInterest(c);
+        }
+        return true;
+    }
+
+    bool handleFrame(Client& c, const FrameView& frame) {
+        WireReader in(frame);
+        WireWriter out(c.out);
+        if(frame.type == FRAME_HELLO) {
+            // Identity is fixed for the connection; a second HELLO is a protocol error
+            if(c.helloDone) return false;
+            uint8_t flags = in.u8();
+            c.userId = in.str();
+            c.userName = in.str();
+            if(in.failed()) return false;
+            c.helloDone = true;
+            c.subscribed = (flags & HELLO_SUBSCRIBE) != 0;
+            return true;
+        }
+        if(frame.type == FRAME_ENTRY) {
+            WireEntry entry;
+            if(!entry.read(in)) return false;
+            if(!c.helloDone || !scorebook.getIsNetworkSyncEnabled()) {
+                entriesRejected++;
+                writeAck(out, entry.seq, ACK_REJECTED);
+                return true;
+            }
+            if(!scorebook.addScoreEntry(entry.toScoreEntry(c.userId, c.userName))) {
+                if(scorebook.getLastAdmission() != AdmissionVerdict::ADMITTED) {
+                    uint32_t retryAfterMs = scorebook.getAdmissionControl()->getRetryAfterMs();
+                    entriesThrottled++;
+                    writeAck(out, entry.seq, ACK_THROTTLED, retryAfterMs);
+                    holdBack(c, retryAfterMs);
+                    return true;
+                }
+                // A retry of an entry we already have; ack it so the client stops resending
+                entriesDuplicate++;
+                writeAck(out, entry.seq, ACK_DUPLICATE);
+                return true;
+            }
+            c.entries++;
+            entriesAccepted++;
+            writeAck(out, entry.seq, scorebook.hasConflict(entry.overNumber, entry.ballNumber)
+                                     ? ACK_CONFLICT : ACK_ACCEPTED);
+            return true;
+        }
+        return false;
+    }
+
+    // Stop reading a throttled client for a while
+    void holdBack(Client& c, uint32_t ms) {
+        c.heldBack = true;
+        c.resumeAt = chrono::steady_clock::now() + chrono::milliseconds(ms);
+        heldClients.push_back(&c);
+        updateInterest(c);
+    }
+
+    // Handle each complete buffered frame, stopping if the client is held back
+    bool processInput(Client& c) {
+        size_t offset = 0;
+        FrameView frame;
+        long taken = 0;
+        while(!c.heldBack && (taken = parseFrame(c.in.data() + offset, c.inUsed - offset, frame)) > 0) {
+            if(!handleFrame(c, frame)) return false;
+            offset += (size_t)taken;
+        }
+        if(taken < 0) return false;
+        if(offset > 0) {
+            memmove(c.in.data(), c.in.data() + offset, c.inUsed - offset);
+            c.inUsed -= offset;
+        }
+        return true;
+    }
+
+    // Let held clients whose back-off has passed be read again
+    void releaseHeldClients() {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        vector<Client*> held;
+        held.swap(heldClients);
+        for(auto c : held) {
+            if(c->resumeAt > now) {
+                heldClients.push_back(c);
+                continue;
+            }
+            c->heldBack = false;
+            updateInterest(*c);
+            if(!processInput(*c)) {
+                closeClient(c);
+                continue;
+            }
+            queueOutput(*c);
+        }
+    }
+
+    // Milliseconds until the next held client may be read, capped at timeoutMs
+    int holdTimeout(int timeoutMs) const {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        for(auto c : heldClients) {
+            int ms = (int)chrono::duration_cast<chrono::milliseconds>(c->resumeAt - now).count() + 1;
+            if(ms < 0) ms = 0;
+            if(timeoutMs < 0 || ms < timeoutMs) timeoutMs = ms;
+        }
+        return timeoutMs;
+    }
+
+    // Read everything available and handle each complete frame
+    bool readClient(Client& c) {
+        while(!c.readPaused && !c.heldBack) {
+            if(c.inUsed == c.in.size()) c.in.resize(c.in.size() * 2);
+            ssize_t n = ::recv(c.fd, c.in.data() + c.inUsed, c.in.size() - c.inUsed, 0);
+            if(n == 0) return false;
+            if(n < 0) {
+                if(errno == EAGAIN || errno == EWOULDBLOCK) break;
+                if(errno == EINTR) continue;
+                return false;
+            }
+            c.inUsed += (size_t)n;
+            bytesIn += (uint64_t)n;
+            if(!processInput(c)) return false;
+            if(c.pendingOutput() > OUTPUT_LIMIT) break;
+        }
+        queueOutput(c);
+        return true;
+    }
+
+    void acceptClients() {
+        while(true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if(fd < 0) return;
+            if(tcp) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            }
+            Client* c = new Client(fd);
+            clients[fd] = c;
+            epoll_event ev;
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+            connections++;
+        }
+    }
+
+    // Stream new bus events to every subscribed client
+    void broadcastUpdates() {
+        if(!cursor) return;
+        bus->poll(*cursor, [&](const MatchEvent& e) {
+            // Clients hear about conflicts; agreement is the normal case
+            if(e.kind == MatchEventKind::CONSENSUS) return;
+            for(auto& entry : clients) {
+                Client& c = *entry.second;
+                if(!c.subscribed) continue;
+                WireWriter out(c.out);
+                writeUpdate(out, e);
+                updatesSent++;
+                queueOutput(c);
+            }
+        });
+    }
+
+    bool bindAndListen(int fd, const sockaddr* addr, socklen_t length) {
+        if(::bind(fd, addr, length) != 0 || ::listen(fd, 128) != 0 || !setNonBlocking(fd)) {
+            ::close(fd);
+            return false;
+        }
+        listenFd = fd;
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = listenFd;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev) == 0;
+    }
+
+public:
+    ScoringServer(Scorebook& book)
+        : scorebook(book), ownBus(4096), bus(book.getEventBus()), cursor(nullptr), listenFd(-1),
+          epollFd(epoll_create1(EPOLL_CLOEXEC)), tcp(false), connections(0), entriesAccepted(0),
+          entriesRejected(0), entriesDuplicate(0), entriesThrottled(0), updatesSent(0), bytesIn(0), bytesOut(0) {
+        // Without a bus of its own the scorebook publishes to ours, along with the match deliveries
+        if(!bus) {
+            bus = &ownBus;
+            scorebook.setEventBus(bus);
+            if(scorebook.getMatch()) scorebook.getMatch()->addDeliveryListener(bus);
+        }
+        cursor = bus->subscribe("scoring server", SlowConsumerPolicy::DROP);
+    }
+
+    ~ScoringServer() {
+        close();
+        if(bus == &ownBus) {
+            scorebook.setEventBus(nullptr);
+            if(scorebook.getMatch()) scorebook.getMatch()->removeDeliveryListener(bus);
+        } else {
+            bus->unsubscribe(cursor);
+        }
+        if(epollFd >= 0) ::close(epollFd);
+    }
+
+    // No copies: owns sockets
+    ScoringServer(const ScoringServer&) = delete;
+    ScoringServer& operator=(const ScoringServer&) = delete;
+
+    // Listen on a loopback TCP port or a Unix socket path
+    bool listen(const string& address) {
+        if(epollFd < 0 || listenFd >= 0) return false;
+        tcp = isTcpAddress(address);
+        if(tcp) {
+            int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if(fd < 0) return false;
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons((uint16_t)atoi(address.c_str()));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            return bindAndListen(fd, (sockaddr*)&addr, sizeof(addr));
+        }
+
+        sockaddr_un addr;
+        if(address.size() >= sizeof(addr.sun_path)) return false;
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(fd < 0) return false;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, address.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(address.c_str());
+        unixPath = address;
+        return bindAndListen(fd, (sockaddr*)&addr, sizeof(addr));
+    }
+
+    // Wait up to timeoutMs for socket activity and handle all of it
+    void pollOnce(int timeoutMs) {
+        epoll_event events[MAX_EVENTS];
+        int n = epoll_wait(epollFd, events, MAX_EVENTS, holdTimeout(timeoutMs));
+        for(int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if(fd == listenFd) {
+                acceptClients();
+                continue;
+            }
+            auto it = clients.find(fd);
+            if(it == clients.end()) continue;
+            Client* c = it->second;
+            bool alive = true;
+            if(events[i].events & EPOLLOUT) alive = flushClient(*c);
+            // A held client that hangs up would otherwise wake every poll until released
+            if(alive && c->heldBack && (events[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))) alive = false;
+            if(alive && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) alive = readClient(*c);
+            if(!alive) closeClient(c);
+        }
+        releaseHeldClients();
+
+        broadcastUpdates();
+        vector<Client*> writes;
+        writes.swap(pendingWrites);
+        for(auto c : writes) {
+            if(!flushClient(*c)) closeClient(c);
+        }
+    }
+
+    void run(const atomic<bool>& stop, int timeoutMs = 50) {
+        while(!stop.load(memory_order_acquire)) pollOnce(timeoutMs);
+    }
+
+    void close() {
+        vector<Client*> all;
+        for(auto& entry : clients) all.push_back(entry.second);
+        for(auto c : all) closeClient(c);
+        if(listenFd >= 0) {
+            ::close(listenFd);
+            listenFd = -1;
+            if(!unixPath.empty()) ::unlink(unixPath.c_str());
+        }
+    }
+
+    void displayStats() const {
+        cout << "Scoring server: " << connections << " connections (" << clients.size() << " open), "
+             << entriesAccepted << " entries accepted, " << entriesRejected << " rejected, "
+             << entriesDuplicate << " retries dropped, " << entriesThrottled << " throttled, "
+             << updatesSent << " updates sent, " << bytesIn / 1024 << " KB in, "
+             << bytesOut / 1024 << " KB out" << endl;
+    }
+
+    size_t getClientCount() const { return clients.size(); }
+    uint64_t getEntriesAccepted() const { return entriesAccepted; }
+    uint64_t getEntriesRejected() const { return entriesRejected; }
+    uint64_t getEntriesDuplicate() const { return entriesDuplicate; }
+    uint64_t getEntriesThrottled() const { return entriesThrottled; }
+    uint64_t getUpdatesSent() const { return updatesSent; }
+};
+
+// Blocking client connection, used by scorer tools and the load generator
+class ScoringClient {
+private:
+    int fd;
+    vector<char> in;
+    size_t inUsed;
+
+public:
+    ScoringClient() : fd(-1), in(64 * 1024), inUsed(0) {}
+    ~ScoringClient() { close(); }
+
+    // No copies: owns a socket
+    ScoringClient(const ScoringClient&) = delete;
+    ScoringClient& operator=(const ScoringClient&) = delete;
+
+    bool connect(const string& address) {
+        if(isTcpAddress(address)) {
+            fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if(fd < 0) return false;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons((uint16_t)atoi(address.c_str()));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if(::connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0) return true;
+        } else {
+            sockaddr_un addr;
+            if(address.size() >= sizeof(addr.sun_path)) return false;
+            fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if(fd < 0) return false;
+            memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            strncpy(addr.sun_path, address.c_str(), sizeof(addr.sun_path) - 1);
+            if(::connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0) return true;
+        }
+        close();
+        return false;
+    }
+
+    bool send(const vector<char>& bytes) {
+        size_t sent = 0;
+        while(sent < bytes.size()) {
+            ssize_t n = ::send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+            if(n < 0 && errno == EINTR) continue;
+            if(n <= 0) return false;
+            sent += (size_t)n;
+        }
+        return true;
+    }
+
+    // Block until some data arrives, then pass each complete frame to fn(const FrameView&)
+    template<typename Fn>
+    bool receive(Fn fn) {
+        if(inUsed == in.size()) in.resize(in.size() * 2);
+        ssize_t n;
+        do {
+            n = ::recv(fd, in.data() + inUsed, in.size() - inUsed, 0);
+        } while(n < 0 && errno == EINTR);
+        if(n <= 0) return false;
+        inUsed += (size_t)n;
+
+        size_t offset = 0;
+        FrameView frame;
+        long taken;
+        while((taken = parseFrame(in.data() + offset, inUsed - offset, frame)) > 0) {
+            fn(frame);
+            offset += (size_t)taken;
+        }
+        if(taken < 0) return false;
+        memmove(in.data(), in.data() + offset, inUsed - offset);
+        inUsed -= offset;
+        return true;
+    }
+
+    void close() {
+        if(fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    bool isConnected() const { return fd >= 0; }
+};
+
+struct LoadTestResult {
+    uint64_t entries;
+    uint64_t conflictAcks;
+    uint64_t rejectedAcks;
+    uint64_t duplicateAcks;
+    uint64_t throttledAcks;
+    uint64_t updates;
+    double seconds;
+    double p50Micros;
+    double p99Micros;
+    double maxMicros;
+    bool ok;
+
+    LoadTestResult() : entries(0), conflictAcks(0), rejectedAcks(0), duplicateAcks(0), throttledAcks(0), updates(0),
+                       seconds(0),
+                       p50Micros(0), p99Micros(0), maxMicros(0), ok(true) {}
+
+    double getEntriesPerSecond() const { return seconds > 0 ? entries / seconds : 0; }
+
+    void display() const {
+        cout << "  " << entries << " entries in " << seconds * 1e3 << " ms: "
+             << getEntriesPerSecond() / 1e3 << "K entries/s" << endl;
+        cout << "  Ack latency: p50 " << p50Micros << " us, p99 " << p99Micros << " us, max "
+             << maxMicros << " us" << endl;
+        cout << "  " << conflictAcks << " conflict acks, " << rejectedAcks << " rejected, "
+             << duplicateAcks << " retries dropped, " << throttledAcks << " throttled and resent, " << updates << " updates streamed to the subscriber" << (ok ? "" : " - CONNECTION ERRORS") << endl;
+    }
+};
+
+// Many scorer clients, each keeping up to window entries in flight.
+// Every client scores the same balls; about one reading in disagreeEvery
+// differs, which produces conflicts, and one entry in retryEvery is sent
+// twice, as a client retrying after a timeout would. Throttled entries
+// are resent once the server's back-off has passed. Client 0 subscribes
+// to updates.
+inline LoadTestResult runScoringLoad(const string& address, int clientCount, int entriesPerClient,
+                                     int window = 32, int disagreeEvery = 500, int retryEvery = 0) {
+    typedef chrono::steady_clock Clock;
+    vector<thread> threads;
+    vector<vector<double>> latencies(clientCount);
+    vector<LoadTestResult> results(clientCount);
+    Clock::time_point start = Clock::now();
+
+    for(int t = 0; t < clientCount; t++) {
+        threads.push_back(thread([&, t]() {
+            LoadTestResult& r = results[t];
+            ScoringClient client;
+            if(!client.connect(address)) {
+                r.ok = false;
+                return;
+            }
+            vector<char> out;
+            WireWriter writer(out);
+            writeHello(writer, "scorer" + to_string(t), "Scorer " + to_string(t), t == 0 ? HELLO_SUBSCRIBE : 0);
+
+            vector<Clock::time_point> sentAt(entriesPerClient);
+            vector<bool> ackSeen(entriesPerClient, false);
+            vector<double>& lat = latencies[t];
+            lat.reserve(entriesPerClient);
+            vector<uint32_t> throttled;
+            Clock::time_point resumeAt = Clock::now();
+            auto writeEntry = [&](int n) {
+                WireEntry e;
+                e.seq = (uint32_t)n + 1;
+                e.overNumber = n / 6 + 1;
+                e.ballNumber = (uint8_t)(n % 6 + 1);
+                e.runs = (uint8_t)((n * 7) % 5);
+                if(disagreeEvery > 0 && (n + t * 13) % disagreeEvery == 0) e.runs = 6;
+                e.outcome = (uint8_t)(e.runs == 6 ? BallOutcome::SIX : e.runs == 4 ? BallOutcome::FOUR
+                                      : (BallOutcome)e.runs);
+                e.timestamp = (int64_t)time(0);
+                e.write(writer);
+            };
+            int sent = 0, frames = 0, acks = 0;
+            while(sent < entriesPerClient || acks < frames || !throttled.empty()) {
+                if(acks == frames && Clock::now() < resumeAt) this_thread::sleep_until(resumeAt);
+                if(Clock::now() >= resumeAt) {
+                    while(!throttled.empty() && frames - acks < window) {
+                        writeEntry((int)throttled.back() - 1);
+                        throttled.pop_back();
+                        frames++;
+                    }
+                    while(sent < entriesPerClient && frames - acks < window) {
+                        writeEntry(sent);
+                        frames++;
+                        if(retryEvery > 0 && sent % retryEvery == retryEvery - 1) {
+                            writeEntry(sent);
+                            frames++;
+                        }
+                        sentAt[sent++] = Clock::now();
+                    }
+                }
+                if(acks == frames) continue;
+                if(!out.empty()) {
+                    if(!client.send(out)) { r.ok = false; return; }
+                    out.clear();
+                }
+                bool alive = client.receive([&](const FrameView& f) {
+                    if(f.type == FRAME_ACK) {
+                        WireReader in(f);
+                        uint32_t seq = in.u32() - 1;
+                        uint8_t status = in.u8();
+                        acks++;
+                        if(status == ACK_THROTTLED) {
+                            r.throttledAcks++;
+                            Clock::time_point retryAt = Clock::now() + chrono::milliseconds(in.u32());
+                            if(retryAt > resumeAt) resumeAt = retryAt;
+                            if(seq < (uint32_t)entriesPerClient && !ackSeen[seq]) throttled.push_back(seq + 1);
+                            return;
+                        }
+                        if(seq < (uint32_t)entriesPerClient && !ackSeen[seq]) {
+                            ackSeen[seq] = true;
+                            lat.push_back(chrono::duration<double, micro>(Clock::now() - sentAt[seq]).count());
+                            r.entries++;
+                        }
+                        if(status == ACK_CONFLICT) r.conflictAcks++;
+                        else if(status == ACK_REJECTED) r.rejectedAcks++;
+                        else if(status == ACK_DUPLICATE) r.duplicateAcks++;
+                    } else if(f.type == FRAME_UPDATE) {
+                        r.updates++;
+                    }
+                });
+                if(!alive) { r.ok = false; return; }
+            }
+        }));
+    }
+    for(auto& t : threads) t.join();
+
+    LoadTestResult total;
+    total.seconds = chrono::duration<double>(Clock::now() - start).count();
+    vector<double> all;
+    for(int t = 0; t < clientCount; t++) {
+        total.entries += results[t].entries;
+        total.conflictAcks += results[t].conflictAcks;
+        total.rejectedAcks += results[t].rejectedAcks;
+        total.duplicateAcks += results[t].duplicateAcks;
+        total.throttledAcks += results[t].throttledAcks;
+        total.updates += results[t].updates;
+        total.ok = total.ok && results[t].ok;
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+    }
+    if(!all.empty()) {
+        sort(all.begin(), all.end());
+        total.p50Micros = all[all.size() / 2];
+        total.p99Micros = all[min(all.size() - 1, all.size() * 99 / 100)];
+        total.maxMicros = all.back();
+    }
+    return total;
+}
+
+#endif // __linux__
+
+#endif
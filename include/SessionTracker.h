@@ -0,0 +1,153 @@
+#ifndef SESSIONTRACKER_H
+#define SESSIONTRACKER_H
+
+#include "Ball.h"
+#include <vector>
+#include <ctime>
+
+// Counters for one session (or one day) of a multi-day match
+struct SessionStats {
+    int legalBalls;
+    int runs;
+    int wickets;
+    time_t firstBall;
+    time_t lastBall;
+
+    SessionStats() : legalBalls(0), runs(0), wickets(0), firstBall(0), lastBall(0) {}
+
+    void addBall(const Ball* ball) {
+        if(ball->getIsValid()) legalBalls++;
+        runs += ball->getTotalRuns();
+        if(ball->getWicketType() != WicketType::NONE) wickets++;
+        if(firstBall == 0) firstBall = ball->getTimestamp();
+        lastBall = ball->getTimestamp();
+    }
+
+    int getOvers() const { return legalBalls / 6; }
+    int getBallsInOver() const { return legalBalls % 6; }
+};
+
+// Places each delivery into its day and session from the ball timestamp and
+// keeps per-session and per-day counters, so summaries and over-rate checks
+// are lookups instead of replays of the whole match.
+//
+// Standard day: three 2-hour sessions with a 40-minute lunch and a
+// 20-minute tea interval, starting at the same time each day.
+class SessionTracker {
+public:
+    static const int SESSIONS_PER_DAY = 3;
+    static const int SESSION_SECONDS = 2 * 3600;
+    static const int LUNCH_SECONDS = 40 * 60;
+    static const int TEA_SECONDS = 20 * 60;
+
+private:
+    time_t playStart; // Start of play on day 1; 0 until the first ball
+    int maxDays;
+    int minOversPerDay;
+    vector<SessionStats> sessions; // maxDays * SESSIONS_PER_DAY
+    vector<SessionStats> days;
+    int currentDay;     // 1-based
+    int currentSession; // 1-based
+
+    static int sessionStartOffset(int session) {
+        switch(session) {
+            case 0: return 0;
+            case 1: return SESSION_SECONDS + LUNCH_SECONDS;
+            default: return 2 * SESSION_SECONDS + LUNCH_SECONDS + TEA_SECONDS;
+        }
+    }
+
+public:
+    SessionTracker(time_t start = 0, int numDays = 5, int minOvers = 90)
+        : playStart(start), maxDays(numDays), minOversPerDay(minOvers),
+          sessions(numDays * SESSIONS_PER_DAY), days(numDays),
+          currentDay(1), currentSession(1) {}
+
+    static int getScheduledSecondsPerDay() {
+        return sessionStartOffset(SESSIONS_PER_DAY - 1) + SESSION_SECONDS;
+    }
+
+    void addBall(const Ball* ball) {
+        if(playStart == 0) playStart = ball->getTimestamp();
+        long elapsed = (long)(ball->getTimestamp() - playStart);
+        if(elapsed < 0) elapsed = 0;
+
+        int day = (int)(elapsed / 86400);
+        if(day >= maxDays) day = maxDays - 1;
+        long offset = elapsed - (long)day * 86400;
+
+        // Balls bowled during an interval or after close count as
+        // extra time in the session just finished
+        int session = 0;
+        while(session + 1 < SESSIONS_PER_DAY && offset >= sessionStartOffset(session + 1)) {
+            session++;
+        }
+
+        sessions[day * SESSIONS_PER_DAY + session].addBall(ball);
+        days[day].addBall(ball);
+        currentDay = day + 1;
+        currentSession = session + 1;
+    }
+
+    // Overs that should have been bowled by the last ball of the day,
+    // pro rata over scheduled playing time and capped at the daily minimum.
+    // Past days are measured the same way, so a day cut short by the end
+    // of an innings, the match or a stoppage only owes the time played.
+    int getRequiredOvers(int day) const {
+        const SessionStats& d = days[day - 1];
+        if(d.lastBall == 0) return 0;
+
+        long offset = (long)(d.lastBall - playStart) - (long)(day - 1) * 86400;
+        long playSeconds = 0;
+        for(int s = 0; s < SESSIONS_PER_DAY; s++) {
+            long into = offset - sessionStartOffset(s);
+            if(into <= 0) break;
+            playSeconds += into < SESSION_SECONDS ? into : SESSION_SECONDS;
+        }
+        // A late start owes nothing for the time lost before it
+        long played = (long)(d.lastBall - d.firstBall);
+        if(played < playSeconds) playSeconds = played;
+        int required = (int)(playSeconds * minOversPerDay / (SESSIONS_PER_DAY * SESSION_SECONDS));
+        return required < minOversPerDay ? required : minOversPerDay;
+    }
+
+    int getOverRateDeficit(int day) const {
+        int deficit = getRequiredOvers(day) - days[day - 1].getOvers();
+        return deficit > 0 ? deficit : 0;
+    }
+
+    int getTotalOverRateDeficit() const {
+        int total = 0;
+        for(int d = 1; d <= currentDay; d++) total += getOverRateDeficit(d);
+        return total;
+    }
+
+    void displayDaySummary(int day) const {
+        const SessionStats& d = days[day - 1];
+        cout << "\nDay " << day << ": " << d.runs << "/" << d.wickets << " in "
+             << d.getOvers() << "." << d.getBallsInOver() << " overs";
+        int deficit = getOverRateDeficit(day);
+        if(deficit > 0) cout << " (over-rate: " << deficit << " overs behind)";
+        cout << endl;
+        for(int s = 0; s < SESSIONS_PER_DAY; s++) {
+            const SessionStats& ss = getSession(day, s + 1);
+            if(ss.legalBalls == 0 && ss.runs == 0) continue;
+            cout << "  Session " << (s + 1) << ": " << ss.runs << "/" << ss.wickets
+                 << " in " << ss.getOvers() << "." << ss.getBallsInOver() << " overs" << endl;
+        }
+    }
+
+    // Getters (day and session are 1-based)
+    const SessionStats& getDay(int day) const { return days[day - 1]; }
+    const SessionStats& getSession(int day, int session) const {
+        return sessions[(day - 1) * SESSIONS_PER_DAY + (session - 1)];
+    }
+    int getCurrentDay() const { return currentDay; }
+    int getCurrentSession() const { return currentSession; }
+    int getMaxDays() const { return maxDays; }
+    time_t getPlayStart() const { return playStart; }
+
+    void setPlayStart(time_t start) { playStart = start; }
+};
+
+#endif
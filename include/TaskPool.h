@@ -0,0 +1,252 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <iostream>
+using namespace std;
+
+// Work-stealing thread pool shared by simulation, analytics and archive jobs.
+// Every worker owns a deque: it pushes and pops its own work at the back,
+// while idle workers steal the oldest tasks from the front of other deques.
+class TaskPool {
+private:
+    static const int STEAL_SPIN_ROUNDS = 16;    // Failed rounds before parking
+    static const int STEAL_PARK_MICROS = 200;
+
+    struct Worker {
+        mutex lock;
+        deque<function<void()>> tasks;
+        atomic<uint64_t> executed;
+        atomic<uint64_t> steals;
+
+        Worker() : executed(0), steals(0) {}
+    };
+
+    vector<unique_ptr<Worker>> workers;
+    vector<thread> threads;
+    mutex sleepLock;
+    condition_variable wake;
+    atomic<size_t> queued;
+    atomic<bool> stopping;
+    atomic<uint32_t> nextWorker;
+
+    // Index of the pool worker running on this thread, -1 elsewhere
+    static int& currentWorker() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    bool popLocal(size_t w, function<void()>& task) {
+        Worker& worker = *workers[w];
+        lock_guard<mutex> guard(worker.lock);
+        if(worker.tasks.empty()) return false;
+        task = move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, function<void()>& task) {
+        size_t n = workers.size();
+        for(size_t i = 1; i < n; i++) {
+            Worker& victim = *workers[(thief + i) % n];
+            unique_lock<mutex> guard(victim.lock, try_to_lock);
+            if(!guard.owns_lock() || victim.tasks.empty()) continue;
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            workers[thief]->steals++;
+            return true;
+        }
+        return false;
+    }
+
+    bool takeTask(size_t w, function<void()>& task) {
+        if(popLocal(w, task) || steal(w, task)) {
+            queued--;
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t w) {
+        currentWorker() = (int)w;
+        function<void()> task;
+        int idleRounds = 0;
+        while(true) {
+            if(takeTask(w, task)) {
+                task();
+                workers[w]->executed++;
+                idleRounds = 0;
+                continue;
+            }
+            // Tasks are counted but none was taken: they are still being
+            // pushed, or every victim's lock was busy. Yield a few rounds,
+            // then park until the next submit or a short timeout.
+            if(queued > 0) {
+                if(++idleRounds < STEAL_SPIN_ROUNDS) {
+                    this_thread::yield();
+                    continue;
+                }
+                idleRounds = 0;
+                unique_lock<mutex> guard(sleepLock);
+                wake.wait_for(guard, chrono::microseconds((int64_t)STEAL_PARK_MICROS));
+                continue;
+            }
+            idleRounds = 0;
+            unique_lock<mutex> guard(sleepLock);
+            wake.wait(guard, [this] { return queued > 0 || stopping; });
+            if(stopping && queued == 0) return;
+        }
+    }
+
+public:
+    TaskPool(size_t threadCount = 0) : queued(0), stopping(false), nextWorker(0) {
+        if(threadCount == 0) threadCount = thread::hardware_concurrency();
+        if(threadCount == 0) threadCount = 2;
+        for(size_t i = 0; i < threadCount; i++) {
+            workers.push_back(unique_ptr<Worker>(new Worker()));
+        }
+        for(size_t i = 0; i < threadCount; i++) {
+            threads.push_back(thread(&TaskPool::workerLoop, this, i));
+        }
+    }
+
+    ~TaskPool() {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for(auto& t : threads) t.join();
+    }
+
+    // Process-wide pool sized to the machine
+    static TaskPool& shared() {
+        static TaskPool pool;
+        return pool;
+    }
+
+    // Queue a task. With affinity >= 0 it goes to that worker's deque;
+    // otherwise to the calling worker's own deque, or round-robin from outside.
+    void submit(function<void()> task, int affinity = -1) {
+        size_t w;
+        if(affinity >= 0) {
+            w = (size_t)affinity % workers.size();
+        } else if(currentWorker() >= 0) {
+            w = (size_t)currentWorker();
+        } else {
+            w = nextWorker++ % workers.size();
+        }
+        // Count before publishing, so a thief's decrement never runs first
+        queued++;
+        {
+            lock_guard<mutex> guard(workers[w]->lock);
+            workers[w]->tasks.push_back(move(task));
+        }
+        {
+            lock_guard<mutex> guard(sleepLock);
+        }
+        wake.notify_one();
+    }
+
+    // Run one queued task on the calling thread if any is available.
+    // Lets a waiting thread help instead of blocking (and deadlocking when
+    // it is itself a worker).
+    bool runPendingTask() {
+        int self = currentWorker();
+        size_t w = self >= 0 ? (size_t)self : nextWorker++ % workers.size();
+        function<void()> task;
+        if(!takeTask(w, task)) return false;
+        task();
+        workers[w]->executed++;
+        return true;
+    }
+
+    // Call body(chunkBegin, chunkEnd) over [begin, end) split into grain-sized
+    // chunks, returning once every chunk has finished
+    void parallelFor(size_t begin, size_t end, size_t grain,
+                     const function<void(size_t, size_t)>& body) {
+        if(begin >= end) return;
+        if(grain == 0) grain = 1;
+        size_t chunks = (end - begin + grain - 1) / grain;
+        if(chunks == 1) {
+            body(begin, end);
+            return;
+        }
+
+        atomic<size_t> remaining(chunks);
+        for(size_t c = 0; c < chunks; c++) {
+            size_t lo = begin + c * grain;
+            size_t hi = lo + grain < end ? lo + grain : end;
+            submit([&body, &remaining, lo, hi] {
+                body(lo, hi);
+                remaining--;
+            });
+        }
+        while(remaining > 0) {
+            if(!runPendingTask()) this_thread::yield();
+        }
+    }
+
+    // Map each chunk to a partial result and fold the partials in chunk
+    // order, so the answer is deterministic for non-commutative combines
+    template<typename T, typename MapFn, typename CombineFn>
+    T parallelReduce(size_t begin, size_t end, size_t grain, T identity,
+                     MapFn mapChunk, CombineFn combine) {
+        if(begin >= end) return identity;
+        if(grain == 0) grain = 1;
+        size_t chunks = (end - begin + grain - 1) / grain;
+        vector<T> partials(chunks, identity);
+        parallelFor(0, chunks, 1, [&](size_t c0, size_t c1) {
+            for(size_t c = c0; c < c1; c++) {
+                size_t lo = begin + c * grain;
+                size_t hi = lo + grain < end ? lo + grain : end;
+                partials[c] = mapChunk(lo, hi);
+            }
+        });
+
+        T result = identity;
+        for(const auto& partial : partials) {
+            result = combine(result, partial);
+        }
+        return result;
+    }
+
+    // Tuning counters
+    size_t getWorkerCount() const { return workers.size(); }
+    size_t getQueuedTasks() const { return queued; }
+
+    size_t getQueueLength(size_t worker) {
+        lock_guard<mutex> guard(workers[worker]->lock);
+        return workers[worker]->tasks.size();
+    }
+
+    uint64_t getStealCount(size_t worker) const { return workers[worker]->steals; }
+    uint64_t getExecutedCount(size_t worker) const { return workers[worker]->executed; }
+
+    uint64_t getTotalSteals() const {
+        uint64_t total = 0;
+        for(const auto& w : workers) total += w->steals;
+        return total;
+    }
+
+    void displayStats() {
+        cout << "\n===== Task Pool =====" << endl;
+        cout << "Workers: " << workers.size() << " | Queued: " << getQueuedTasks() << endl;
+        for(size_t i = 0; i < workers.size(); i++) {
+            cout << "  Worker " << i << ": executed " << getExecutedCount(i)
+                 << ", stolen " << getStealCount(i)
+                 << ", queue " << getQueueLength(i) << endl;
+        }
+    }
+};
+
+#endif
@@ -4,12 +4,14 @@
 #include "Player.h"
 #include <vector>
 #include <algorithm>
+#include <unordered_map>
 
 class Team {
 private:
     string teamName;
     string country;
     vector<Player*> squad;
+    unordered_map<string, Player*> squadByName;
     vector<Player*> playingXI;
     vector<SupportStaff*> supportStaff;
     Player* captain;
@@ -31,6 +33,7 @@ public:
     
     void addPlayer(Player* player) {
         squad.push_back(player);
+        squadByName.insert(make_pair(player->getName(), player));
     }
     
     void addToPlayingXI(Player* player) {
@@ -60,12 +63,8 @@ public:
     }
     
     Player* findPlayerByName(string name) {
-        for(auto player : squad) {
-            if(player->getName() == name) {
-                return player;
-            }
-        }
-        return nullptr;
+        auto it = squadByName.find(name);
+        return it != squadByName.end() ? it->second : nullptr;
     }
     
     void displayTeam() const {
@@ -95,7 +94,7 @@ public:
     }
     
     // Getters
-    string getTeamName() const { return teamName; }
+    const string& getTeamName() const { return teamName; }
     string getCountry() const { return country; }
     const vector<Player*>& getPlayingXI() const { return playingXI; }
     const vector<Player*>& getSquad() const { return squad; }
@@ -0,0 +1,273 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "JsonWriter.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FAST_SCOREBOOK_TRACE_TSC 1
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+// Hot-path tracing, compiled in with -DFAST_SCOREBOOK_TRACE (make TRACE=1).
+// Without it TRACE_SPAN and TRACE_COUNTER expand to nothing.
+#ifdef FAST_SCOREBOOK_TRACE
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#define TRACE_COUNTER(name, value) Trace::counter(name, (int64_t)(value))
+#else
+#define TRACE_SPAN(name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#endif
+
+enum class TraceEventKind : uint32_t {
+    SPAN,
+    COUNTER
+};
+
+// Names must be string literals: only the pointer is kept
+struct TraceEvent {
+    const char* name;
+    uint64_t start;         // Ticks
+    uint64_t value;         // Spans: duration in ticks; counters: the value
+    TraceEventKind kind;
+};
+
+// One thread's events. Only the owning thread appends; a dump reads the
+// events below count, which is published after each one is written.
+// A full buffer drops new events rather than overwrite ones a dump may
+// be reading.
+class TraceBuffer {
+public:
+    static const size_t CAPACITY = 1 << 17;
+
+private:
+    unique_ptr<TraceEvent[]> events;
+    atomic<size_t> count;
+    atomic<uint64_t> dropped;
+    uint32_t threadIndex;
+    string threadName;
+
+public:
+    TraceBuffer(uint32_t index)
+        : events(new TraceEvent[CAPACITY]), count(0), dropped(0), threadIndex(index),
+          threadName("thread " + to_string(index)) {}
+
+    void add(const char* name, uint64_t start, uint64_t value, TraceEventKind kind) {
+        size_t n = count.load(memory_order_relaxed);
+        if(n == CAPACITY) {
+            dropped.store(dropped.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            return;
+        }
+        TraceEvent& e = events[n];
+        e.name = name;
+        e.start = start;
+        e.value = value;
+        e.kind = kind;
+        count.store(n + 1, memory_order_release);
+    }
+
+    size_t size() const { return count.load(memory_order_acquire); }
+    const TraceEvent& at(size_t i) const { return events[i]; }
+    uint64_t getDropped() const { return dropped.load(memory_order_relaxed); }
+    uint32_t getThreadIndex() const { return threadIndex; }
+    const string& getThreadName() const { return threadName; }
+    void setThreadName(const string& name) { threadName = name; }
+
+    // Only while no thread is recording
+    void clear() {
+        count.store(0, memory_order_relaxed);
+        dropped.store(0, memory_order_relaxed);
+    }
+};
+
+// Process-wide registry of per-thread buffers, and the Chrome trace-event
+// dump. Timestamps are TSC ticks on x86 (a few nanoseconds to read) and
+// steady_clock nanoseconds elsewhere; a dump converts them to
+// microseconds using the clock pair taken when tracing started. Buffers
+// of finished threads are kept so their events still reach the dump.
+class Trace {
+private:
+    struct Registry {
+        mutex lock;
+        vector<unique_ptr<TraceBuffer>> buffers;
+        chrono::steady_clock::time_point originTime;
+        uint64_t originTicks;
+
+        Registry() : originTime(chrono::steady_clock::now()), originTicks(Trace::now()) {}
+    };
+
+    static Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    static TraceBuffer* registerThread() {
+        Registry& r = registry();
+        lock_guard<mutex> lock(r.lock);
+        r.buffers.push_back(unique_ptr<TraceBuffer>(new TraceBuffer((uint32_t)r.buffers.size())));
+        return r.buffers.back().get();
+    }
+
+    static TraceBuffer* threadBuffer() {
+        static thread_local TraceBuffer* buffer = nullptr;
+        if(!buffer) buffer = registerThread();
+        return buffer;
+    }
+
+    // Ticks to nanoseconds since the registry was created
+    static uint64_t toNanos(uint64_t ticks, uint64_t originTicks, double nanosPerTick) {
+        return ticks > originTicks ? (uint64_t)((ticks - originTicks) * nanosPerTick) : 0;
+    }
+
+    static void micros(JsonWriter& out, uint64_t nanos) {
+        out.integer((int64_t)(nanos / 1000));
+        unsigned frac = (unsigned)(nanos % 1000);
+        out.ch('.');
+        out.ch((char)('0' + frac / 100));
+        out.ch((char)('0' + frac / 10 % 10));
+        out.ch((char)('0' + frac % 10));
+    }
+
+public:
+    static bool isCompiledIn() {
+#ifdef FAST_SCOREBOOK_TRACE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static uint64_t now() {
+#ifdef FAST_SCOREBOOK_TRACE_TSC
+        return __rdtsc();
+#else
+        return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // Start the clock pair; otherwise done by the first event
+    static void start() { registry(); }
+
+    static void span(const char* name, uint64_t startTicks, uint64_t endTicks) {
+        threadBuffer()->add(name, startTicks, endTicks - startTicks, TraceEventKind::SPAN);
+    }
+
+    static void counter(const char* name, int64_t value) {
+        threadBuffer()->add(name, now(), (uint64_t)value, TraceEventKind::COUNTER);
+    }
+
+    static void setThreadName(const string& name) { threadBuffer()->setThreadName(name); }
+
+    static uint64_t getEventCount() {
+        Registry& r = registry();
+        lock_guard<mutex> lock(r.lock);
+        uint64_t n = 0;
+        for(const auto& b : r.buffers) n += b->size();
+        return n;
+    }
+
+    static uint64_t getDropped() {
+        Registry& r = registry();
+        lock_guard<mutex> lock(r.lock);
+        uint64_t n = 0;
+        for(const auto& b : r.buffers) n += b->getDropped();
+        return n;
+    }
+
+    // Only while no thread is recording
+    static void reset() {
+        Registry& r = registry();
+        lock_guard<mutex> lock(r.lock);
+        for(auto& b : r.buffers) b->clear();
+    }
+
+    // Write every event recorded so far as Chrome trace-event JSON
+    // (chrome://tracing, Perfetto). Threads may keep recording meanwhile.
+    static bool writeChromeJson(const string& path) {
+        ofstream file(path.c_str(), ios::binary | ios::trunc);
+        if(!file.is_open()) return false;
+
+        Registry& r = registry();
+        lock_guard<mutex> lock(r.lock);
+        double elapsedNanos = (double)chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - r.originTime).count();
+        uint64_t elapsedTicks = now() - r.originTicks;
+        double nanosPerTick = elapsedTicks > 0 ? elapsedNanos / elapsedTicks : 1.0;
+
+        const size_t CHUNK = 64 * 1024;
+        vector<char> chunk(CHUNK + 1024);
+        JsonWriter out(chunk.data(), chunk.size());
+        bool first = true;
+        auto flushIfFull = [&]() {
+            if(out.size() < CHUNK) return;
+            file.write(chunk.data(), out.size());
+            out.reset();
+        };
+
+        out.lit("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+        for(const auto& b : r.buffers) {
+            uint32_t tid = b->getThreadIndex();
+            if(!first) out.ch(',');
+            first = false;
+            out.lit("\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+            out.integer(tid);
+            out.lit(",\"args\":{\"name\":");
+            out.str(b->getThreadName());
+            out.lit("}}");
+
+            size_t count = b->size();
+            for(size_t i = 0; i < count; i++) {
+                const TraceEvent& e = b->at(i);
+                out.lit(",\n{\"name\":");
+                out.str(e.name, strlen(e.name));
+                if(e.kind == TraceEventKind::SPAN) {
+                    out.lit(",\"ph\":\"X\",\"ts\":");
+                    micros(out, toNanos(e.start, r.originTicks, nanosPerTick));
+                    out.lit(",\"dur\":");
+                    micros(out, (uint64_t)(e.value * nanosPerTick));
+                } else {
+                    out.lit(",\"ph\":\"C\",\"ts\":");
+                    micros(out, toNanos(e.start, r.originTicks, nanosPerTick));
+                    out.lit(",\"args\":{\"value\":");
+                    out.integer((int64_t)e.value);
+                    out.ch('}');
+                }
+                out.lit(",\"pid\":1,\"tid\":");
+                out.integer(tid);
+                out.ch('}');
+                flushIfFull();
+            }
+        }
+        out.lit("\n]}\n");
+        file.write(chunk.data(), out.size());
+        return !out.overflowed() && file.good();
+    }
+};
+
+// Records a span from construction to destruction
+class TraceSpan {
+private:
+    const char* name;
+    uint64_t start;
+
+public:
+    TraceSpan(const char* n) : name(n), start(Trace::now()) {}
+    ~TraceSpan() { Trace::span(name, start, Trace::now()); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#endif
@@ -32,7 +32,7 @@ public:
     }
     
     // Getters
-    string getStadiumName() const { return stadiumName; }
+    const string& getStadiumName() const { return stadiumName; }
     string getCity() const { return city; }
     string getCountry() const { return country; }
     int getCapacity() const { return capacity; }
@@ -42,25 +42,41 @@ public:
     void setFloodlights(bool lights) { hasFloodlights = lights; }
 };
 
+class EventCursor;
+
 class BroadcastAgency {
 private:
     string agencyName;
     string region;
     string language;
+    EventCursor* feed;      // Match events, read through EventBus::catchUp
+    int ballsAired;
+    string lastAired;       // Score line of the latest delivery aired
     
 public:
-    BroadcastAgency() : agencyName(""), region(""), language("") {}
+    BroadcastAgency() : agencyName(""), region(""), language(""), feed(nullptr), ballsAired(0) {}
     
     BroadcastAgency(string name, string reg, string lang)
-        : agencyName(name), region(reg), language(lang) {}
+        : agencyName(name), region(reg), language(lang), feed(nullptr), ballsAired(0) {}
     
     void displayInfo() const {
         cout << "Broadcaster: " << agencyName 
              << " (Region: " << region << ", Language: " << language << ")" << endl;
+        if(ballsAired > 0) {
+            cout << "  Aired " << ballsAired << " deliveries, latest " << lastAired << endl;
+        }
+    }
+    
+    void airDelivery(const string& scoreLine) {
+        ballsAired++;
+        lastAired = scoreLine;
     }
     
+    void setFeed(EventCursor* cursor) { feed = cursor; }
+    EventCursor* getFeed() const { return feed; }
     string getAgencyName() const { return agencyName; }
     string getRegion() const { return region; }
+    int getBallsAired() const { return ballsAired; }
 };
 
 #endif
@@ -0,0 +1,2323 @@
+/*
+ * FAST-SCOREBOOK: Benchmarks
+ *
+ * Standalone load and throughput checks for the scoring engine.
+ * Run all benchmarks with `make bench`, or pass benchmark names
+ * on the command line to run only those.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include "../include/Match.h"
+#include "../include/PlayerRegistry.h"
+#include "../include/MatchScheduler.h"
+#include "../include/TaskPool.h"
+#include "../include/MatchSnapshot.h"
+#include "../include/MatchArchive.h"
+#include "../include/DeliveryQuery.h"
+#include "../include/CareerStats.h"
+#include "../include/MatchImporter.h"
+#include "../include/ColumnarExport.h"
+#include "../include/ScorecardJson.h"
+#include "../include/ScorecardDelta.h"
+#include "../include/Scorebook.h"
+#include "../include/ScorecardRenderer.h"
+#include "../include/ScoringServer.h"
+#include "../include/ScorebookReplica.h"
+#include "../include/ScorebookJournal.h"
+#include "../include/ConflictDesk.h"
+#include "../include/ScorebookNotifier.h"
+#include "../include/JsonReader.h"
+#include <sstream>
+#include <deque>
+
+using namespace std;
+
+typedef chrono::steady_clock BenchClock;
+
+double secondsSince(BenchClock::time_point start) {
+    return chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+// Every benchmark player lives in one registry
+PlayerRegistry benchRegistry;
+
+// Build a team of eleven generated players
+Team* createBenchTeam(string name, string prefix) {
+    Team* team = new Team(name, name);
+    for(int i = 0; i < 11; i++) {
+        string id = prefix + to_string(i + 1);
+        Player* player = benchRegistry.createPlayer(name + " Player " + to_string(i + 1), 25, name, id, i + 1);
+        player->addRole(i < 6 ? PlayerRole::BATSMAN : PlayerRole::BOWLER);
+        team->addPlayer(player);
+        team->addToPlayingXI(player);
+    }
+    return team;
+}
+
+void deleteBenchTeam(Team* team) {
+    delete team;
+}
+
+// Many concurrent T20 matches driven by the cooperative scheduler on one thread
+void benchScheduler() {
+    const int matchCount = 2000;
+    Team* home = createBenchTeam("Home", "HOM");
+    Team* away = createBenchTeam("Away", "AWY");
+    Venue venue("Bench Ground", "Karachi", "Pakistan", 30000);
+
+    vector<Match*> matches;
+    MatchScheduler scheduler;
+    for(int i = 0; i < matchCount; i++) {
+        Match* match = new T20Match("BENCH_T20_" + to_string(i), home, away, &venue);
+        matches.push_back(match);
+        scheduler.addMatch(match, i % 600); // Staggered start times
+    }
+
+    BenchClock::time_point start = BenchClock::now();
+    scheduler.run();
+    double elapsed = secondsSince(start);
+
+    uint64_t deliveries = scheduler.getDeliveriesPlayed();
+    cout << "\n[scheduler] " << matchCount << " T20 matches on one thread" << endl;
+    cout << "  Simulated time: " << scheduler.getElapsedSeconds() / 3600.0 << " h" << endl;
+    cout << "  Deliveries: " << deliveries << " in " << elapsed << " s ("
+         << (uint64_t)(deliveries / elapsed) << " deliveries/s)" << endl;
+    cout << "  Driver state per match: " << sizeof(MatchDriver) << " bytes" << endl;
+
+    for(auto match : matches) delete match;
+    deleteBenchTeam(home);
+    deleteBenchTeam(away);
+}
+
+// Monte Carlo: independent batches of simulated ODIs spread over the shared pool
+void benchTaskPool() {
+    const size_t batches = 64;
+    const size_t matchesPerBatch = 50;
+    Team* home = createBenchTeam("Home", "HOM");
+    Team* away = createBenchTeam("Away", "AWY");
+    Venue venue("Bench Ground", "Karachi", "Pakistan", 30000);
+    TaskPool& pool = TaskPool::shared();
+
+    struct Tally {
+        uint64_t deliveries;
+        uint64_t homeWins;
+    };
+    Tally zero = {0, 0};
+
+    BenchClock::time_point start = BenchClock::now();
+    Tally total = pool.parallelReduce(0, batches, 1, zero,
+        [&](size_t lo, size_t hi) {
+            Tally tally = zero;
+            for(size_t b = lo; b < hi; b++) {
+                vector<Match*> matches;
+                MatchScheduler scheduler(time(0) + b);
+                for(size_t i = 0; i < matchesPerBatch; i++) {
+                    Match* match = new ODIMatch("MC_" + to_string(b) + "_" + to_string(i), home, away, &venue);
+                    matches.push_back(match);
+                    scheduler.addMatch(match);
+                }
+                scheduler.run();
+                tally.deliveries += scheduler.getDeliveriesPlayed();
+                for(auto match : matches) {
+                    if(match->getWinner() == home) tally.homeWins++;
+                    delete match;
+                }
+            }
+            return tally;
+        },
+        [](Tally a, Tally b) {
+            a.deliveries += b.deliveries;
+            a.homeWins += b.homeWins;
+            return a;
+        });
+    double elapsed = secondsSince(start);
+
+    size_t matchCount = batches * matchesPerBatch;
+    cout << "\n[pool] Monte Carlo over " << matchCount << " ODIs on "
+         << pool.getWorkerCount() << " workers" << endl;
+    cout << "  Deliveries: " << total.deliveries << " in " << elapsed << " s ("
+         << (uint64_t)(total.deliveries / elapsed) << " deliveries/s)" << endl;
+    cout << "  Home win rate: " << (100.0 * total.homeWins / matchCount) << "%" << endl;
+    cout << "  Steals: " << pool.getTotalSteals() << endl;
+
+    deleteBenchTeam(home);
+    deleteBenchTeam(away);
+}
+
+// Registering and looking up a historical-scale player base
+void benchPlayerRegistry() {
+    const size_t playerCount = 300000;
+    PlayerRegistry registry;
+    registry.reserve(playerCount);
+
+    BenchClock::time_point start = BenchClock::now();
+    for(size_t i = 0; i < playerCount; i++) {
+        registry.createPlayer("Player " + to_string(i), 25, "Nowhere", "HIST" + to_string(i), (int)(i % 100));
+    }
+    double createTime = secondsSince(start);
+
+    vector<string> names;
+    for(size_t i = 0; i < playerCount; i += 7) names.push_back("Player " + to_string(i));
+
+    start = BenchClock::now();
+    size_t found = 0;
+    for(const auto& name : names) {
+        if(registry.findByName(name)) found++;
+    }
+    double lookupTime = secondsSince(start);
+
+    start = BenchClock::now();
+    uint64_t jerseySum = 0;
+    for(PlayerId id = 0; id < registry.size(); id++) {
+        jerseySum += registry.getPlayer(id)->getJerseyNumber();
+    }
+    double scanTime = secondsSince(start);
+
+    cout << "\n[registry] " << playerCount << " players" << endl;
+    cout << "  Create: " << createTime << " s" << endl;
+    cout << "  Name lookups: " << found << " in " << lookupTime * 1e3 << " ms ("
+         << (lookupTime * 1e9 / names.size()) << " ns each)" << endl;
+    cout << "  ID scan: " << scanTime * 1e3 << " ms (checksum " << jerseySum << ")" << endl;
+}
+
+// Writing a simulated five-day Test and reading it back through mmap
+void benchSnapshot() {
+    const int loadRounds = 2000;
+    const string path = "bench_snapshot.fsb";
+    Team* home = createBenchTeam("Home", "HOM");
+    Team* away = createBenchTeam("Away", "AWY");
+    Venue venue("Bench Ground", "Karachi", "Pakistan", 30000);
+
+    TestMatch match("BENCH_TEST", home, away, &venue);
+    MatchScheduler scheduler;
+    scheduler.addMatch(&match);
+    scheduler.run();
+
+    MatchSnapshotWriter writer;
+    BenchClock::time_point start = BenchClock::now();
+    bool written = writer.writeFile(match, path);
+    double writeTime = secondsSince(start);
+    if(!written) {
+        cout << "\n[snapshot] could not write " << path << endl;
+        return;
+    }
+
+    MatchSnapshot snapshot;
+    start = BenchClock::now();
+    for(int i = 0; i < loadRounds; i++) {
+        snapshot.open(path);
+    }
+    double loadTime = secondsSince(start) / loadRounds;
+
+    // Query in place: total runs and fours straight from the ball records
+    start = BenchClock::now();
+    uint64_t runs = 0, fours = 0;
+    uint32_t ballCount = snapshot.count(SECTION_BALLS);
+    const BallRecord* balls = snapshot.section<BallRecord>(SECTION_BALLS);
+    for(uint32_t i = 0; i < ballCount; i++) {
+        runs += balls[i].runs + balls[i].extras;
+        if(balls[i].outcome == (uint8_t)BallOutcome::FOUR) fours++;
+    }
+    double scanTime = secondsSince(start);
+
+    cout << "\n[snapshot] Test match, " << ballCount << " deliveries, "
+         << snapshot.getSize() / 1024 << " KB" << endl;
+    cout << "  Write: " << writeTime * 1e3 << " ms" << endl;
+    cout << "  Open + validate (mmap): " << loadTime * 1e6 << " us" << endl;
+    cout << "  In-place scan: " << scanTime * 1e6 << " us (" << runs << " runs, "
+         << fours << " fours)" << endl;
+
+    snapshot.close();
+    remove(path.c_str());
+    deleteBenchTeam(home);
+    deleteBenchTeam(away);
+}
+
+void removeArchiveFiles(const string& dir) {
+    const char* files[] = {"matches.dat", "catalog.dat", "names.dat", "people.dat", "players.dat"};
+    for(auto file : files) remove((dir + "/" + file).c_str());
+    remove(dir.c_str());
+}
+
+// Archive thousands of simulated matches, then query the secondary indexes
+void benchArchive() {
+    const string dir = "bench_archive";
+    const int teamCount = 8;
+    const int venueCount = 5;
+    const int batches = 20;
+    const int matchesPerBatch = 200;
+    const time_t firstDate = 1420070400; // 2015-01-01
+    const time_t lastDate = 1735689600;  // 2025-01-01
+    removeArchiveFiles(dir);
+
+    vector<Team*> teams;
+    for(int t = 0; t < teamCount; t++) {
+        teams.push_back(createBenchTeam("Team" + to_string(t), "T" + to_string(t) + "_"));
+    }
+    vector<Venue*> venues;
+    for(int v = 0; v < venueCount; v++) {
+        venues.push_back(new Venue("Ground " + to_string(v), "City", "Country", 20000));
+    }
+
+    MatchArchive archive;
+    archive.open(dir, &benchRegistry);
+    BenchClock::time_point start = BenchClock::now();
+    for(int b = 0; b < batches; b++) {
+        vector<Match*> matches;
+        MatchScheduler scheduler;
+        for(int i = 0; i < matchesPerBatch; i++) {
+            int n = b * matchesPerBatch + i;
+            Team* t1 = teams[n % teamCount];
+            Team* t2 = teams[(n / teamCount + n + 1) % teamCount];
+            if(t1 == t2) t2 = teams[(n + 1) % teamCount];
+            Venue* venue = venues[(n * 7) % venueCount];
+            string id = "ARC_" + to_string(n);
+            Match* match = (n % 3 == 0) ? (Match*)new ODIMatch(id, t1, t2, venue)
+                                        : (Match*)new T20Match(id, t1, t2, venue);
+            match->setMatchDate(firstDate + (time_t)((lastDate - firstDate) * (double)n / (batches * matchesPerBatch)));
+            matches.push_back(match);
+            scheduler.addMatch(match);
+        }
+        scheduler.run();
+        for(auto match : matches) {
+            archive.addMatch(*match);
+            delete match;
+        }
+    }
+    double buildTime = secondsSince(start);
+
+    start = BenchClock::now();
+    MatchArchive reopened;
+    reopened.open(dir, &benchRegistry);
+    double openTime = secondsSince(start);
+
+    const time_t since2020 = 1577836800;
+    start = BenchClock::now();
+    vector<uint32_t> odisAtVenue = reopened.query().ofType(MatchType::ODI).atVenue("Ground 2").run();
+    vector<uint32_t> teamSince = reopened.query().withTeam("Team3").since(since2020).run();
+    vector<uint32_t> playerAtVenue = reopened.query()
+        .withPlayer(teams[5]->getPlayingXI()[0]->getRegistryId()).atVenue("Ground 4").run();
+    double queryTime = secondsSince(start);
+
+    // Touch only the matching records: total runs across the ODIs at the venue
+    start = BenchClock::now();
+    uint64_t runs = 0;
+    MatchSnapshot snapshot;
+    for(auto n : odisAtVenue) {
+        if(!reopened.openSnapshot(n, snapshot)) continue;
+        for(uint32_t i = 0; i < snapshot.count(SECTION_INNINGS); i++) runs += snapshot.innings(i).totalRuns;
+    }
+    double readTime = secondsSince(start);
+
+    cout << "\n[archive] " << reopened.getMatchCount() << " matches" << endl;
+    cout << "  Build (simulate + append): " << buildTime << " s" << endl;
+    cout << "  Reopen + rebuild indexes: " << openTime * 1e3 << " ms" << endl;
+    cout << "  3 queries: " << queryTime * 1e6 << " us (" << odisAtVenue.size() << " ODIs at venue, "
+         << teamSince.size() << " team since 2020, " << playerAtVenue.size() << " player at venue)" << endl;
+    cout << "  Read matching snapshots: " << readTime * 1e3 << " ms (" << runs << " runs)" << endl;
+
+    // Another process knows the players only through the archive
+    MatchArchive fresh;
+    fresh.open(dir);
+    const Player* star = teams[5]->getPlayingXI()[0];
+    PlayerId freshId = fresh.getRegistry().getIdByPersonId(star->getId());
+    bool sameIndex = freshId == star->getRegistryId() &&
+                     fresh.query().withPlayer(freshId).atVenue("Ground 4").run() == playerAtVenue;
+    cout << "  Check: " << (sameIndex ? "player index keyed on the archive's own IDs" : "MISMATCH") << endl;
+
+    snapshot.close();
+    removeArchiveFiles(dir);
+    for(auto team : teams) deleteBenchTeam(team);
+    for(auto venue : venues) delete venue;
+}
+
+// Teams for the delivery benchmarks; every other batter is left-handed
+vector<Team*> createDeliveryBenchTeams(int teamCount) {
+    vector<Team*> teams;
+    for(int t = 0; t < teamCount; t++) {
+        teams.push_back(createBenchTeam("QTeam" + to_string(t), "Q" + to_string(t) + "_"));
+        const vector<Player*>& xi = teams.back()->getPlayingXI();
+        for(size_t i = 0; i < xi.size(); i += 2) xi[i]->setBattingStyle("Left-handed");
+    }
+    return teams;
+}
+
+// Simulate matchCount T20s between the given teams and append them to the archive
+void archiveBenchT20s(MatchArchive& archive, const vector<Team*>& teams, Venue* venue, int matchCount) {
+    int teamCount = (int)teams.size();
+    vector<Match*> matches;
+    MatchScheduler scheduler;
+    for(int n = 0; n < matchCount; n++) {
+        Team* t1 = teams[n % teamCount];
+        Team* t2 = teams[(n + 1 + n / teamCount) % teamCount];
+        if(t1 == t2) t2 = teams[(n + 1) % teamCount];
+        Match* match = new T20Match("QRY_" + to_string(n), t1, t2, venue);
+        matches.push_back(match);
+        scheduler.addMatch(match);
+    }
+    scheduler.run();
+    for(auto match : matches) {
+        archive.addMatch(*match);
+        delete match;
+    }
+}
+
+// Ad-hoc delivery queries over the columnar view of an archive
+void benchDeliveryQuery() {
+    const string dir = "bench_query";
+    const int matchCount = 400;
+    const int copies = 50; // Replicate the loaded partitions to reach millions of rows
+    removeArchiveFiles(dir);
+
+    vector<Team*> teams = createDeliveryBenchTeams(8);
+    Venue* venue = new Venue("Query Ground", "City", "Country", 20000);
+    MatchArchive archive;
+    archive.open(dir, &benchRegistry);
+    archiveBenchT20s(archive, teams, venue, matchCount);
+
+    BenchClock::time_point start = BenchClock::now();
+    vector<DeliveryColumns> loaded = loadDeliveryPartitions(archive, 25);
+    double loadTime = secondsSince(start);
+
+    vector<DeliveryColumns> partitions;
+    for(int c = 0; c < copies; c++) {
+        partitions.insert(partitions.end(), loaded.begin(), loaded.end());
+    }
+    size_t rows = 0;
+    for(const auto& p : partitions) rows += p.size();
+
+    // Death-overs spell of one bowler against left-handers, grouped by outcome
+    PlayerId bowler = teams[1]->getPlayingXI().back()->getRegistryId();
+    DeliveryQuery deathOvers;
+    deathOvers.byBowler(bowler).toLeftHanders().inOvers(16, 20).groupedBy(DeliveryGroupBy::OUTCOME);
+
+    // Best of five, against a naive row-at-a-time scan
+    DeliveryQuery::Result result, naive;
+    double queryTime = 1e9, naiveTime = 1e9;
+    for(int repeat = 0; repeat < 5; repeat++) {
+        start = BenchClock::now();
+        result = deathOvers.run(partitions);
+        queryTime = min(queryTime, secondsSince(start));
+
+        start = BenchClock::now();
+        naive.clear();
+        for(const auto& p : partitions) {
+            for(size_t i = 0; i < p.size(); i++) {
+                if(p.bowler[i] == bowler && (p.flags[i] & DELIVERY_LEFT_HANDED_BATTER) &&
+                   p.over[i] >= 16 && p.over[i] <= 20) {
+                    naive[p.outcome[i]].deliveries++;
+                }
+            }
+        }
+        naiveTime = min(naiveTime, secondsSince(start));
+    }
+
+    uint64_t matched = 0;
+    for(const auto& g : result) matched += g.second.deliveries;
+    uint64_t naiveMatched = 0;
+    for(const auto& g : naive) naiveMatched += g.second.deliveries;
+
+    DeliveryQuery wicketsByType;
+    wicketsByType.groupedBy(DeliveryGroupBy::WICKET_TYPE).withOutcome(BallOutcome::WICKET);
+    start = BenchClock::now();
+    DeliveryQuery::Result wickets = wicketsByType.run(partitions);
+    double wicketTime = secondsSince(start);
+
+    // Edge filters: an unknown player is a value like any other, and a
+    // reversed over range is empty
+    uint64_t unknownBowler = 0, naiveUnknown = 0;
+    for(const auto& g : DeliveryQuery().byBowler(INVALID_PLAYER_ID).run(loaded)) unknownBowler += g.second.deliveries;
+    for(const auto& p : loaded) {
+        for(size_t i = 0; i < p.size(); i++) naiveUnknown += p.bowler[i] == INVALID_PLAYER_ID;
+    }
+    bool reversedEmpty = DeliveryQuery().inOvers(20, 16).run(loaded).empty();
+
+    cout << "\n[query] " << rows << " deliveries in " << partitions.size() << " partitions" << endl;
+    cout << "  Load from archive: " << loadTime * 1e3 << " ms (" << loaded.size() << " partitions)" << endl;
+    cout << "  Bowler vs left-handers, overs 16-20: " << queryTime * 1e3 << " ms, "
+         << matched << " deliveries (" << deathOvers.getScannedRows(partitions) / queryTime / 1e6
+         << "M rows/s scanned, " << rows / queryTime / 1e6 << "M logical rows/s)" << endl;
+    cout << "  Row-at-a-time scan: " << naiveTime * 1e3 << " ms, " << naiveMatched << " deliveries" << endl;
+    cout << "  Wickets by type: " << wicketTime * 1e3 << " ms" << endl;
+    cout << "  Check: " << (matched == naiveMatched && matched > 0 && unknownBowler == naiveUnknown &&
+                            reversedEmpty ? "pushdown matches the row scan" : "MISMATCH") << endl;
+    deathOvers.displayResult(result);
+    wicketsByType.displayResult(wickets);
+
+    removeArchiveFiles(dir);
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+}
+
+// Recompute every player's career stats from raw deliveries
+void benchCareerStats() {
+    const string dir = "bench_career";
+    const int matchCount = 400;
+    const int copies = 100; // About ten million deliveries
+    removeArchiveFiles(dir);
+
+    vector<Team*> teams = createDeliveryBenchTeams(8);
+    Venue* venue = new Venue("Career Ground", "City", "Country", 20000);
+    MatchArchive archive;
+    archive.open(dir, &benchRegistry);
+    archiveBenchT20s(archive, teams, venue, matchCount);
+
+    vector<DeliveryColumns> loaded = loadDeliveryPartitions(archive, 25);
+    vector<DeliveryColumns> partitions;
+    for(int c = 0; c < copies; c++) {
+        partitions.insert(partitions.end(), loaded.begin(), loaded.end());
+    }
+    size_t rows = 0;
+    for(const auto& p : partitions) rows += p.size();
+
+    BenchClock::time_point start = BenchClock::now();
+    CareerStatsBuilder builder;
+    builder.build(partitions, benchRegistry.size());
+    double buildTime = secondsSince(start);
+
+    cout << "\n[career] " << rows << " deliveries, " << builder.getPlayerCount() << " players" << endl;
+    cout << "  Group by player: " << buildTime * 1e3 << " ms" << endl;
+
+    // Same computation at each kernel level the CPU supports
+    DeliveryKernels::Level best = DeliveryKernels::getLevel();
+    vector<CareerLine> reference;
+    for(int level = DeliveryKernels::SCALAR; level <= best; level++) {
+        DeliveryKernels::setLevel((DeliveryKernels::Level)level);
+        start = BenchClock::now();
+        vector<CareerLine> lines = builder.compute();
+        double computeTime = secondsSince(start);
+
+        bool matches = true;
+        if(reference.empty()) {
+            reference = lines;
+        } else {
+            for(size_t p = 0; p < lines.size(); p++) {
+                if(lines[p].runsScored != reference[p].runsScored ||
+                   lines[p].ballsBowled != reference[p].ballsBowled ||
+                   lines[p].wicketsTaken != reference[p].wicketsTaken ||
+                   lines[p].fours != reference[p].fours) matches = false;
+            }
+        }
+        cout << "  " << DeliveryKernels::getLevelString((DeliveryKernels::Level)level) << " kernels: "
+             << computeTime * 1e3 << " ms (" << rows / computeTime / 1e9 << "G deliveries/s)"
+             << (matches ? "" : " MISMATCH") << endl;
+    }
+    DeliveryKernels::setLevel(best);
+
+    // Row-at-a-time accumulation straight from the partitions
+    start = BenchClock::now();
+    vector<CareerLine> naive(benchRegistry.size());
+    for(const auto& p : partitions) {
+        for(size_t i = 0; i < p.size(); i++) {
+            bool bye = p.outcome[i] == (uint8_t)BallOutcome::BYE || p.outcome[i] == (uint8_t)BallOutcome::LEG_BYE;
+            int runs = bye ? 0 : p.runs[i];
+            if(p.batter[i] < naive.size()) {
+                CareerLine& bat = naive[p.batter[i]];
+                bat.runsScored += runs;
+                if(p.outcome[i] == (uint8_t)BallOutcome::FOUR) bat.fours++;
+            }
+            if(p.bowler[i] < naive.size()) {
+                CareerLine& bowl = naive[p.bowler[i]];
+                bowl.runsConceded += runs + p.extras[i];
+                if(p.flags[i] & DELIVERY_VALID) bowl.ballsBowled++;
+                if(isBowlerWicket((WicketType)p.wicketType[i])) bowl.wicketsTaken++;
+            }
+        }
+    }
+    double naiveTime = secondsSince(start);
+    cout << "  Row-at-a-time (runs, fours, balls, conceded, wickets only): " << naiveTime * 1e3 << " ms" << endl;
+    bool wicketsMatch = true;
+    for(size_t p = 0; p < naive.size() && p < reference.size(); p++) {
+        if(naive[p].wicketsTaken != reference[p].wicketsTaken) wicketsMatch = false;
+    }
+    cout << "  Check: " << (wicketsMatch ? "bowler wickets match the row scan" : "MISMATCH") << endl;
+
+    const CareerLine& sample = reference[teams[0]->getPlayingXI()[0]->getRegistryId()];
+    cout << "  Sample batter: " << sample.runsScored << " runs, SR " << sample.getStrikeRate()
+         << ", boundaries " << sample.getBoundaryPercentage() << "%" << endl;
+
+    removeArchiveFiles(dir);
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+}
+
+// Packed versus full delivery records in the archive
+void benchDeliveryCodec() {
+    const string packedDir = "bench_packed";
+    const string fullDir = "bench_full";
+    const int matchCount = 600;
+    removeArchiveFiles(packedDir);
+    removeArchiveFiles(fullDir);
+
+    vector<Team*> teams = createDeliveryBenchTeams(8);
+    Venue* venue = new Venue("Codec Ground", "City", "Country", 20000);
+    vector<Match*> matches;
+    MatchScheduler scheduler;
+    for(int n = 0; n < matchCount; n++) {
+        Team* t1 = teams[n % teams.size()];
+        Team* t2 = teams[(n + 3) % teams.size()];
+        string id = "PCK_" + to_string(n);
+        Match* match = (n % 4 == 0) ? (Match*)new ODIMatch(id, t1, t2, venue)
+                                    : (Match*)new T20Match(id, t1, t2, venue);
+        matches.push_back(match);
+        scheduler.addMatch(match);
+    }
+    scheduler.run();
+
+    MatchArchive packed, full;
+    packed.open(packedDir, &benchRegistry);
+    full.open(fullDir, &benchRegistry);
+    packed.setPackDeliveries(true);
+    full.setPackDeliveries(false);
+    BenchClock::time_point start = BenchClock::now();
+    for(auto match : matches) packed.addMatch(*match);
+    double packTime = secondsSince(start);
+    start = BenchClock::now();
+    for(auto match : matches) full.addMatch(*match);
+    double fullTime = secondsSince(start);
+    for(auto match : matches) delete match;
+
+    // Every packed match must unpack to exactly the original records
+    uint64_t deliveries = 0, fullDeliveryBytes = 0, packedDeliveryBytes = 0;
+    int mismatches = 0;
+    MatchSnapshot a, b;
+    vector<OverRecord> overs;
+    vector<BallRecord> balls;
+    for(uint32_t n = 0; n < (uint32_t)matchCount; n++) {
+        if(!full.openSnapshot(n, a) || !packed.openSnapshot(n, b) || !DeliveryCodec::unpack(b, overs, balls)) {
+            mismatches++;
+            continue;
+        }
+        deliveries += balls.size();
+        fullDeliveryBytes += a.count(SECTION_OVERS) * sizeof(OverRecord) + a.count(SECTION_BALLS) * sizeof(BallRecord);
+        packedDeliveryBytes += b.count(SECTION_PACKED_DELIVERIES);
+        if(balls.size() != a.count(SECTION_BALLS) || overs.size() != a.count(SECTION_OVERS) ||
+           (!balls.empty() && memcmp(balls.data(), &a.ball(0), balls.size() * sizeof(BallRecord)) != 0) ||
+           (!overs.empty() && memcmp(overs.data(), &a.over(0), overs.size() * sizeof(OverRecord)) != 0)) {
+            mismatches++;
+        }
+    }
+    a.close();
+    b.close();
+
+    // Scans from the archive, alternating formats; best of three
+    double fullScan = 1e9, packedScan = 1e9;
+    size_t rows = 0;
+    for(int repeat = 0; repeat < 3; repeat++) {
+        start = BenchClock::now();
+        vector<DeliveryColumns> fromFull = loadDeliveryPartitions(full, 25);
+        fullScan = min(fullScan, secondsSince(start));
+        start = BenchClock::now();
+        vector<DeliveryColumns> fromPacked = loadDeliveryPartitions(packed, 25);
+        packedScan = min(packedScan, secondsSince(start));
+        rows = 0;
+        for(const auto& p : fromPacked) rows += p.size();
+    }
+
+    // The same with every snapshot already open and paged in, so only
+    // decoding is timed; best of five
+    double decodeTime[2];
+    for(int pass = 0; pass < 2; pass++) {
+        MatchArchive& archive = pass == 0 ? full : packed;
+        vector<MatchSnapshot> open(matchCount);
+        for(uint32_t n = 0; n < (uint32_t)matchCount; n++) archive.openSnapshot(n, open[n]);
+        decodeTime[pass] = 1e9;
+        for(int repeat = 0; repeat < 6; repeat++) {
+            DeliveryColumns columns;
+            start = BenchClock::now();
+            for(uint32_t n = 0; n < (uint32_t)matchCount; n++) columns.appendSnapshot(open[n], n, 0);
+            if(repeat > 0) decodeTime[pass] = min(decodeTime[pass], secondsSince(start));
+            if(columns.size() != rows) mismatches++;
+        }
+    }
+
+    cout << "\n[codec] " << matchCount << " matches, " << deliveries << " deliveries"
+         << (mismatches ? " - ROUND TRIP MISMATCH" : ", round trip exact") << endl;
+    cout << "  Delivery data: " << fullDeliveryBytes / 1024 << " KB full, " << packedDeliveryBytes / 1024
+         << " KB packed (" << (double)fullDeliveryBytes / packedDeliveryBytes << "x, "
+         << (double)packedDeliveryBytes / deliveries << " bytes/delivery)" << endl;
+    cout << "  matches.dat: " << full.getMatchesSize() / 1024 << " KB full, " << packed.getMatchesSize() / 1024
+         << " KB packed (" << (double)full.getMatchesSize() / packed.getMatchesSize() << "x)" << endl;
+    cout << "  Append: " << fullTime * 1e3 << " ms full, " << packTime * 1e3 << " ms packed" << endl;
+    cout << "  Load into columns: " << fullScan * 1e3 << " ms full, " << packedScan * 1e3 << " ms packed ("
+         << rows << " rows)" << endl;
+    cout << "  Decode open snapshots: " << decodeTime[0] / rows * 1e9 << " ns/delivery full, "
+         << decodeTime[1] / rows * 1e9 << " ns/delivery packed" << endl;
+
+    removeArchiveFiles(packedDir);
+    removeArchiveFiles(fullDir);
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+}
+
+// Write a simulated match as a Cricsheet-style JSON file
+void writeCricsheetFile(Match* match, const string& path) {
+    static const char* kinds[] = {
+        "", "bowled", "caught", "lbw", "run out", "stumped", "hit wicket",
+        "caught and bowled", "caught", "obstructing the field", "hit the ball twice", "timed out"
+    };
+    ofstream out(path.c_str());
+    Team* teams[2] = {match->getTeam1(), match->getTeam2()};
+    out << "{\"meta\": {\"data_version\": \"1.1.0\"}, \"info\": {";
+    out << "\"city\": \"" << match->getVenue()->getCity() << "\", \"dates\": [\"2024-01-01\"], ";
+    out << "\"match_type\": \"" << (match->getMatchType() == MatchType::ODI ? "ODI" : "T20") << "\", ";
+    if(match->getWinner()) {
+        out << "\"outcome\": {\"winner\": \"" << match->getWinner()->getTeamName() << "\", \"by\": {\"runs\": 1}}, ";
+    }
+    out << "\"players\": {";
+    for(int t = 0; t < 2; t++) {
+        out << (t ? ", " : "") << "\"" << teams[t]->getTeamName() << "\": [";
+        const vector<Player*>& xi = teams[t]->getPlayingXI();
+        for(size_t i = 0; i < xi.size(); i++) out << (i ? ", " : "") << "\"" << xi[i]->getName() << "\"";
+        out << "]";
+    }
+    out << "}, \"registry\": {\"people\": {";
+    for(int t = 0; t < 2; t++) {
+        const vector<Player*>& xi = teams[t]->getPlayingXI();
+        for(size_t i = 0; i < xi.size(); i++) {
+            out << (t || i ? ", " : "") << "\"" << xi[i]->getName() << "\": \"" << xi[i]->getId() << "\"";
+        }
+    }
+    out << "}}, \"teams\": [\"" << teams[0]->getTeamName() << "\", \"" << teams[1]->getTeamName() << "\"], ";
+    out << "\"toss\": {\"decision\": \"bat\", \"winner\": \"" << teams[0]->getTeamName() << "\"}, ";
+    out << "\"venue\": \"" << match->getVenue()->getStadiumName() << "\"}, \"innings\": [";
+
+    const vector<Innings*>& innings = match->getAllInnings();
+    for(size_t n = 0; n < innings.size(); n++) {
+        out << (n ? ", " : "") << "{\"team\": \"" << innings[n]->getBattingTeam()->getTeamName() << "\", \"overs\": [";
+        const vector<Over*>& overs = innings[n]->getOvers();
+        for(size_t o = 0; o < overs.size(); o++) {
+            out << (o ? ", " : "") << "{\"over\": " << o << ", \"deliveries\": [";
+            const vector<Ball*>& balls = overs[o]->getBalls();
+            for(size_t b = 0; b < balls.size(); b++) {
+                const Ball* ball = balls[b];
+                int batterRuns = ball->getRuns();
+                const char* extraKind = nullptr;
+                int extraRuns = ball->getExtras();
+                switch(ball->getOutcome()) {
+                    case BallOutcome::WIDE: extraKind = "wides"; break;
+                    case BallOutcome::NO_BALL: extraKind = "noballs"; break;
+                    case BallOutcome::BYE: extraKind = "byes"; extraRuns = batterRuns; batterRuns = 0; break;
+                    case BallOutcome::LEG_BYE: extraKind = "legbyes"; extraRuns = batterRuns; batterRuns = 0; break;
+                    default: break;
+                }
+                out << (b ? ", " : "") << "{\"batter\": \"" << ball->getBatsman()->getName()
+                    << "\", \"bowler\": \"" << ball->getBowler()->getName()
+                    << "\", \"non_striker\": \"" << ball->getNonStriker()->getName() << "\", ";
+                if(extraKind) out << "\"extras\": {\"" << extraKind << "\": " << extraRuns << "}, ";
+                out << "\"runs\": {\"batter\": " << batterRuns << ", \"extras\": " << (extraKind ? extraRuns : 0)
+                    << ", \"total\": " << batterRuns + (extraKind ? extraRuns : 0) << "}";
+                if(ball->getWicketType() != WicketType::NONE) {
+                    out << ", \"wickets\": [{\"player_out\": \"" << ball->getBatsman()->getName()
+                        << "\", \"kind\": \"" << kinds[(int)ball->getWicketType()] << "\"";
+                    if(ball->getFielder()) out << ", \"fielders\": [{\"name\": \"" << ball->getFielder()->getName() << "\"}]";
+                    out << "}]";
+                }
+                out << "}";
+            }
+            out << "]}";
+        }
+        out << "]}";
+    }
+    out << "]}\n";
+}
+
+// Bulk import of ball-by-ball JSON files
+void benchImporter() {
+    const string dir = "bench_import";
+    const int matchCount = 1000;
+#ifdef _WIN32
+    _mkdir(dir.c_str());
+#else
+    mkdir(dir.c_str(), 0755);
+#endif
+
+    vector<Team*> teams = createDeliveryBenchTeams(8);
+    Venue* venue = new Venue("Import Ground", "City", "Country", 20000);
+    vector<Match*> matches;
+    MatchScheduler scheduler;
+    for(int n = 0; n < matchCount; n++) {
+        Team* t1 = teams[n % teams.size()];
+        Team* t2 = teams[(n + 5) % teams.size()];
+        string id = "IMP_" + to_string(n);
+        Match* match = (n % 5 == 0) ? (Match*)new ODIMatch(id, t1, t2, venue)
+                                    : (Match*)new T20Match(id, t1, t2, venue);
+        matches.push_back(match);
+        scheduler.addMatch(match);
+    }
+    scheduler.run();
+
+    vector<string> files;
+    vector<int> expectedRuns;
+    uint64_t expectedDeliveries = 0;
+    for(int n = 0; n < matchCount; n++) {
+        files.push_back(dir + "/" + to_string(100000 + n) + ".json");
+        writeCricsheetFile(matches[n], files.back());
+        int runs = 0;
+        for(auto inn : matches[n]->getAllInnings()) {
+            runs += inn->getTotalRuns();
+            for(auto over : inn->getOvers()) expectedDeliveries += over->getBalls().size();
+        }
+        expectedRuns.push_back(runs);
+        delete matches[n];
+    }
+
+    // Imported players are separate from the simulation's registry
+    PlayerRegistry registry;
+    MatchImporter importer(registry);
+    int mismatches = 0;
+    size_t next = 0;
+    importer.importFiles(MatchImporter::listJsonFiles(dir), [&](Match* match) {
+        int runs = 0;
+        for(auto inn : match->getAllInnings()) runs += inn->getTotalRuns();
+        if(next >= expectedRuns.size() || runs != expectedRuns[next]) mismatches++;
+        next++;
+        delete match;
+    });
+
+    const ImportStats& stats = importer.getStats();
+    cout << "\n[import] " << stats.files << " files, " << stats.bytes / (1024 * 1024) << " MB, "
+         << stats.deliveries << " deliveries" << endl;
+    cout << "  Parse (" << TaskPool::shared().getWorkerCount() << " threads): " << stats.parseSeconds * 1e3 << " ms ("
+         << stats.bytes / stats.parseSeconds / (1024 * 1024) << " MB/s)" << endl;
+    cout << "  Build Match objects: " << stats.buildSeconds * 1e3 << " ms" << endl;
+    cout << "  Throughput: " << stats.getDeliveriesPerSecond() / 1e6 << "M deliveries/s" << endl;
+    cout << "  Check: " << (stats.deliveries == expectedDeliveries && mismatches == 0 && stats.failedFiles == 0
+                            ? "all totals match" : "MISMATCH") << " (" << registry.size() << " players)" << endl;
+
+    // Two import runs into one archive, each with the registry the archive
+    // loads: the second run's players must keep the first run's IDs
+    const string archiveDir = "bench_import_archive";
+    removeArchiveFiles(archiveDir);
+    vector<string> listed = MatchImporter::listJsonFiles(dir);
+    size_t half = listed.size() / 2;
+    bool added = true;
+    for(int run = 0; run < 2; run++) {
+        MatchArchive archive;
+        archive.open(archiveDir);
+        MatchImporter runImporter(archive.getRegistry());
+        // The second run meets the teams in a different order
+        vector<string> part = run == 0 ? vector<string>(listed.begin(), listed.begin() + half)
+                                       : vector<string>(listed.rbegin(), listed.rend() - half);
+        runImporter.importFiles(part, [&](Match* match) {
+            if(archive.addMatch(*match) == INVALID_MATCH_NO) added = false;
+            delete match;
+        });
+    }
+    MatchArchive reopened;
+    reopened.open(archiveDir);
+    bool idsAgree = added && reopened.getMatchCount() == listed.size();
+    MatchSnapshot snapshot;
+    for(uint32_t n = 0; n < reopened.getMatchCount() && idsAgree; n++) {
+        if(!reopened.openSnapshot(n, snapshot)) {
+            idsAgree = false;
+            break;
+        }
+        for(uint32_t i = 0; i < snapshot.count(SECTION_PLAYERS); i++) {
+            const PlayerRecord& p = snapshot.player(i);
+            const Player* known = reopened.getRegistry().getPlayer(p.registryId);
+            if(!known || known->getId() != snapshot.getString(p.personId)) idsAgree = false;
+        }
+    }
+    snapshot.close();
+    cout << "  Check: " << (idsAgree ? "player IDs stable across import runs" : "MISMATCH")
+         << " (" << reopened.getRegistry().size() << " players)" << endl;
+    removeArchiveFiles(archiveDir);
+
+    for(const auto& file : files) remove(file.c_str());
+    remove(dir.c_str());
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+}
+
+// Export archived and live deliveries to the columnar format and read them back
+void benchColumnarExport() {
+    const string dir = "bench_export";
+    const string archivePath = "bench_export_archive.fsbc";
+    const string livePath = "bench_export_live.fsbc";
+    const int matchCount = 400;
+    removeArchiveFiles(dir);
+
+    vector<Team*> teams = createDeliveryBenchTeams(8);
+    Venue* venue = new Venue("Export Ground", "City", "Country", 20000);
+    vector<Match*> matches;
+    MatchScheduler scheduler;
+    for(int n = 0; n < matchCount; n++) {
+        Team* t1 = teams[n % teams.size()];
+        Team* t2 = teams[(n + 5) % teams.size()];
+        Match* match = new T20Match("EXP_" + to_string(n), t1, t2, venue);
+        matches.push_back(match);
+        scheduler.addMatch(match);
+    }
+    scheduler.run();
+
+    MatchArchive archive;
+    archive.open(dir, &benchRegistry);
+    for(auto match : matches) archive.addMatch(*match);
+
+    // From the live Innings/Over/Ball model
+    ColumnarWriter live(16384);
+    live.open(livePath);
+    BenchClock::time_point start = BenchClock::now();
+    for(size_t n = 0; n < matches.size(); n++) live.addMatch(*matches[n], (uint32_t)n);
+    live.close();
+    double liveTime = secondsSince(start);
+    for(auto match : matches) delete match;
+
+    // From the archive, one snapshot at a time
+    ColumnarWriter writer(16384);
+    writer.open(archivePath);
+    start = BenchClock::now();
+    uint64_t rows = writer.addArchive(archive);
+    writer.close();
+    double exportTime = secondsSince(start);
+
+    // Read both back column by column
+    uint64_t readRows[2] = {0, 0}, runs[2] = {0, 0};
+    size_t players = 0;
+    start = BenchClock::now();
+    const string paths[2] = {archivePath, livePath};
+    for(int f = 0; f < 2; f++) {
+        ColumnarReader reader;
+        if(!reader.open(paths[f])) continue;
+        while(reader.nextBatch()) {
+            const uint8_t* r = reader.column<uint8_t>(COL_RUNS);
+            const uint8_t* e = reader.column<uint8_t>(COL_EXTRAS);
+            for(uint32_t i = 0; i < reader.getRows(); i++) runs[f] += r[i] + e[i];
+            readRows[f] += reader.getRows();
+        }
+        if(f == 0) players = reader.getDictionary(DICTIONARY_PLAYERS).size();
+    }
+    double readTime = secondsSince(start);
+
+    size_t rowBytes = 0;
+    for(int c = 0; c < DELIVERY_COLUMN_COUNT; c++) rowBytes += deliveryColumnSchema()[c].type;
+
+    cout << "\n[export] " << matchCount << " matches, " << rows << " deliveries, "
+         << writer.getBatchCount() << " batches of up to 16384 rows" << endl;
+    cout << "  Archive export: " << exportTime * 1e3 << " ms (" << rows / exportTime / 1e6 << " M rows/s), "
+         << writer.getBytesWritten() / 1024 << " KB, " << writer.getPlayerCount() << " dictionary players" << endl;
+    cout << "  Live model export: " << liveTime * 1e3 << " ms (" << live.getRowCount() << " rows)" << endl;
+    cout << "  Batch buffers: " << 16384 * rowBytes / 1024 << " KB (" << rowBytes << " bytes/row)" << endl;
+    cout << "  Read back both files: " << readTime * 1e3 << " ms" << endl;
+    cout << "  Check: " << (readRows[0] == rows && readRows[1] == rows && runs[0] == runs[1] &&
+                            players == writer.getPlayerCount() ? "rows and runs match" : "MISMATCH") << endl;
+
+    remove(archivePath.c_str());
+    remove(livePath.c_str());
+    removeArchiveFiles(dir);
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+}
+
+// Full ODI scorecard as JSON, compared with the text scorecard
+void benchScorecardJson() {
+    const int iterations = 20000;
+    vector<Team*> teams = createDeliveryBenchTeams(2);
+    Venue* venue = new Venue("JSON Ground", "City", "Country", 20000);
+    ODIMatch* match = new ODIMatch("JSON_ODI", teams[0], teams[1], venue);
+    MatchScheduler scheduler;
+    scheduler.addMatch(match);
+    scheduler.run();
+
+    size_t deliveries = 0;
+    for(auto innings : match->getAllInnings()) {
+        for(auto over : innings->getOvers()) deliveries += over->getBalls().size();
+    }
+
+    vector<char> buffer(256 * 1024);
+    size_t length = 0;
+    BenchClock::time_point start = BenchClock::now();
+    for(int i = 0; i < iterations; i++) {
+        length = ScorecardJson::serialize(*match, buffer.data(), buffer.size());
+    }
+    double jsonTime = secondsSince(start) / iterations;
+
+    start = BenchClock::now();
+    size_t summaryLength = 0;
+    for(int i = 0; i < iterations; i++) {
+        summaryLength = ScorecardJson::serialize(*match, buffer.data(), buffer.size(), ScorecardDetail::SUMMARY);
+    }
+    double summaryTime = secondsSince(start) / iterations;
+
+    // The existing text output, captured instead of printed
+    const int textIterations = 200;
+    ostringstream text;
+    streambuf* saved = cout.rdbuf(text.rdbuf());
+    start = BenchClock::now();
+    for(int i = 0; i < textIterations; i++) {
+        text.str("");
+        match->displayFullMatch();
+    }
+    double textTime = secondsSince(start) / textIterations;
+    cout.rdbuf(saved);
+
+    // Output must be one well-formed JSON document; a short buffer must be refused
+    length = ScorecardJson::serialize(*match, buffer.data(), buffer.size());
+    JsonReader reader(buffer.data(), length);
+    bool valid = length > 0 && reader.skipValue() && reader.atEnd();
+    bool refused = ScorecardJson::serialize(*match, buffer.data(), length - 1) == 0;
+
+    cout << "\n[json] ODI scorecard, " << deliveries << " deliveries, " << length << " bytes" << endl;
+    cout << "  Full (every ball): " << jsonTime * 1e6 << " us (" << length / jsonTime / 1e6 << " MB/s)" << endl;
+    cout << "  Summary: " << summaryTime * 1e6 << " us (" << summaryLength << " bytes)" << endl;
+    cout << "  displayFullMatch to a string: " << textTime * 1e6 << " us" << endl;
+    cout << "  Check: " << (valid && refused ? "valid JSON, short buffer refused" : "INVALID OUTPUT") << endl;
+
+    delete match;
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+}
+
+// Re-record every delivery of a finished match into a fresh one
+void replayDeliveries(const Match& source, Match& replay) {
+    for(auto innings : source.getAllInnings()) {
+        Innings* live = replay.startNewInnings(innings->getBattingTeam(), innings->getBowlingTeam());
+        for(auto over : innings->getOvers()) {
+            live->startOver(over->getBowler());
+            for(auto ball : over->getBalls()) replay.recordBall(new Ball(*ball));
+        }
+    }
+}
+
+ODIMatch* replayMatch(const Match& source, DeliveryListener* listener) {
+    ODIMatch* replay = new ODIMatch(source.getMatchId(), source.getTeam1(), source.getTeam2(), source.getVenue());
+    if(listener) replay->addDeliveryListener(listener);
+    replayDeliveries(source, *replay);
+    return replay;
+}
+
+// Per-delivery deltas against replaying the same ODI without a feed
+void benchScorecardDelta() {
+    const int replays = 400;
+    vector<Team*> teams = createDeliveryBenchTeams(2);
+    Venue* venue = new Venue("Delta Ground", "City", "Country", 20000);
+    ODIMatch* source = new ODIMatch("DELTA_ODI", teams[0], teams[1], venue);
+    MatchScheduler scheduler;
+    scheduler.addMatch(source);
+    scheduler.run();
+
+    BenchClock::time_point start = BenchClock::now();
+    for(int r = 0; r < replays; r++) delete replayMatch(*source, nullptr);
+    double plainTime = secondsSince(start);
+
+    // Encoding alone: the feed is the only listener
+    uint64_t messages = 0, bytes = 0;
+    start = BenchClock::now();
+    for(int r = 0; r < replays; r++) {
+        ScorecardFeed feed(nullptr);
+        delete replayMatch(*source, &feed);
+        messages += feed.getSequence();
+        bytes += feed.getBytesEncoded();
+    }
+    double feedTime = secondsSince(start);
+    double encodeTime = max(feedTime - plainTime, 1e-9);
+
+    // One mirror applies every delta, one only catches up every 100 deliveries
+    class Subscribers : public DeliveryListener {
+    public:
+        ScorecardFeed feed;
+        ScorecardMirror everyBall, lagging;
+        uint64_t applyCount;
+        double applyTime;
+        bool inSync;
+
+        Subscribers() : feed(nullptr, 64), applyCount(0), applyTime(0), inSync(true) {}
+
+        void onDelivery(const Match& match, const Innings& innings, const Ball& ball) override {
+            feed.onDelivery(match, innings, ball);
+            char buffer[DELTA_MAX_MESSAGE];
+            size_t length = feed.next(everyBall.getSequence(), buffer, sizeof(buffer));
+            BenchClock::time_point t = BenchClock::now();
+            if(everyBall.apply(buffer, length) != DeltaResult::APPLIED) inSync = false;
+            applyTime += secondsSince(t);
+            applyCount++;
+            if(!everyBall.matches(innings)) inSync = false;
+            if(feed.getSequence() % 100 == 0) {
+                lagging.catchUp(feed);
+                if(!lagging.matches(innings)) inSync = false;
+            }
+        }
+    } subscribers;
+    delete replayMatch(*source, &subscribers);
+
+    char snapshot[4096];
+    size_t snapshotLength = subscribers.feed.writeSnapshot(snapshot, sizeof(snapshot));
+    size_t jsonLength = ScorecardJson::serialize(*source, snapshot, sizeof(snapshot), ScorecardDetail::SUMMARY);
+
+    cout << "\n[delta] ODI replayed " << replays << " times, " << messages << " deltas" << endl;
+    cout << "  Encode: " << messages / encodeTime / 1e6 << "M msgs/s (" << encodeTime / messages * 1e9
+         << " ns each), " << (double)bytes / messages << " bytes/msg" << endl;
+    cout << "  Apply: " << subscribers.applyCount / subscribers.applyTime / 1e6 << "M msgs/s" << endl;
+    cout << "  Resync snapshot: " << snapshotLength << " bytes (JSON summary alone: " << jsonLength << " bytes)" << endl;
+    cout << "  Check: " << (subscribers.inSync ? "mirrors match the live innings" : "MIRROR OUT OF SYNC")
+         << " (" << subscribers.lagging.getResyncCount() << " lagging resyncs)" << endl;
+
+    delete source;
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+}
+
+// Publish cost against subscriber count, then threaded consumers
+void benchEventBus() {
+    const uint64_t events = 2000000;
+    MatchEvent event;
+
+    cout << "\n[bus] " << events << " events per run" << endl;
+    const int subscriberCounts[] = {0, 1, 4, 16, 64};
+    for(int subscribers : subscriberCounts) {
+        EventBus bus(4096);
+        for(int i = 0; i < subscribers; i++) bus.subscribe("idle " + to_string(i));
+        BenchClock::time_point start = BenchClock::now();
+        for(uint64_t i = 0; i < events; i++) {
+            event.runs = (int32_t)(i & 7);
+            bus.publish(event);
+        }
+        double elapsed = secondsSince(start);
+        cout << "  Publish, " << setw(2) << subscribers << " idle subscribers: "
+             << elapsed / events * 1e9 << " ns/event" << endl;
+    }
+
+    // Two BLOCK consumers must see every event in order; DROP consumers may skip
+    EventBus bus(4096);
+    struct Consumer {
+        EventCursor* cursor;
+        uint64_t expected;
+        uint64_t outOfOrder;
+        int slowEvery;
+    };
+    Consumer consumers[4] = {
+        {bus.subscribe("archiver", SlowConsumerPolicy::BLOCK), 0, 0, 0},
+        {bus.subscribe("scoreboard", SlowConsumerPolicy::BLOCK), 0, 0, 0},
+        {bus.subscribe("broadcaster", SlowConsumerPolicy::DROP), 0, 0, 0},
+        {bus.subscribe("slow website", SlowConsumerPolicy::DROP), 0, 0, 64}
+    };
+    atomic<bool> stop(false);
+    vector<thread> threads;
+    for(auto& c : consumers) {
+        threads.push_back(thread([&bus, &c, &stop]() {
+            uint64_t seen = 0;
+            while(true) {
+                bool done = stop.load(memory_order_acquire);
+                bus.waitAndPoll(*c.cursor, [&](const MatchEvent& e) {
+                    if(e.sequence < c.expected || (c.cursor->getPolicy() == SlowConsumerPolicy::BLOCK &&
+                                                   e.sequence != c.expected)) c.outOfOrder++;
+                    c.expected = e.sequence + 1;
+                    if(c.slowEvery && ++seen % c.slowEvery == 0) this_thread::yield();
+                }, stop, 256);
+                if(done && bus.getBacklog(*c.cursor) == 0) break;
+            }
+        }));
+    }
+    BenchClock::time_point start = BenchClock::now();
+    for(uint64_t i = 0; i < events; i++) bus.publish(event);
+    stop.store(true, memory_order_release);
+    for(auto& t : threads) t.join();
+    double elapsed = secondsSince(start);
+
+    bool ordered = true;
+    for(auto& c : consumers) ordered = ordered && c.outOfOrder == 0;
+    bool complete = consumers[0].cursor->getReceived() == events && consumers[1].cursor->getReceived() == events;
+    cout << "  Threaded, 2 block + 2 drop consumers: " << events / elapsed / 1e6 << "M events/s end to end ("
+         << TaskPool::shared().getWorkerCount() << " cores)" << endl;
+    bus.displaySubscribers();
+
+    // A replayed ODI and a scorebook conflict go through the same bus
+    EventBus matchBus(1024);
+    EventCursor* commentary = matchBus.subscribe("commentary", SlowConsumerPolicy::BLOCK);
+    vector<Team*> teams = createDeliveryBenchTeams(2);
+    Venue* venue = new Venue("Bus Ground", "City", "Country", 20000);
+    ODIMatch* source = new ODIMatch("BUS_ODI", teams[0], teams[1], venue);
+    MatchScheduler scheduler;
+    scheduler.addMatch(source);
+    scheduler.run();
+
+    uint64_t counts[3] = {0, 0, 0};
+    size_t deliveries = 0;
+    int wickets = 0;
+    for(auto innings : source->getAllInnings()) {
+        for(auto over : innings->getOvers()) deliveries += over->getBalls().size();
+        wickets += innings->getTotalWickets();
+    }
+
+    // The match's broadcasters and commentators each get their own cursor
+    ODIMatch* replay = new ODIMatch(source->getMatchId(), teams[0], teams[1], venue);
+    BroadcastAgency tv("Bench TV", "Country", "English"), radio("Bench Radio", "Country", "English");
+    Commentator caller("Bench Caller", 50, "Country", "COM1", "English", "Radio");
+    replay->addBroadcaster(&tv);
+    replay->addBroadcaster(&radio);
+    replay->addCommentator(&caller);
+    matchBus.attach(*replay);
+    replayDeliveries(*source, *replay);
+    Supervisor supervisor("Bench Supervisor", 50, "Country", "SUP1", "supervisor");
+    Scorebook scorebook(replay, &supervisor);
+    scorebook.setEventBus(&matchBus);
+    ScoreEntry a("u1", "Scorer 1", 1, 1, BallOutcome::FOUR, 4, 0, WicketType::NONE);
+    ScoreEntry b("u2", "Scorer 2", 1, 1, BallOutcome::SIX, 6, 0, WicketType::NONE);
+    streambuf* saved = cout.rdbuf(nullptr);
+    scorebook.addScoreEntry(a);
+    scorebook.addScoreEntry(b);
+    scorebook.resolveConflict(1, 1, a);
+    cout.rdbuf(saved);
+    matchBus.poll(*commentary, [&](const MatchEvent& e) { counts[(int)e.kind]++; });
+    matchBus.catchUp(tv);
+    matchBus.catchUp(radio);
+    matchBus.catchUp(caller);
+    cout << "  Match bus: " << counts[0] << " deliveries, " << counts[1] << " conflicts, "
+         << counts[2] << " resolutions; broadcasters aired " << tv.getBallsAired() << " and "
+         << radio.getBallsAired() << ", commentator called " << caller.getBallsCalled() << " ("
+         << caller.getWicketsCalled() << " wickets)" << endl;
+
+    bool audience = tv.getBallsAired() == (int)deliveries && radio.getBallsAired() == (int)deliveries &&
+                    caller.getBallsCalled() == (int)deliveries && caller.getWicketsCalled() == wickets;
+    cout << "  Check: " << (ordered && complete && counts[0] == deliveries && counts[1] == 1 && counts[2] == 1 &&
+                            audience ? "block consumers saw every event in order, audience every delivery"
+                                     : "MISMATCH") << endl;
+
+    delete replay;
+    delete source;
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+}
+
+// Counts bytes, write calls and flushes reaching the stream
+class CountingBuffer : public streambuf {
+public:
+    uint64_t bytes, writes, flushes;
+    CountingBuffer() : bytes(0), writes(0), flushes(0) {}
+
+protected:
+    int overflow(int c) override {
+        if(c != EOF) { bytes++; writes++; }
+        return c;
+    }
+    streamsize xsputn(const char*, streamsize n) override {
+        bytes += n;
+        writes++;
+        return n;
+    }
+    int sync() override {
+        flushes++;
+        return 0;
+    }
+};
+
+// Refresh the full scorecard after every ball of an ODI, old and new way
+void benchScorecardRenderer() {
+    vector<Team*> teams = createDeliveryBenchTeams(2);
+    Venue* venue = new Venue("Render Ground", "City", "Country", 20000);
+    ODIMatch* source = new ODIMatch("RENDER_ODI", teams[0], teams[1], venue);
+    MatchScheduler scheduler;
+    scheduler.addMatch(source);
+    scheduler.run();
+
+    // Renders the screen from a listener so every refresh sees a live, partial match
+    class Refresher : public DeliveryListener {
+    public:
+        ScorecardRenderer renderer;
+        CountingBuffer streamed, rendered;
+        ostream streamedOut, renderedOut;
+        double streamTime, renderTime;
+        size_t refreshes;
+        bool identical;
+
+        Refresher() : streamedOut(&streamed), renderedOut(&rendered), streamTime(0), renderTime(0),
+                      refreshes(0), identical(true) {}
+
+        void onDelivery(const Match& match, const Innings&, const Ball&) override {
+            streambuf* saved = cout.rdbuf(&streamed);
+            BenchClock::time_point start = BenchClock::now();
+            match.displayFullMatch();
+            streamTime += secondsSince(start);
+            cout.rdbuf(saved);
+
+            start = BenchClock::now();
+            renderer.displayFullMatch(match, renderedOut);
+            renderTime += secondsSince(start);
+            refreshes++;
+
+            // Spot-check the text against the original output
+            if(refreshes % 97 == 0) {
+                ostringstream expected;
+                saved = cout.rdbuf(expected.rdbuf());
+                match.displayFullMatch();
+                cout.rdbuf(saved);
+                if(expected.str() != renderer.renderFullMatch(match)) identical = false;
+            }
+        }
+    } refresher;
+    ODIMatch* replay = replayMatch(*source, &refresher);
+
+    size_t n = refresher.refreshes;
+    cout << "\n[render] Full scorecard refreshed after each of " << n << " ODI deliveries" << endl;
+    cout << "  displayFullMatch: " << refresher.streamTime / n * 1e6 << " us/screen, "
+         << (double)refresher.streamed.flushes / n << " flushes and "
+         << (double)refresher.streamed.writes / n << " writes per screen" << endl;
+    cout << "  ScorecardRenderer: " << refresher.renderTime / n * 1e6 << " us/screen, "
+         << (double)refresher.rendered.flushes / n << " flush and "
+         << (double)refresher.rendered.writes / n << " write per screen" << endl;
+    cout << "  Overs formatted: " << refresher.renderer.getOversRendered() << ", reused from cache: "
+         << refresher.renderer.getOversReused() << endl;
+    cout << "  Check: " << (refresher.identical && refresher.streamed.bytes == refresher.rendered.bytes
+                            ? "output identical to displayFullMatch" : "OUTPUT DIFFERS") << endl;
+
+    delete replay;
+    delete source;
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+}
+
+// A season of matches: scorers of known accuracy, supervisors ruling on
+// whatever the reliability model will not settle on its own
+void benchScorerReliability() {
+    const int matches = 12;
+    const int balls = 300;
+    const int scorers = 5;
+    const double trueAccuracy[scorers] = {0.99, 0.97, 0.93, 0.85, 0.70};
+    const double threshold = 0.99;
+    string path = "/tmp/fast-scorebook-bench-reliability.dat";
+    remove(path.c_str());
+
+    uint64_t state = 88172645463325252ULL;
+    auto random = [&]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return (state >> 11) * (1.0 / 9007199254740992.0);
+    };
+    auto reading = [](int scorer, int n, int runs) {
+        return ScoreEntry("scorer" + to_string(scorer), "Scorer " + to_string(scorer), n / 6 + 1, n % 6 + 1,
+                          runs == 6 ? BallOutcome::SIX : runs == 4 ? BallOutcome::FOUR : (BallOutcome)runs,
+                          runs, 0, WicketType::NONE);
+    };
+
+    int conflicts = 0, autoResolved = 0, autoWrong = 0, majorityWrong = 0, firstMatchAuto = 0, firstMatchConflicts = 0;
+    bool persisted = true;
+    Supervisor supervisor("Bench Supervisor", 50, "Country", "SUP1", "supervisor");
+    streambuf* saved = cout.rdbuf(nullptr);
+    BenchClock::time_point start = BenchClock::now();
+    for(int m = 0; m < matches; m++) {
+        ScorerReliability model;
+        if(m > 0) persisted = model.load(path) && model.size() == (size_t)scorers && persisted;
+        Scorebook scorebook(nullptr, &supervisor);
+        scorebook.setReliabilityModel(&model, threshold);
+
+        vector<int> truth(balls);
+        for(int n = 0; n < balls; n++) {
+            truth[n] = (int)(random() * 7) % 7;
+            if(truth[n] == 5) truth[n] = 0;
+            int order[scorers] = {0, 1, 2, 3, 4};
+            for(int i = scorers - 1; i > 0; i--) swap(order[i], order[(int)(random() * (i + 1))]);
+            int votes[7] = {0};
+            for(int i = 0; i < scorers; i++) {
+                int s = order[i];
+                int runs = truth[n];
+                if(random() > trueAccuracy[s]) runs = (runs + 1 + (int)(random() * 3)) % 7;
+                if(runs == 5) runs = 6;
+                votes[runs]++;
+                scorebook.addScoreEntry(reading(s, n, runs));
+            }
+            int majority = 0;
+            for(int r = 1; r < 7; r++) if(votes[r] > votes[majority]) majority = r;
+            if(scorebook.hasConflict(n / 6 + 1, n % 6 + 1) && majority != truth[n]) majorityWrong++;
+
+            // The supervisor rules on the rest at the end of each over
+            if(n % 6 == 5) {
+                for(int b = n - 5; b <= n; b++) {
+                    scorebook.resolveConflict(b / 6 + 1, b % 6 + 1, reading(0, b, truth[b]));
+                }
+            }
+        }
+        for(const auto& c : scorebook.getConflicts()) {
+            int n = (c.overNumber - 1) * 6 + c.ballNumber - 1;
+            if(c.resolvedBy.compare(0, 4, "Auto") == 0 && c.resolvedEntry.runs != truth[n]) autoWrong++;
+        }
+        conflicts += scorebook.getTotalConflicts();
+        autoResolved += scorebook.getAutoResolvedConflicts();
+        if(m == 0) {
+            firstMatchConflicts += scorebook.getTotalConflicts();
+            firstMatchAuto += scorebook.getAutoResolvedConflicts();
+        }
+        persisted = model.save(path) && persisted;
+        if(m == matches - 1) {
+            cout.rdbuf(saved);
+            cout << "\n[reliability] " << matches << " matches x " << balls << " balls, " << scorers
+                 << " scorers of accuracy 99/97/93/85/70%, auto-rule at " << threshold * 100 << "%" << endl;
+            cout << "  " << secondsSince(start) * 1e3 << " ms; " << conflicts << " conflicts, "
+                 << autoResolved << " ruled automatically (" << autoWrong << " wrong), "
+                 << conflicts - autoResolved << " left to supervisors" << endl;
+            cout << "  Automatic share: " << firstMatchAuto * 100 / max(1, firstMatchConflicts)
+                 << "% in the first match (no history), "
+                 << (autoResolved - firstMatchAuto) * 100 / max(1, conflicts - firstMatchConflicts)
+                 << "% over the rest of the season" << endl;
+            cout << "  Unweighted majority would have been wrong on " << majorityWrong << " conflicts" << endl;
+            model.displayScorers();
+            cout << "  Check: " << (persisted && autoResolved > 0 && autoWrong * 100 <= autoResolved
+                                    ? "model persisted across matches, automatic rulings at least 99% right"
+                                    : "MISMATCH") << endl;
+            saved = cout.rdbuf(nullptr);
+        }
+    }
+    cout.rdbuf(saved);
+    remove(path.c_str());
+}
+
+// Several supervisors clearing a stream of disputes through the conflict desk
+void benchConflictDesk() {
+    const int balls = 6000;
+    const int supervisorCount = 4;
+    const int abandonEvery = 40;        // The last supervisor walks away from some claims
+    const uint64_t leaseMs = 2;
+
+    Supervisor chief("Chief Supervisor", 50, "Country", "SUP0", "chief");
+    Scorebook scorebook(nullptr, &chief);
+    ConflictDesk desk(leaseMs);
+    vector<Supervisor*> panel;
+    for(int s = 0; s < supervisorCount; s++) {
+        panel.push_back(new Supervisor("Supervisor " + to_string(s + 1), 50, "Country",
+                                       "SUP" + to_string(s + 1), "sup" + to_string(s + 1)));
+        desk.addSupervisor(panel.back());
+    }
+
+    atomic<bool> fed(false);
+    atomic<int> wrongRulings(0);
+    auto work = [&](int index) {
+        uint64_t claims = 0;
+        while(true) {
+            ConflictClaim claim = desk.claim(index);
+            if(!claim.isValid()) {
+                if(fed.load(memory_order_acquire) && desk.getBacklog() == 0) break;
+                this_thread::yield();
+                continue;
+            }
+            claims++;
+            // Review the entries, then rule for the first scorer
+            BenchClock::time_point until = BenchClock::now() + chrono::microseconds(20);
+            while(BenchClock::now() < until) {}
+            if(index == supervisorCount - 1 && claims % abandonEvery == 0) {
+                this_thread::sleep_for(chrono::milliseconds(leaseMs * 2));
+            }
+            const ScoreEntry& ruling = claim.ticket->entries[0];
+            if(ruling.userId != "scorerA") wrongRulings.fetch_add(1);
+            desk.resolve(claim, ruling);
+        }
+    };
+
+    streambuf* saved = cout.rdbuf(nullptr);
+    BenchClock::time_point start = BenchClock::now();
+    vector<thread> threads;
+    for(int s = 0; s < supervisorCount; s++) threads.push_back(thread(work, s));
+    for(int n = 0; n < balls; n++) {
+        int over = n / 6 + 1, ball = n % 6 + 1;
+        scorebook.addScoreEntry(ScoreEntry("scorerA", "Scorer A", over, ball, BallOutcome::FOUR, 4, 0, WicketType::NONE));
+        scorebook.addScoreEntry(ScoreEntry("scorerB", "Scorer B", over, ball, BallOutcome::SIX, 6, 0, WicketType::NONE));
+        if(ball == 6) desk.sync(scorebook);
+    }
+    fed.store(true, memory_order_release);
+    desk.sync(scorebook);
+    while(scorebook.getResolvedConflicts() < scorebook.getTotalConflicts()) {
+        this_thread::yield();
+        desk.sync(scorebook);
+    }
+    double seconds = secondsSince(start);
+    for(auto& t : threads) t.join();
+    cout.rdbuf(saved);
+
+    int byPanel = 0;
+    uint64_t expired = 0, late = 0;
+    for(int s = 0; s < supervisorCount; s++) {
+        byPanel += panel[s]->getConflictsResolved();
+        expired += desk.getStats(s).leasesExpired.load();
+        late += desk.getStats(s).lateRulings.load();
+    }
+    cout << "\n[desk] " << balls << " disputed balls, " << supervisorCount
+         << " supervisors, " << leaseMs << " ms leases, one supervisor stalls on 1 in " << abandonEvery << endl;
+    cout << "  " << seconds * 1e3 << " ms; " << (int)(scorebook.getResolvedConflicts() / seconds)
+         << " rulings/s" << endl;
+    desk.displayMetrics(seconds);
+    cout << "  Check: " << (byPanel == balls && scorebook.getResolvedConflicts() == balls &&
+                            desk.getRulingsApplied() == (uint64_t)balls && desk.getRulingsSuperseded() == 0 &&
+                            wrongRulings.load() == 0 && expired > 0 && late == expired &&
+                            desk.getPostsDeferred() == 0 &&
+                            desk.getChunksAllocated() * ConflictDesk::CHUNK_SIZE < (size_t)balls
+                            ? "every conflict ruled exactly once, expired leases taken over, ticket chunks recycled"
+                            : "MISMATCH") << endl;
+
+    // Compaction drops resolved conflicts between syncs, some of them
+    // ruled before the desk saw them, while a short-handed desk carries a
+    // backlog of open tickets; each dispute still gets one ticket
+    const int compactedBalls = 1200;
+    const int ruledDirectlyEvery = 5;
+    const int syncEveryOvers = 4;
+    const int rulingsPerSync = 12;
+    Scorebook compacting(nullptr, &chief);
+    compacting.setCompaction(CompactionPolicy(true, 2, 10));
+    ConflictDesk compactDesk(leaseMs);
+    compactDesk.addSupervisor(panel[0]);
+    int ruledDirectly = 0;
+    auto drain = [&](int limit) {
+        compactDesk.sync(compacting);
+        for(int r = 0; r < limit; r++) {
+            ConflictClaim claim = compactDesk.claim(0);
+            if(!claim.isValid()) break;
+            compactDesk.resolve(claim, claim.ticket->entries[0]);
+        }
+        compactDesk.sync(compacting);
+    };
+    saved = cout.rdbuf(nullptr);
+    for(int n = 0; n < compactedBalls; n++) {
+        int over = n / 6 + 1, ball = n % 6 + 1;
+        compacting.addScoreEntry(ScoreEntry("scorerA", "Scorer A", over, ball, BallOutcome::FOUR, 4, 0, WicketType::NONE));
+        compacting.addScoreEntry(ScoreEntry("scorerB", "Scorer B", over, ball, BallOutcome::SIX, 6, 0, WicketType::NONE));
+        if(n % ruledDirectlyEvery == 0) {
+            compacting.resolveConflict(over, ball, ScoreEntry("scorerA", "Scorer A", over, ball, BallOutcome::FOUR, 4, 0, WicketType::NONE), &chief);
+            ruledDirectly++;
+        }
+        if(ball == 6 && over % syncEveryOvers == 0) drain(rulingsPerSync);
+    }
+    while(compacting.getResolvedConflicts() < compacting.getTotalConflicts()) drain(rulingsPerSync);
+    cout.rdbuf(saved);
+    uint64_t posted = compactDesk.getTicketsPosted();
+    cout << "  With compaction: " << compactedBalls << " disputed balls, " << ruledDirectly
+         << " ruled outside the desk, " << posted << " tickets, " << compacting.getMemoryReport().compactedBalls
+         << " balls compacted" << endl;
+    cout << "  Check: " << (posted == (uint64_t)(compactedBalls - ruledDirectly) &&
+                            compactDesk.getRulingsApplied() == posted && compactDesk.getTicketsCancelled() == 0 &&
+                            compactDesk.getRulingsSuperseded() == 0 &&
+                            compacting.getResolvedConflicts() == compactedBalls &&
+                            compacting.getMemoryReport().compactedBalls > 0
+                            ? "no duplicate tickets after compaction" : "MISMATCH") << endl;
+    for(auto s : panel) delete s;
+}
+
+// Tallies notifications by type
+struct CountingScorebookListener : public ScorebookListener {
+    uint64_t detected, resolved, consensus;
+
+    CountingScorebookListener() : detected(0), resolved(0), consensus(0) {}
+    void onConflictDetected(const ConflictDetected&) override { detected++; }
+    void onConflictResolved(const ConflictResolved&) override { resolved++; }
+    void onConsensusReached(const ConsensusReached&) override { consensus++; }
+};
+
+// Conflict notifications logged on the scoring thread, as the scorebook
+// used to print them, against the same logger behind a notifier thread
+void benchScorebookNotifier() {
+    const int balls = 30000;
+    const int scorers = 3;
+    const int disputeEvery = 10;
+    ofstream sink("/dev/null");
+
+    double ingestSeconds[2], totalSeconds[2];
+    CountingScorebookListener counts[2];
+    uint64_t expected[2] = {0, 0};
+    uint64_t dropped = 0;
+    Supervisor supervisor("Bench Supervisor", 50, "Country", "SUP1", "supervisor");
+    for(int run = 0; run < 2; run++) {
+        bool async = run == 1;
+        Scorebook scorebook(nullptr, &supervisor);
+        EventBus bus(1 << 16);
+        scorebook.setEventBus(&bus);
+        ScorebookNotifier notifier(bus, SlowConsumerPolicy::BLOCK);
+        ConsoleConflictLogger logger(sink);
+        notifier.addListener(&logger);
+        notifier.addListener(&counts[run]);
+        if(async) notifier.start();
+
+        BenchClock::time_point start = BenchClock::now();
+        for(int n = 0; n < balls; n++) {
+            int over = n / 6 + 1, ball = n % 6 + 1;
+            for(int s = 0; s < scorers; s++) {
+                int runs = (n % disputeEvery == 0 && s == scorers - 1) ? 6 : 1;
+                scorebook.addScoreEntry(ScoreEntry("scorer" + to_string(s), "Scorer", over, ball,
+                                                   runs == 6 ? BallOutcome::SIX : BallOutcome::SINGLE,
+                                                   runs, 0, WicketType::NONE));
+                if(!async) notifier.pollOnce();
+            }
+            if(n % disputeEvery == 0) {
+                scorebook.resolveConflict(over, ball, ScoreEntry("sup", "Sup", over, ball, BallOutcome::SINGLE,
+                                                                 1, 0, WicketType::NONE));
+                if(!async) notifier.pollOnce();
+            }
+        }
+        ingestSeconds[run] = secondsSince(start);
+        notifier.waitUntilIdle();
+        notifier.stop();
+        totalSeconds[run] = secondsSince(start);
+        expected[run] = (uint64_t)scorebook.getTotalConflicts() + scorebook.getResolvedConflicts()
+                        + (uint64_t)balls;
+        if(async) dropped = notifier.getDropped();
+    }
+
+    cout << "\n[notify] " << balls << " balls x " << scorers << " scorers, 1 in " << disputeEvery
+         << " disputed and ruled on, logger writing to /dev/null" << endl;
+    cout << "  Logged on the scoring thread: " << ingestSeconds[0] * 1e3 << " ms ("
+         << (int)(balls * scorers / ingestSeconds[0]) << " entries/s)" << endl;
+    cout << "  Behind the notifier:          " << ingestSeconds[1] * 1e3 << " ms ("
+         << (int)(balls * scorers / ingestSeconds[1]) << " entries/s) to ingest, "
+         << totalSeconds[1] * 1e3 << " ms until every handler ran" << endl;
+    cout << "  Notifications: " << counts[1].detected << " conflicts, " << counts[1].resolved
+         << " rulings, " << counts[1].consensus << " agreed balls" << endl;
+    bool same = counts[0].detected == counts[1].detected && counts[0].resolved == counts[1].resolved &&
+                counts[0].consensus == counts[1].consensus;
+    cout << "  Check: " << (same && dropped == 0 &&
+                            counts[1].detected + counts[1].resolved + counts[1].consensus == expected[1]
+                            ? "every notification delivered once, off the scoring thread" : "MISMATCH") << endl;
+}
+
+// Cost of one span, and a traced replay with scoring and rendering dumped as Chrome JSON
+void benchTrace() {
+    const int batches = 40;
+    const int spansPerBatch = 100000;
+    const int scorers = 3;
+    string path = "/tmp/fast-scorebook-trace.json";
+
+    Trace::start();
+    BenchClock::time_point start = BenchClock::now();
+    for(int b = 0; b < batches; b++) {
+        Trace::reset();
+        for(int i = 0; i < spansPerBatch; i++) {
+            TRACE_SPAN("bench::empty");
+        }
+    }
+    double spanNanos = secondsSince(start) * 1e9 / ((double)batches * spansPerBatch);
+    Trace::reset();
+
+    vector<Team*> teams = createDeliveryBenchTeams(2);
+    Venue* venue = new Venue("Trace Ground", "City", "Country", 20000);
+    ODIMatch* source = new ODIMatch("TRACE_ODI", teams[0], teams[1], venue);
+    MatchScheduler scheduler;
+    scheduler.addMatch(source);
+    scheduler.run();
+
+    // Score every delivery of a replay three times over, refreshing the scorecard each over
+    class TracedScoring : public DeliveryListener {
+    public:
+        Supervisor supervisor;
+        Scorebook scorebook;
+        ScorecardRenderer renderer;
+        int deliveries;
+
+        TracedScoring() : supervisor("Bench Supervisor", 50, "Country", "SUP1", "supervisor"),
+                          scorebook(nullptr, &supervisor), deliveries(0) {}
+
+        void onDelivery(const Match& match, const Innings& innings, const Ball& ball) override {
+            int over = (innings.getInningsNumber() - 1) * 1000 + ball.getOverNumber();
+            int number = ++deliveries;
+            for(int s = 0; s < scorers; s++) {
+                int runs = ball.getRuns() + (s == scorers - 1 && number % 25 == 0 ? 1 : 0);
+                scorebook.addScoreEntry(ScoreEntry("scorer" + to_string(s), "Scorer", over, number,
+                                                   ball.getOutcome(), runs, ball.getExtras(), ball.getWicketType()));
+            }
+            if(scorebook.hasConflict(over, number)) {
+                scorebook.resolveConflict(over, number, ScoreEntry("sup", "Sup", over, number, ball.getOutcome(),
+                                                                   ball.getRuns(), ball.getExtras(), ball.getWicketType()));
+            }
+            if(ball.getBallNumber() == 6) renderer.renderFullMatch(match);
+        }
+    };
+    TracedScoring scoring;
+    streambuf* saved = cout.rdbuf(nullptr);
+    start = BenchClock::now();
+    ODIMatch* replay = replayMatch(*source, &scoring);
+    double replaySeconds = secondsSince(start);
+    cout.rdbuf(saved);
+    scoring.renderer.forget(*replay);
+
+    Trace::setThreadName("bench");
+    uint64_t recorded = Trace::getEventCount();
+    start = BenchClock::now();
+    bool written = Trace::writeChromeJson(path);
+    double dumpSeconds = secondsSince(start);
+
+    // Read the dump back and count its events
+    uint64_t spans = 0, counters = 0, metadata = 0;
+    bool parsed = false;
+    ifstream in(path.c_str(), ios::binary);
+    vector<char> data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    JsonReader reader(data.data(), data.size());
+    JsonSlice key, value;
+    if(reader.beginObject()) {
+        while(reader.nextKey(key)) {
+            if(key != "traceEvents") {
+                reader.skipValue();
+                continue;
+            }
+            reader.beginArray();
+            while(reader.nextElement()) {
+                reader.beginObject();
+                while(reader.nextKey(key)) {
+                    if(key == "ph" && reader.readString(value)) {
+                        if(value == "X") spans++;
+                        else if(value == "C") counters++;
+                        else if(value == "M") metadata++;
+                    } else {
+                        reader.skipValue();
+                    }
+                }
+            }
+        }
+        parsed = !reader.failed();
+    }
+
+    cout << "\n[trace] Tracing " << (Trace::isCompiledIn() ? "compiled in" : "compiled out (build with make TRACE=1)")
+         << ": " << spanNanos << " ns per span" << endl;
+    cout << "  Replayed ODI with " << scorers << " scorers per ball and a scorecard per over: "
+         << replaySeconds * 1e3 << " ms, " << recorded << " events (" << Trace::getDropped() << " dropped)" << endl;
+    cout << "  Chrome trace " << path << ": " << data.size() / 1024 << " KB written in " << dumpSeconds * 1e3
+         << " ms; " << spans << " spans, " << counters << " counters" << endl;
+    bool complete = spans + counters == recorded && (recorded > 0) == Trace::isCompiledIn();
+    cout << "  Check: " << (written && parsed && complete ? "trace parses and holds every recorded event"
+                                                           : "MISMATCH") << endl;
+
+    delete replay;
+    delete source;
+    for(auto team : teams) deleteBenchTeam(team);
+    delete venue;
+    remove(path.c_str());
+}
+
+// A five-day match scored with and without compaction of finalized balls
+struct CompactionRun {
+    double seconds;
+    size_t peakBytes;
+    ScorebookMemoryReport final;
+    int conflicts;
+    uint64_t journalEntries;
+    uint64_t journalRulings;
+    uint64_t journalBytes;
+};
+
+CompactionRun scoreLongMatch(bool compact, const string& journalPath) {
+    const int scorers = 5;
+    const int overs = 450;
+    Supervisor supervisor("Bench Supervisor", 50, "Country", "SUP1", "supervisor");
+    Scorebook scorebook(nullptr, &supervisor);
+    ScorebookJournal journal;
+    if(compact) {
+        journal.open(journalPath);
+        scorebook.setCompaction(CompactionPolicy(true, 2, 10), &journal);
+    }
+
+    // Scorer 4 misreads every 40th ball; supervisors rule three overs
+    // later, except on over 14, which stays disputed all match. A late
+    // scorer confirms every 100th ball five overs on, and once dissents.
+    auto entryFor = [](int scorer, int n, bool misread) {
+        int runs = misread ? 6 : (n * 7) % 5;
+        return ScoreEntry("scorer" + to_string(scorer), "Scorer Number " + to_string(scorer), n / 6 + 1, n % 6 + 1,
+                          runs == 6 ? BallOutcome::SIX : runs == 4 ? BallOutcome::FOUR : (BallOutcome)runs,
+                          runs, 0, WicketType::NONE);
+    };
+    CompactionRun run;
+    run.peakBytes = 0;
+    streambuf* saved = cout.rdbuf(nullptr);
+    BenchClock::time_point start = BenchClock::now();
+    double reportTime = 0;
+    for(int over = 0; over < overs; over++) {
+        for(int b = 0; b < 6; b++) {
+            int n = over * 6 + b;
+            for(int s = 0; s < scorers; s++) scorebook.addScoreEntry(entryFor(s, n, s == 4 && n % 40 == 0));
+            int lateBall = n - 30;
+            if(lateBall >= 0 && lateBall % 100 == 0) {
+                scorebook.addScoreEntry(entryFor(9, lateBall, lateBall == 1300));
+            }
+        }
+        vector<pair<int, int>> due;
+        for(const auto& c : scorebook.getConflicts()) {
+            if(!c.isResolved && c.overNumber <= over - 2 && c.overNumber != 14) {
+                due.push_back(make_pair(c.overNumber, c.ballNumber));
+            }
+        }
+        for(const auto& ball : due) {
+            scorebook.resolveConflict(ball.first, ball.second, scorebook.resolveByVoting(ball.first, ball.second));
+        }
+        if(over % 10 == 9) {
+            BenchClock::time_point r = BenchClock::now();
+            run.peakBytes = max(run.peakBytes, scorebook.getMemoryReport().approxBytes);
+            reportTime += secondsSince(r);
+        }
+    }
+    run.seconds = secondsSince(start) - reportTime;
+    cout.rdbuf(saved);
+    run.final = scorebook.getMemoryReport();
+    run.conflicts = scorebook.getTotalConflicts();
+    journal.close();
+    run.journalEntries = journal.getEntriesWritten();
+    run.journalRulings = journal.getRulingsWritten();
+    run.journalBytes = journal.getBytesWritten();
+    return run;
+}
+
+void benchCompaction() {
+    string path = "/tmp/fast-scorebook-bench-audit.jrn";
+    remove(path.c_str());
+    CompactionRun plain = scoreLongMatch(false, path);
+    CompactionRun compact = scoreLongMatch(true, path);
+
+    uint64_t replayedEntries = 0, replayedRulings = 0, dissents = 0;
+    bool readable = ScorebookJournal::replay(path, [&](const AuditRecord& r) {
+        if(r.kind == FRAME_AUDIT_RULING) replayedRulings++;
+        else replayedEntries++;
+        if(r.flags & AUDIT_DISSENT) dissents++;
+    });
+    remove(path.c_str());
+
+    size_t entries = 450 * 6 * 5;
+    cout << "\n[compact] 450 overs, 5 scorers, rulings 3 overs behind play, one dispute left open" << endl;
+    cout << "  Keep everything: " << plain.seconds / entries * 1e9 << " ns/entry, peak ~"
+         << plain.peakBytes / 1024 << " KB" << endl;
+    cout << "  ";
+    plain.final.display();
+    cout << "  Compacting:      " << compact.seconds / entries * 1e9 << " ns/entry, peak ~"
+         << compact.peakBytes / 1024 << " KB" << endl;
+    cout << "  ";
+    compact.final.display();
+    cout << "  Journal: " << compact.journalEntries << " entries, " << compact.journalRulings << " rulings, "
+         << compact.journalBytes / 1024 << " KB; " << dissents << " late dissent" << endl;
+    cout << "  Check: " << (readable && replayedEntries == compact.journalEntries &&
+                            replayedRulings == compact.journalRulings &&
+                            compact.final.openConflicts == 1 && plain.final.openConflicts == 1 &&
+                            compact.conflicts == plain.conflicts &&
+                            compact.final.liveBalls < 100
+                            ? "working set bounded, audit complete" : "MISMATCH") << endl;
+}
+
+// Scorers that retransmit: a quarter of entries arrive twice, retries late
+void benchEntryDedup() {
+    const int scorers = 5;
+    const int balls = 20000;
+    const size_t retryDelay = 16;
+    Supervisor supervisor("Bench Supervisor", 50, "Country", "SUP1", "supervisor");
+    Scorebook scorebook(nullptr, &supervisor);
+
+    // Scorer 4 misreads every 50th ball
+    vector<ScoreEntry> offered;
+    uint64_t retries = 0;
+    for(int s = 0; s < scorers; s++) {
+        deque<ScoreEntry> late;
+        for(int n = 0; n < balls; n++) {
+            int runs = (n % 50 == 0 && s == 4) ? 6 : (n * 7) % 5;
+            ScoreEntry e("scorer" + to_string(s), "Scorer " + to_string(s), n / 6 + 1, n % 6 + 1,
+                         runs == 6 ? BallOutcome::SIX : runs == 4 ? BallOutcome::FOUR : (BallOutcome)runs,
+                         runs, 0, WicketType::NONE, (uint64_t)n + 1);
+            offered.push_back(e);
+            if(n % 4 == 0) late.push_back(e);
+            if(late.size() > retryDelay) {
+                offered.push_back(late.front());
+                late.pop_front();
+                retries++;
+            }
+        }
+        while(!late.empty()) {
+            offered.push_back(late.front());
+            late.pop_front();
+            retries++;
+        }
+    }
+
+    streambuf* saved = cout.rdbuf(nullptr);
+    BenchClock::time_point start = BenchClock::now();
+    size_t accepted = 0;
+    for(const auto& e : offered) accepted += scorebook.addScoreEntry(e) ? 1 : 0;
+    double seconds = secondsSince(start);
+    cout.rdbuf(saved);
+
+    bool tallies = true;
+    for(const auto& c : scorebook.getConflicts()) {
+        int n = (c.overNumber - 1) * 6 + c.ballNumber - 1;
+        ScoreEntry winner = scorebook.resolveByVoting(c.overNumber, c.ballNumber);
+        if(c.conflictingEntries.size() != (size_t)scorers || winner.runs != (n * 7) % 5) tallies = false;
+    }
+
+    cout << "\n[dedup] " << scorers << " scorers x " << balls << " entries, " << retries
+         << " retransmitted up to " << retryDelay * 4 << " entries late" << endl;
+    cout << "  addScoreEntry: " << seconds / offered.size() * 1e9 << " ns/entry, " << accepted
+         << " accepted, " << scorebook.getDuplicateEntries() << " retries dropped" << endl;
+    cout << "  Filter state: " << sizeof(SequenceWindow) << " bytes per scorer" << endl;
+    cout << "  Check: " << (accepted == (size_t)scorers * balls && scorebook.getDuplicateEntries() == retries &&
+                            scorebook.getTotalConflicts() == balls / 50 && tallies
+                            ? "every retry dropped, conflicts hold one vote per scorer" : "MISMATCH") << endl;
+}
+
+// Counts what a compacting scorebook hands to its audit
+struct CountingAuditSink : public AuditSink {
+    uint64_t finalized, lateAgreed, lateDissents, replaced;
+
+    CountingAuditSink() : finalized(0), lateAgreed(0), lateDissents(0), replaced(0) {}
+    void onFinalized(const vector<ScoreEntry>&, const Conflict*) override { finalized++; }
+    void onLateEntry(const ScoreEntry&, bool agreed) override { (agreed ? lateAgreed : lateDissents)++; }
+    void onRulingReplaced(const Conflict&) override { replaced++; }
+};
+
+// Three scorebook replicas scoring through a partition, then converging
+void benchReplicaSync() {
+    const int scorers = 6;
+    const int balls = 300;
+    Supervisor supervisors[3] = {
+        Supervisor("Primary Supervisor", 50, "Country", "SUP1", "primary"),
+        Supervisor("Standby Supervisor", 48, "Country", "SUP2", "standby"),
+        Supervisor("Remote Supervisor", 45, "Country", "SUP3", "remote")
+    };
+    const char* names[3] = {"primary", "standby", "remote"};
+    vector<Scorebook*> books;
+    vector<ScorebookReplica*> replicas;
+    ReplicaNetwork network;
+    for(int r = 0; r < 3; r++) {
+        books.push_back(new Scorebook(nullptr, &supervisors[r]));
+        replicas.push_back(new ScorebookReplica(names[r], *books[r]));
+        network.addReplica(replicas[r]);
+    }
+
+    // Scorer s reports to replica s % 3, and every fourth entry is retried
+    // at the next replica too. Scorers 4 and 5 misread every tenth ball.
+    auto entryFor = [](int scorer, int n) {
+        int runs = (n * 7) % 5;
+        if(n % 10 == 0 && scorer == 4) runs = 4;
+        if(n % 10 == 0 && scorer == 5) runs = 6;
+        ScoreEntry e("scorer" + to_string(scorer), "Scorer " + to_string(scorer), n / 6 + 1, n % 6 + 1,
+                     runs == 6 ? BallOutcome::SIX : runs == 4 ? BallOutcome::FOUR : (BallOutcome)runs,
+                     runs, 0, WicketType::NONE);
+        return e;
+    };
+    auto scoreBalls = [&](int from, int to) {
+        for(int n = from; n < to; n++) {
+            for(int s = 0; s < scorers; s++) {
+                ScoreEntry e = entryFor(s, n);
+                replicas[s % 3]->addScoreEntry(e);
+                if((n + s) % 4 == 0) replicas[(s + 1) % 3]->addScoreEntry(e);
+            }
+            if(n % 6 == 5) network.antiEntropyRound();
+        }
+    };
+    // Each replica's supervisor rules on what it can see: primary sides
+    // with scorer 0, the others with the lower-numbered misreading scorer
+    auto ruleOnConflicts = [&](int r) {
+        vector<pair<int, int>> open;
+        for(const auto& c : books[r]->getConflicts()) {
+            if(!c.isResolved) open.push_back(make_pair(c.overNumber, c.ballNumber));
+        }
+        for(const auto& ball : open) {
+            int n = (ball.first - 1) * 6 + ball.second - 1;
+            replicas[r]->resolveConflict(ball.first, ball.second, entryFor(r == 0 ? 0 : 4, n));
+        }
+        return open.size();
+    };
+
+    streambuf* saved = cout.rdbuf(nullptr);
+    BenchClock::time_point start = BenchClock::now();
+    network.partition(0, 1);
+    network.partition(1, 2);
+    scoreBalls(0, balls / 2);
+    size_t ruled = ruleOnConflicts(0) + ruleOnConflicts(1);
+    bool divergedDuringPartition = !network.isConverged();
+
+    network.healAll();
+    int rounds = 0;
+    uint64_t healBytes = 0;
+    while(!network.isConverged() && rounds < 10) {
+        healBytes += network.antiEntropyRound();
+        rounds++;
+    }
+    bool convergedAfterHeal = network.isConverged();
+
+    uint64_t beforeSecondHalf = network.getBytesDelivered();
+    scoreBalls(balls / 2, balls);
+    ruled += ruleOnConflicts(2);
+    network.antiEntropyRound();
+    double seconds = secondsSince(start);
+    uint64_t secondHalfBytes = network.getBytesDelivered() - beforeSecondHalf;
+    uint64_t idleBytes = network.antiEntropyRound();
+
+    // A fresh replica catching up has to receive the full history; every
+    // ruling it learns from arrives from the others
+    Scorebook lateBook(nullptr, &supervisors[2]);
+    ScorerReliability lateModel;
+    lateBook.setReliabilityModel(&lateModel);
+    ScorebookReplica late("late", lateBook);
+    network.addReplica(&late);
+    uint64_t fullHistoryBytes = network.antiEntropyRound();
+    cout.rdbuf(saved);
+
+    cout << "\n[replica] 3 replicas, " << scorers << " scorers x " << balls
+         << " balls, standby partitioned for the first half" << endl;
+    cout << "  Partition: diverged " << (divergedDuringPartition ? "yes" : "no") << ", "
+         << ruled << " rulings made locally, healed in " << rounds << " round(s), "
+         << healBytes / 1024.0 << " KB" << endl;
+    cout << "  Second half: " << secondHalfBytes / 1024.0 << " KB of deltas over "
+         << balls / 12 << " rounds; idle round " << idleBytes << " bytes; full history "
+         << fullHistoryBytes / 1024.0 << " KB" << endl;
+    cout << "  Time: " << seconds * 1e3 << " ms" << endl;
+    bool booksAgree = true;
+    for(int r = 0; r < 3; r++) {
+        booksAgree = booksAgree && books[r]->getTotalConflicts() == lateBook.getTotalConflicts() &&
+                     books[r]->getResolvedConflicts() == lateBook.getResolvedConflicts() &&
+                     replicas[r]->getPendingResolutionCount() == 0;
+    }
+    uint64_t learned = 0;
+    for(int s = 0; s < scorers; s++) {
+        uint64_t n = lateModel.getRulings("scorer" + to_string(s));
+        if(n > (uint64_t)lateBook.getResolvedConflicts()) booksAgree = false;
+        learned += n;
+    }
+    network.displayStatus();
+    cout << "  Late replica learned from " << learned << " votes on replicated rulings" << endl;
+    cout << "  Check: " << (convergedAfterHeal && network.isConverged() && booksAgree && learned > 0
+                            ? "replicas and scorebooks converged" : "DIVERGED") << endl;
+
+    // The primary compacts a ball it ruled on while the standby, cut off,
+    // rules the other way; the standby's later ruling has to reach the
+    // primary's summary and audit once the link heals
+    Scorebook compactingBook(nullptr, &supervisors[0]);
+    CountingAuditSink audit;
+    compactingBook.setCompaction(CompactionPolicy(true, 2, 10), &audit);
+    Scorebook standbyBook(nullptr, &supervisors[1]);
+    ScorebookReplica compacting("primary", compactingBook), standby("standby", standbyBook);
+    ReplicaNetwork pair;
+    pair.addReplica(&compacting);
+    pair.addReplica(&standby);
+    saved = cout.rdbuf(nullptr);
+    compacting.addScoreEntry(entryFor(0, 0));
+    compacting.addScoreEntry(entryFor(4, 0));
+    pair.antiEntropyRound();
+    pair.partition(0, 1);
+    compacting.resolveConflict(1, 1, entryFor(0, 0));
+    for(int n = 6; n < 36; n++) compacting.addScoreEntry(entryFor(0, n));
+    bool compacted = compactingBook.findConflict(1, 1) == nullptr;
+    standby.resolveConflict(1, 1, entryFor(4, 0));
+    pair.healAll();
+    pair.antiEntropyRound();
+    // A late scorer who agrees with the standby's ruling now agrees with the primary too
+    ScoreEntry lateVote = entryFor(4, 0);
+    lateVote.userId = "scorer9";
+    compacting.addScoreEntry(lateVote);
+    pair.antiEntropyRound();
+    cout.rdbuf(saved);
+    cout << "  Compacted ruling superseded: " << audit.replaced << " replacement journaled, "
+         << compacting.getPendingResolutionCount() << " pending" << endl;
+    cout << "  Check: " << (compacted && pair.isConverged() && audit.replaced == 1 && audit.lateAgreed == 1 &&
+                            compacting.getPendingResolutionCount() == 0 && compactingBook.getTotalConflicts() == 1
+                            ? "later ruling applied to the compacted ball" : "DIVERGED") << endl;
+
+    // Names at the wire limit from a replica with a long id: every record
+    // has to go out in frames the peer accepts, and longer names are refused
+    Scorebook longBook(nullptr, &supervisors[0]), peerBook(nullptr, &supervisors[1]);
+    ScorebookReplica longNamed(string(200, 'r'), longBook), peer("peer", peerBook);
+    ReplicaNetwork wide;
+    wide.addReplica(&longNamed);
+    wide.addReplica(&peer);
+    int longEntries = 0;
+    for(int s = 0; s < 4; s++) {
+        for(int n = 0; n < 6; n++) {
+            ScoreEntry e = entryFor(s, n);
+            e.userId = string(MAX_WIRE_STRING - 1, 'a' + s);
+            e.userName = string(MAX_WIRE_STRING, 'A' + s);
+            longEntries += longNamed.addScoreEntry(e) ? 1 : 0;
+        }
+    }
+    ScoreEntry tooLong = entryFor(0, 7);
+    tooLong.userName = string(MAX_WIRE_STRING + 1, 'x');
+    bool tooLongRefused = !longNamed.addScoreEntry(tooLong);
+    saved = cout.rdbuf(nullptr);
+    wide.antiEntropyRound();
+    cout.rdbuf(saved);
+    cout << "  Check: " << (longEntries == 24 && tooLongRefused && wide.isConverged() &&
+                            peerBook.getTotalConflicts() == longBook.getTotalConflicts()
+                            ? "longest names replicate, longer ones refused" : "DIVERGED") << endl;
+
+    // Six replicas with ids at or past the wire limit: their version
+    // vectors take several digest frames, and sync must still get through
+    const int longReplicas = 6;
+    vector<Scorebook*> longBooks;
+    vector<ScorebookReplica*> longIds;
+    ReplicaNetwork crowd;
+    for(int r = 0; r < longReplicas; r++) {
+        longBooks.push_back(new Scorebook(nullptr, &supervisors[r % 3]));
+        longIds.push_back(new ScorebookReplica(string(MAX_WIRE_STRING - 2 + r, 'a' + r), *longBooks[r]));
+        crowd.addReplica(longIds[r]);
+        for(int n = 0; n < 8; n++) longIds[r]->addScoreEntry(entryFor(r, n));
+    }
+    saved = cout.rdbuf(nullptr);
+    crowd.antiEntropyRound();
+    cout.rdbuf(saved);
+    vector<char> digest;
+    longIds[0]->writeDigest(digest);
+    bool allSeen = longIds[0]->getVersionVector().size() == (size_t)longReplicas;
+    cout << "  " << longReplicas << " replicas with " << MAX_WIRE_STRING << "-byte ids: "
+         << digest.size() << " digest bytes after sync" << endl;
+    cout << "  Check: " << (allSeen && digest.size() > MAX_FRAME_PAYLOAD && crowd.isConverged() && longBooks[1]->getTotalConflicts() == longBooks[0]->getTotalConflicts()
+                            ? "long replica ids converge over split digests" : "DIVERGED") << endl;
+    for(int r = 0; r < longReplicas; r++) {
+        delete longIds[r];
+        delete longBooks[r];
+    }
+
+    for(int r = 0; r < 3; r++) {
+        delete replicas[r];
+        delete books[r];
+    }
+}
+
+#ifdef __linux__
+// Scorer clients streaming entries into the epoll server over a Unix socket
+void benchScoringServer() {
+    const int clients = 8;
+    const int entriesPerClient = 20000;
+    string path = "/tmp/fast-scorebook-bench-" + to_string((long)getpid()) + ".sock";
+
+    Supervisor supervisor("Bench Supervisor", 50, "Country", "SUP1", "supervisor");
+    Scorebook scorebook(nullptr, &supervisor);
+    ScoringServer server(scorebook);
+    if(!server.listen(path)) {
+        cout << "\n[server] Could not listen on " << path << endl;
+        return;
+    }
+
+    // Conflict notices go to the console; keep them out of the timing
+    streambuf* saved = cout.rdbuf(nullptr);
+    atomic<bool> stop(false);
+    thread serverThread([&]() { server.run(stop, 10); });
+    LoadTestResult result = runScoringLoad(path, clients, entriesPerClient, 32, 500, 50);
+
+    // A client that says HELLO twice is cut off before its entry is taken
+    bool secondHelloClosed = false;
+    {
+        ScoringClient client;
+        vector<char> out;
+        WireWriter writer(out);
+        writeHello(writer, "scorer0", "Scorer 0", 0);
+        writeHello(writer, "scorer1", "Scorer 1", 0);
+        WireEntry e;
+        e.seq = 1;
+        e.overNumber = 1;
+        e.ballNumber = 1;
+        e.write(writer);
+        if(client.connect(path) && client.send(out)) {
+            bool acked = false;
+            while(client.receive([&](const FrameView& f) { if(f.type == FRAME_ACK) acked = true; })) {}
+            secondHelloClosed = !acked;
+        }
+    }
+    stop.store(true, memory_order_release);
+    serverThread.join();
+    cout.rdbuf(saved);
+
+    cout << "\n[server] " << clients << " scorers x " << entriesPerClient
+         << " entries over a Unix socket, 32 in flight each, 1 in 50 retried" << endl;
+    result.display();
+    server.displayStats();
+    cout << "  Scorebook conflicts: " << scorebook.getTotalConflicts() << endl;
+    cout << "  Check: " << (result.ok && result.entries == (uint64_t)clients * entriesPerClient &&
+                            server.getEntriesAccepted() == result.entries &&
+                            result.duplicateAcks == server.getEntriesDuplicate() && secondHelloClosed
+                            ? "every entry acknowledged once, retries dropped, second HELLO refused"
+                            : "MISMATCH") << endl;
+    server.close();
+}
+
+// Honest scorers alongside one flooding with a replay bug, with and without admission control
+struct AdmissionRun {
+    vector<double> honestMicros;
+    uint64_t honestThrottled;
+    uint64_t floodSent;
+    uint64_t floodAdmitted;
+    double seconds;
+    bool ok;
+
+    AdmissionRun() : honestThrottled(0), floodSent(0), floodAdmitted(0), seconds(0), ok(true) {}
+};
+
+AdmissionRun runAdmissionScenario(const string& path, bool limited) {
+    const int honest = 4;
+    const int honestEntries = 300;
+    const int honestGapMicros = 4000;
+    const int floodBatch = 256;
+    typedef BenchClock Clock;
+
+    AdmissionRun run;
+    Supervisor supervisor("Bench Supervisor", 50, "Country", "SUP1", "supervisor");
+    Scorebook scorebook(nullptr, &supervisor);
+    AdmissionControl admission(AdmissionPolicy(500, 100, 5000, 1000));
+    if(limited) scorebook.setAdmissionControl(&admission);
+    ScoringServer server(scorebook);
+    if(!server.listen(path)) {
+        run.ok = false;
+        return run;
+    }
+
+    atomic<bool> stop(false), honestDone(false);
+    thread serverThread([&]() { server.run(stop, 10); });
+    Clock::time_point start = Clock::now();
+
+    vector<vector<double>> latencies(honest);
+    vector<uint64_t> throttledAcks(honest, 0);
+    vector<bool> clientOk(honest + 1, true);
+    vector<thread> threads;
+    for(int t = 0; t < honest; t++) {
+        threads.push_back(thread([&, t]() {
+            ScoringClient client;
+            vector<char> out;
+            WireWriter writer(out);
+            if(!client.connect(path)) { clientOk[t] = false; return; }
+            writeHello(writer, "scorer" + to_string(t), "Scorer " + to_string(t), 0);
+            Clock::time_point next = Clock::now();
+            for(int n = 0; n < honestEntries; n++) {
+                this_thread::sleep_until(next);
+                next += chrono::microseconds(honestGapMicros);
+                WireEntry e;
+                e.seq = (uint32_t)n + 1;
+                e.overNumber = n / 6 + 1;
+                e.ballNumber = (uint8_t)(n % 6 + 1);
+                e.runs = 1;
+                e.outcome = (uint8_t)BallOutcome::SINGLE;
+                e.write(writer);
+                Clock::time_point sentAt = Clock::now();
+                if(!client.send(out)) { clientOk[t] = false; return; }
+                out.clear();
+                bool acked = false;
+                while(!acked) {
+                    if(!client.receive([&](const FrameView& f) {
+                        if(f.type != FRAME_ACK) return;
+                        WireReader in(f);
+                        in.u32();
+                        if(in.u8() == ACK_THROTTLED) throttledAcks[t]++;
+                        acked = true;
+                    })) { clientOk[t] = false; return; }
+                }
+                latencies[t].push_back(chrono::duration<double, micro>(Clock::now() - sentAt).count());
+            }
+        }));
+    }
+    // The flooder ignores its back-off and sends the next batch straight away
+    threads.push_back(thread([&]() {
+        ScoringClient client;
+        vector<char> out;
+        WireWriter writer(out);
+        if(!client.connect(path)) { clientOk[honest] = false; return; }
+        writeHello(writer, "replayer", "Replaying App", 0);
+        uint32_t seq = 0;
+        while(!honestDone.load(memory_order_acquire)) {
+            for(int i = 0; i < floodBatch; i++) {
+                WireEntry e;
+                e.seq = ++seq;
+                e.overNumber = (int)(seq % 300) / 6 + 1;
+                e.ballNumber = (uint8_t)(seq % 6 + 1);
+                e.runs = 1;
+                e.outcome = (uint8_t)BallOutcome::SINGLE;
+                e.write(writer);
+            }
+            if(!client.send(out)) { clientOk[honest] = false; return; }
+            out.clear();
+            run.floodSent += floodBatch;
+            int acks = 0;
+            while(acks < floodBatch) {
+                if(!client.receive([&](const FrameView& f) {
+                    if(f.type != FRAME_ACK) return;
+                    WireReader in(f);
+                    in.u32();
+                    uint8_t status = in.u8();
+                    if(status == ACK_ACCEPTED || status == ACK_CONFLICT) run.floodAdmitted++;
+                    acks++;
+                })) { clientOk[honest] = false; return; }
+            }
+        }
+    }));
+    for(int t = 0; t < honest; t++) threads[t].join();
+    honestDone.store(true, memory_order_release);
+    threads[honest].join();
+    run.seconds = secondsSince(start);
+    stop.store(true, memory_order_release);
+    serverThread.join();
+    server.close();
+
+    for(int t = 0; t < honest; t++) {
+        run.honestMicros.insert(run.honestMicros.end(), latencies[t].begin(), latencies[t].end());
+        run.honestThrottled += throttledAcks[t];
+        run.ok = run.ok && clientOk[t] && latencies[t].size() == (size_t)honestEntries;
+    }
+    run.ok = run.ok && clientOk[honest];
+    sort(run.honestMicros.begin(), run.honestMicros.end());
+    return run;
+}
+
+void benchAdmissionControl() {
+    string path = "/tmp/fast-scorebook-bench-admission-" + to_string((long)getpid()) + ".sock";
+    streambuf* saved = cout.rdbuf(nullptr);
+    AdmissionRun open = runAdmissionScenario(path, false);
+    AdmissionRun limited = runAdmissionScenario(path, true);
+    cout.rdbuf(saved);
+
+    cout << "\n[admission] 4 scorers at 250 entries/s each, one client replaying entries as fast as it can" << endl;
+    const char* labels[2] = {"No limits", "500/s per scorer, 5000/s total"};
+    AdmissionRun* runs[2] = {&open, &limited};
+    for(int i = 0; i < 2; i++) {
+        const AdmissionRun& r = *runs[i];
+        if(r.honestMicros.empty()) {
+            cout << "  " << labels[i] << ": FAILED" << endl;
+            continue;
+        }
+        const vector<double>& lat = r.honestMicros;
+        cout << "  " << labels[i] << ": honest ack p50 " << lat[lat.size() / 2] << " us, p99 "
+             << lat[min(lat.size() - 1, lat.size() * 99 / 100)] << " us, max " << lat.back()
+             << " us; flood " << (int)(r.floodSent / r.seconds) << "/s sent, "
+             << (int)(r.floodAdmitted / r.seconds) << "/s admitted" << endl;
+    }
+    // The flooder's admitted rate is its bucket's rate plus the initial burst
+    bool capped = limited.floodAdmitted <= 500 * limited.seconds + 100 + 1;
+    cout << "  Check: " << (open.ok && limited.ok && limited.honestThrottled == 0 && capped
+                            ? "honest scorers never throttled, flood held to its own rate" : "MISMATCH") << endl;
+}
+#endif
+
+struct BenchEntry {
+    const char* name;
+    void (*run)();
+};
+
+int main(int argc, char* argv[]) {
+    const BenchEntry benches[] = {
+        {"scheduler", benchScheduler},
+        {"pool", benchTaskPool},
+        {"registry", benchPlayerRegistry},
+        {"snapshot", benchSnapshot},
+        {"archive", benchArchive},
+        {"query", benchDeliveryQuery},
+        {"career", benchCareerStats},
+        {"codec", benchDeliveryCodec},
+        {"import", benchImporter},
+        {"export", benchColumnarExport},
+        {"json", benchScorecardJson},
+        {"delta", benchScorecardDelta},
+        {"bus", benchEventBus},
+        {"render", benchScorecardRenderer},
+        {"replica", benchReplicaSync},
+        {"dedup", benchEntryDedup},
+        {"compact", benchCompaction},
+        {"reliability", benchScorerReliability},
+        {"desk", benchConflictDesk},
+        {"notify", benchScorebookNotifier},
+        {"trace", benchTrace},
+#ifdef __linux__
+        {"server", benchScoringServer},
+        {"admission", benchAdmissionControl}
+#endif
+    };
+    const int benchCount = sizeof(benches) / sizeof(benches[0]);
+
+    cout << fixed << setprecision(3);
+    cout << "========================================" << endl;
+    cout << "  FAST-SCOREBOOK BENCHMARKS" << endl;
+    cout << "========================================" << endl;
+
+    for(int i = 0; i < benchCount; i++) {
+        bool selected = (argc < 2);
+        for(int a = 1; a < argc; a++) {
+            if(strcmp(argv[a], benches[i].name) == 0) selected = true;
+        }
+        if(selected) benches[i].run();
+    }
+    return 0;
+}
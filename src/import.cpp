@@ -0,0 +1,67 @@
+/*
+ * FAST-SCOREBOOK: Match Importer
+ *
+ * Bulk-loads Cricsheet-style ball-by-ball JSON files into a match archive.
+ *
+ * Usage: fast-scorebook-import <archive-dir> <file.json | directory>...
+ */
+
+#include <iostream>
+#include <iomanip>
+#include "../include/PlayerRegistry.h"
+#include "../include/MatchArchive.h"
+#include "../include/MatchImporter.h"
+
+using namespace std;
+
+bool isDirectory(const string& path) {
+#ifndef _WIN32
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#else
+    return false;
+#endif
+}
+
+int main(int argc, char* argv[]) {
+    if(argc < 3) {
+        cout << "Usage: " << argv[0] << " <archive-dir> <file.json | directory>..." << endl;
+        return 1;
+    }
+
+    vector<string> files;
+    for(int a = 2; a < argc; a++) {
+        string path = argv[a];
+        if(isDirectory(path)) {
+            vector<string> listed = MatchImporter::listJsonFiles(path);
+            files.insert(files.end(), listed.begin(), listed.end());
+        } else {
+            files.push_back(path);
+        }
+    }
+
+    MatchArchive archive;
+    if(!archive.open(argv[1])) {
+        cout << "ERROR: Could not open archive " << argv[1] << endl;
+        return 1;
+    }
+
+    // Players keep the IDs earlier imports gave them
+    PlayerRegistry& registry = archive.getRegistry();
+    MatchImporter importer(registry);
+    size_t refused = 0;
+    cout << fixed << setprecision(3);
+    cout << "Importing " << files.size() << " files into " << argv[1] << " ("
+         << TaskPool::shared().getWorkerCount() << " threads)" << endl;
+
+    importer.importFiles(files, [&](Match* match) {
+        if(archive.addMatch(*match) == INVALID_MATCH_NO) refused++;
+        delete match;
+    });
+
+    importer.displayStats();
+    cout << "Archive: " << archive.getMatchCount() << " matches, "
+         << registry.size() << " players" << endl;
+    if(refused > 0) cout << "ERROR: " << refused << " matches could not be written to the archive" << endl;
+    return importer.getStats().failedFiles == 0 && refused == 0 ? 0 : 2;
+}
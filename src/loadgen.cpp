@@ -0,0 +1,48 @@
+/*
+ * FAST-SCOREBOOK: Scoring Load Generator
+ *
+ * Connects many scorer clients to a running scoring server and reports
+ * entry throughput and acknowledgement latency.
+ *
+ * Usage: fast-scorebook-loadgen <socket-path | port> [clients] [entries-per-client] [window] [retry-every]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "../include/ScoringServer.h"
+
+using namespace std;
+
+#ifdef __linux__
+
+int main(int argc, char* argv[]) {
+    if(argc < 2) {
+        cout << "Usage: " << argv[0] << " <socket-path | port> [clients] [entries-per-client] [window] [retry-every]" << endl;
+        return 1;
+    }
+    int clients = argc > 2 ? atoi(argv[2]) : 8;
+    int entries = argc > 3 ? atoi(argv[3]) : 20000;
+    int window = argc > 4 ? atoi(argv[4]) : 32;
+    int retryEvery = argc > 5 ? atoi(argv[5]) : 0;
+    if(clients < 1 || entries < 1 || window < 1 || retryEvery < 0) {
+        cout << "ERROR: clients, entries and window must be positive" << endl;
+        return 1;
+    }
+
+    cout << fixed << setprecision(3);
+    cout << "Load test: " << clients << " scorers x " << entries << " entries, "
+         << window << " in flight each, against " << argv[1] << endl;
+    LoadTestResult result = runScoringLoad(argv[1], clients, entries, window, 500, retryEvery);
+    result.display();
+    return result.ok ? 0 : 2;
+}
+
+#else
+
+int main() {
+    cout << "The load generator needs the Linux scoring server" << endl;
+    return 1;
+}
+
+#endif
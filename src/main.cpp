@@ -13,6 +13,7 @@
 #include <iomanip>
 #include "../include/Person.h"
 #include "../include/Player.h"
+#include "../include/PlayerRegistry.h"
 #include "../include/Officials.h"
 #include "../include/Team.h"
 #include "../include/Venue.h"
@@ -20,6 +21,8 @@
 #include "../include/Innings.h"
 #include "../include/Match.h"
 #include "../include/Scorebook.h"
+#include "../include/ScorebookNotifier.h"
+#include "../include/ScorecardRenderer.h"
 
 using namespace std;
 
@@ -36,21 +39,21 @@ void displayMenu() {
     cout << "6. View Scorebook Summary" << endl;
     cout << "7. View Conflicts" << endl;
     cout << "8. Display Match Officials" << endl;
-    cout << "9. Display Broadcasters" << endl;
+    cout << "9. Display Broadcasters and Commentators" << endl;
     cout << "0. Exit" << endl;
     cout << "========================================" << endl;
     cout << "Enter choice: ";
 }
 
-// Function to create sample teams
-void createTeamsWithPlayers(Team*& pakistan, Team*& india) {
+// Function to create sample teams (players are owned by the registry)
+void createTeamsWithPlayers(PlayerRegistry* registry, Team*& pakistan, Team*& india) {
     // Create Pakistan Team
     pakistan = new Team("Pakistan", "Pakistan");
     pakistan->setWorldRanking(4);
     pakistan->setTeamColor("Green");
     
     // Create Pakistan Players
-    Player* babar = new Player("Babar Azam", 29, "Pakistan", "PAK001", 56);
+    Player* babar = registry->createPlayer("Babar Azam", 29, "Pakistan", "PAK001", 56);
     babar->setBattingStyle("Right-handed");
     babar->addRole(PlayerRole::BATSMAN);
     babar->addRole(PlayerRole::CAPTAIN);
@@ -58,65 +61,65 @@ void createTeamsWithPlayers(Team*& pakistan, Team*& india) {
     pakistan->addToPlayingXI(babar);
     pakistan->setCaptain(babar);
     
-    Player* rizwan = new Player("Mohammad Rizwan", 31, "Pakistan", "PAK002", 7);
+    Player* rizwan = registry->createPlayer("Mohammad Rizwan", 31, "Pakistan", "PAK002", 7);
     rizwan->setBattingStyle("Right-handed");
     rizwan->addRole(PlayerRole::WICKETKEEPER_BATSMAN);
     pakistan->addPlayer(rizwan);
     pakistan->addToPlayingXI(rizwan);
     
-    Player* shaheen = new Player("Shaheen Afridi", 24, "Pakistan", "PAK003", 10);
+    Player* shaheen = registry->createPlayer("Shaheen Afridi", 24, "Pakistan", "PAK003", 10);
     shaheen->setBattingStyle("Left-handed");
     shaheen->setBowlingStyle("Left-arm Fast");
     shaheen->addRole(PlayerRole::BOWLER);
     pakistan->addPlayer(shaheen);
     pakistan->addToPlayingXI(shaheen);
     
-    Player* fakhar = new Player("Fakhar Zaman", 33, "Pakistan", "PAK004", 9);
+    Player* fakhar = registry->createPlayer("Fakhar Zaman", 33, "Pakistan", "PAK004", 9);
     fakhar->setBattingStyle("Left-handed");
     fakhar->addRole(PlayerRole::BATSMAN);
     pakistan->addPlayer(fakhar);
     pakistan->addToPlayingXI(fakhar);
     
-    Player* shadab = new Player("Shadab Khan", 25, "Pakistan", "PAK005", 4);
+    Player* shadab = registry->createPlayer("Shadab Khan", 25, "Pakistan", "PAK005", 4);
     shadab->setBattingStyle("Right-handed");
     shadab->setBowlingStyle("Leg-spin");
     shadab->addRole(PlayerRole::ALLROUNDER);
     pakistan->addPlayer(shadab);
     pakistan->addToPlayingXI(shadab);
     
-    Player* haris = new Player("Haris Rauf", 30, "Pakistan", "PAK006", 14);
+    Player* haris = registry->createPlayer("Haris Rauf", 30, "Pakistan", "PAK006", 14);
     haris->setBowlingStyle("Right-arm Fast");
     haris->addRole(PlayerRole::BOWLER);
     pakistan->addPlayer(haris);
     pakistan->addToPlayingXI(haris);
     
-    Player* iftikhar = new Player("Iftikhar Ahmed", 33, "Pakistan", "PAK007", 27);
+    Player* iftikhar = registry->createPlayer("Iftikhar Ahmed", 33, "Pakistan", "PAK007", 27);
     iftikhar->setBattingStyle("Right-handed");
     iftikhar->setBowlingStyle("Off-spin");
     iftikhar->addRole(PlayerRole::ALLROUNDER);
     pakistan->addPlayer(iftikhar);
     pakistan->addToPlayingXI(iftikhar);
     
-    Player* nawaz = new Player("Mohammad Nawaz", 29, "Pakistan", "PAK008", 18);
+    Player* nawaz = registry->createPlayer("Mohammad Nawaz", 29, "Pakistan", "PAK008", 18);
     nawaz->setBattingStyle("Left-handed");
     nawaz->setBowlingStyle("Left-arm Orthodox");
     nawaz->addRole(PlayerRole::ALLROUNDER);
     pakistan->addPlayer(nawaz);
     pakistan->addToPlayingXI(nawaz);
     
-    Player* imam = new Player("Imam-ul-Haq", 28, "Pakistan", "PAK009", 12);
+    Player* imam = registry->createPlayer("Imam-ul-Haq", 28, "Pakistan", "PAK009", 12);
     imam->setBattingStyle("Left-handed");
     imam->addRole(PlayerRole::BATSMAN);
     pakistan->addPlayer(imam);
     pakistan->addToPlayingXI(imam);
     
-    Player* naseem = new Player("Naseem Shah", 21, "Pakistan", "PAK010", 3);
+    Player* naseem = registry->createPlayer("Naseem Shah", 21, "Pakistan", "PAK010", 3);
     naseem->setBowlingStyle("Right-arm Fast");
     naseem->addRole(PlayerRole::BOWLER);
     pakistan->addPlayer(naseem);
     pakistan->addToPlayingXI(naseem);
     
-    Player* usama = new Player("Usama Mir", 28, "Pakistan", "PAK011", 21);
+    Player* usama = registry->createPlayer("Usama Mir", 28, "Pakistan", "PAK011", 21);
     usama->setBowlingStyle("Leg-spin");
     usama->addRole(PlayerRole::BOWLER);
     pakistan->addPlayer(usama);
@@ -132,7 +135,7 @@ void createTeamsWithPlayers(Team*& pakistan, Team*& india) {
     india->setTeamColor("Blue");
     
     // Create India Players
-    Player* rohit = new Player("Rohit Sharma", 36, "India", "IND001", 45);
+    Player* rohit = registry->createPlayer("Rohit Sharma", 36, "India", "IND001", 45);
     rohit->setBattingStyle("Right-handed");
     rohit->addRole(PlayerRole::BATSMAN);
     rohit->addRole(PlayerRole::CAPTAIN);
@@ -140,65 +143,65 @@ void createTeamsWithPlayers(Team*& pakistan, Team*& india) {
     india->addToPlayingXI(rohit);
     india->setCaptain(rohit);
     
-    Player* virat = new Player("Virat Kohli", 35, "India", "IND002", 18);
+    Player* virat = registry->createPlayer("Virat Kohli", 35, "India", "IND002", 18);
     virat->setBattingStyle("Right-handed");
     virat->addRole(PlayerRole::BATSMAN);
     india->addPlayer(virat);
     india->addToPlayingXI(virat);
     
-    Player* bumrah = new Player("Jasprit Bumrah", 30, "India", "IND003", 93);
+    Player* bumrah = registry->createPlayer("Jasprit Bumrah", 30, "India", "IND003", 93);
     bumrah->setBattingStyle("Right-handed");
     bumrah->setBowlingStyle("Right-arm Fast");
     bumrah->addRole(PlayerRole::BOWLER);
     india->addPlayer(bumrah);
     india->addToPlayingXI(bumrah);
     
-    Player* gill = new Player("Shubman Gill", 24, "India", "IND004", 77);
+    Player* gill = registry->createPlayer("Shubman Gill", 24, "India", "IND004", 77);
     gill->setBattingStyle("Right-handed");
     gill->addRole(PlayerRole::BATSMAN);
     india->addPlayer(gill);
     india->addToPlayingXI(gill);
     
-    Player* pant = new Player("Rishabh Pant", 26, "India", "IND005", 17);
+    Player* pant = registry->createPlayer("Rishabh Pant", 26, "India", "IND005", 17);
     pant->setBattingStyle("Left-handed");
     pant->addRole(PlayerRole::WICKETKEEPER_BATSMAN);
     india->addPlayer(pant);
     india->addToPlayingXI(pant);
     
-    Player* jadeja = new Player("Ravindra Jadeja", 35, "India", "IND006", 8);
+    Player* jadeja = registry->createPlayer("Ravindra Jadeja", 35, "India", "IND006", 8);
     jadeja->setBattingStyle("Left-handed");
     jadeja->setBowlingStyle("Left-arm Orthodox");
     jadeja->addRole(PlayerRole::ALLROUNDER);
     india->addPlayer(jadeja);
     india->addToPlayingXI(jadeja);
     
-    Player* hardik = new Player("Hardik Pandya", 30, "India", "IND007", 33);
+    Player* hardik = registry->createPlayer("Hardik Pandya", 30, "India", "IND007", 33);
     hardik->setBattingStyle("Right-handed");
     hardik->setBowlingStyle("Right-arm Medium-fast");
     hardik->addRole(PlayerRole::ALLROUNDER);
     india->addPlayer(hardik);
     india->addToPlayingXI(hardik);
     
-    Player* kuldeep = new Player("Kuldeep Yadav", 29, "India", "IND008", 23);
+    Player* kuldeep = registry->createPlayer("Kuldeep Yadav", 29, "India", "IND008", 23);
     kuldeep->setBattingStyle("Left-handed");
     kuldeep->setBowlingStyle("Left-arm Wrist-spin");
     kuldeep->addRole(PlayerRole::BOWLER);
     india->addPlayer(kuldeep);
     india->addToPlayingXI(kuldeep);
     
-    Player* shami = new Player("Mohammed Shami", 33, "India", "IND009", 11);
+    Player* shami = registry->createPlayer("Mohammed Shami", 33, "India", "IND009", 11);
     shami->setBowlingStyle("Right-arm Fast");
     shami->addRole(PlayerRole::BOWLER);
     india->addPlayer(shami);
     india->addToPlayingXI(shami);
     
-    Player* siraj = new Player("Mohammed Siraj", 30, "India", "IND010", 13);
+    Player* siraj = registry->createPlayer("Mohammed Siraj", 30, "India", "IND010", 13);
     siraj->setBowlingStyle("Right-arm Fast");
     siraj->addRole(PlayerRole::BOWLER);
     india->addPlayer(siraj);
     india->addToPlayingXI(siraj);
     
-    Player* iyer = new Player("Shreyas Iyer", 29, "India", "IND011", 41);
+    Player* iyer = registry->createPlayer("Shreyas Iyer", 29, "India", "IND011", 41);
     iyer->setBattingStyle("Right-handed");
     iyer->addRole(PlayerRole::BATSMAN);
     india->addPlayer(iyer);
@@ -210,7 +213,7 @@ void createTeamsWithPlayers(Team*& pakistan, Team*& india) {
 }
 
 // Function to simulate a match with ball-by-ball recording
-void simulateMatch(Match* match, Scorebook* scorebook) {
+void simulateMatch(Match* match, Scorebook* scorebook, ScorebookNotifier& notifier) {
     cout << "\n========================================" << endl;
     cout << "  STARTING MATCH SIMULATION" << endl;
     cout << "========================================" << endl;
@@ -246,7 +249,7 @@ void simulateMatch(Match* match, Scorebook* scorebook) {
     Ball* ball1 = new Ball(1, 1, bowler1, innings1->getStriker(), innings1->getNonStriker());
     ball1->recordBall(BallOutcome::DOT_BALL, 0);
     ball1->setCommentary("Good length delivery, defended back to the bowler");
-    innings1->recordBall(ball1);
+    match->recordBall(ball1);
     
     // Simulate multiple users recording this ball
     ScoreEntry entry1a("user1", "Scorer Ali", 1, 1, BallOutcome::DOT_BALL, 0, 0, WicketType::NONE);
@@ -255,6 +258,7 @@ void simulateMatch(Match* match, Scorebook* scorebook) {
     scorebook->addScoreEntry(entry1a);
     scorebook->addScoreEntry(entry1b);
     scorebook->addScoreEntry(entry1c);
+    notifier.pollOnce();
     
     ball1->displayBall();
     
@@ -262,7 +266,7 @@ void simulateMatch(Match* match, Scorebook* scorebook) {
     Ball* ball2 = new Ball(1, 2, bowler1, innings1->getStriker(), innings1->getNonStriker());
     ball2->recordBall(BallOutcome::FOUR, 4);
     ball2->setCommentary("Brilliant cover drive! Races away to the boundary");
-    innings1->recordBall(ball2);
+    match->recordBall(ball2);
     
     // Users disagree on this ball!
     ScoreEntry entry2a("user1", "Scorer Ali", 1, 2, BallOutcome::FOUR, 4, 0, WicketType::NONE);
@@ -271,6 +275,7 @@ void simulateMatch(Match* match, Scorebook* scorebook) {
     scorebook->addScoreEntry(entry2a);
     scorebook->addScoreEntry(entry2b); // This creates a conflict!
     scorebook->addScoreEntry(entry2c);
+    notifier.pollOnce();
     
     ball2->displayBall();
     
@@ -278,17 +283,18 @@ void simulateMatch(Match* match, Scorebook* scorebook) {
     Ball* ball3 = new Ball(1, 3, bowler1, innings1->getStriker(), innings1->getNonStriker());
     ball3->recordBall(BallOutcome::SINGLE, 1);
     ball3->setCommentary("Pushed to mid-off for a quick single");
-    innings1->recordBall(ball3);
+    match->recordBall(ball3);
     
     ScoreEntry entry3("user1", "Scorer Ali", 1, 3, BallOutcome::SINGLE, 1, 0, WicketType::NONE);
     scorebook->addScoreEntry(entry3);
+    notifier.pollOnce();
     ball3->displayBall();
     
     // Ball 1.4 - ANOTHER CONFLICT
     Ball* ball4 = new Ball(1, 4, bowler1, innings1->getStriker(), innings1->getNonStriker());
     ball4->recordBall(BallOutcome::DOUBLE, 2);
     ball4->setCommentary("Nicely placed through the gap");
-    innings1->recordBall(ball4);
+    match->recordBall(ball4);
     
     // Another disagreement
     ScoreEntry entry4a("user1", "Scorer Ali", 1, 4, BallOutcome::DOUBLE, 2, 0, WicketType::NONE);
@@ -297,6 +303,7 @@ void simulateMatch(Match* match, Scorebook* scorebook) {
     scorebook->addScoreEntry(entry4a);
     scorebook->addScoreEntry(entry4b);
     scorebook->addScoreEntry(entry4c);
+    notifier.pollOnce();
     
     ball4->displayBall();
     
@@ -305,10 +312,11 @@ void simulateMatch(Match* match, Scorebook* scorebook) {
     ball5->recordBall(BallOutcome::WICKET, 0);
     ball5->recordWicket(WicketType::BOWLED);
     ball5->setCommentary("Cleaned him up! What a delivery from Bumrah!");
-    innings1->recordBall(ball5);
+    match->recordBall(ball5);
     
     ScoreEntry entry5("user1", "Scorer Ali", 1, 5, BallOutcome::WICKET, 0, 0, WicketType::BOWLED);
     scorebook->addScoreEntry(entry5);
+    notifier.pollOnce();
     ball5->displayBall();
     
     // Ball 1.6
@@ -318,10 +326,11 @@ void simulateMatch(Match* match, Scorebook* scorebook) {
     Ball* ball6 = new Ball(1, 6, bowler1, innings1->getStriker(), innings1->getNonStriker());
     ball6->recordBall(BallOutcome::DOT_BALL, 0);
     ball6->setCommentary("Solid defense from the new batsman");
-    innings1->recordBall(ball6);
+    match->recordBall(ball6);
     
     ScoreEntry entry6("user1", "Scorer Ali", 1, 6, BallOutcome::DOT_BALL, 0, 0, WicketType::NONE);
     scorebook->addScoreEntry(entry6);
+    notifier.pollOnce();
     ball6->displayBall();
     
     cout << "\n--- END OF OVER 1 ---" << endl;
@@ -334,53 +343,53 @@ void simulateMatch(Match* match, Scorebook* scorebook) {
     Ball* ball7 = new Ball(2, 1, bowler2, innings1->getStriker(), innings1->getNonStriker());
     ball7->recordBall(BallOutcome::SINGLE, 1);
     ball7->setCommentary("Tucked away for a single");
-    innings1->recordBall(ball7);
+    match->recordBall(ball7);
     ball7->displayBall();
     
     // Ball 2.2 - Wide
     Ball* ball8 = new Ball(2, 2, bowler2, innings1->getStriker(), innings1->getNonStriker());
     ball8->recordBall(BallOutcome::WIDE, 0, 1);
     ball8->setCommentary("Wide down the leg side");
-    innings1->recordBall(ball8);
+    match->recordBall(ball8);
     ball8->displayBall();
     
     // Ball 2.2 (re-bowled)
     Ball* ball9 = new Ball(2, 2, bowler2, innings1->getStriker(), innings1->getNonStriker());
     ball9->recordBall(BallOutcome::SIX, 6);
     ball9->setCommentary("MASSIVE SIX! That's out of the ground!");
-    innings1->recordBall(ball9);
+    match->recordBall(ball9);
     ball9->displayBall();
     
     // Continue with a few more balls...
     Ball* ball10 = new Ball(2, 3, bowler2, innings1->getStriker(), innings1->getNonStriker());
     ball10->recordBall(BallOutcome::FOUR, 4);
     ball10->setCommentary("Beautiful shot through covers!");
-    innings1->recordBall(ball10);
+    match->recordBall(ball10);
     ball10->displayBall();
     
     Ball* ball11 = new Ball(2, 4, bowler2, innings1->getStriker(), innings1->getNonStriker());
     ball11->recordBall(BallOutcome::SINGLE, 1);
     ball11->setCommentary("Works it to square leg");
-    innings1->recordBall(ball11);
+    match->recordBall(ball11);
     ball11->displayBall();
     
     Ball* ball12 = new Ball(2, 5, bowler2, innings1->getStriker(), innings1->getNonStriker());
     ball12->recordBall(BallOutcome::DOUBLE, 2);
     ball12->setCommentary("Good running between the wickets");
-    innings1->recordBall(ball12);
+    match->recordBall(ball12);
     ball12->displayBall();
     
     Ball* ball13 = new Ball(2, 6, bowler2, innings1->getStriker(), innings1->getNonStriker());
     ball13->recordBall(BallOutcome::DOT_BALL, 0);
     ball13->setCommentary("Dot ball to end the over");
-    innings1->recordBall(ball13);
+    match->recordBall(ball13);
     ball13->displayBall();
     
     cout << "\n--- END OF OVER 2 ---" << endl;
 }
 
 // Function to demonstrate conflict resolution
-void demonstrateConflictResolution(Scorebook* scorebook, Supervisor* supervisor) {
+void demonstrateConflictResolution(Scorebook* scorebook, Supervisor* supervisor, ScorebookNotifier& notifier) {
     cout << "\n========================================" << endl;
     cout << "  CONFLICT RESOLUTION DEMONSTRATION" << endl;
     cout << "========================================" << endl;
@@ -396,6 +405,7 @@ void demonstrateConflictResolution(Scorebook* scorebook, Supervisor* supervisor)
     ScoreEntry correctEntry1("supervisor", supervisor->getName(), 1, 2, 
                             BallOutcome::FOUR, 4, 0, WicketType::NONE);
     bool resolved1 = scorebook->resolveConflict(1, 2, correctEntry1);
+    notifier.pollOnce();
     
     if(resolved1) {
         cout << "✓ Conflict 1 resolved successfully!" << endl;
@@ -405,6 +415,7 @@ void demonstrateConflictResolution(Scorebook* scorebook, Supervisor* supervisor)
     ScoreEntry correctEntry2("supervisor", supervisor->getName(), 1, 4,
                             BallOutcome::DOUBLE, 2, 0, WicketType::NONE);
     bool resolved2 = scorebook->resolveConflict(1, 4, correctEntry2);
+    notifier.pollOnce();
     
     if(resolved2) {
         cout << "✓ Conflict 2 resolved successfully!" << endl;
@@ -428,9 +439,10 @@ int main() {
     venue->setFloodlights(true);
     
     // Create Teams
+    PlayerRegistry* registry = new PlayerRegistry();
     Team* pakistan = nullptr;
     Team* india = nullptr;
-    createTeamsWithPlayers(pakistan, india);
+    createTeamsWithPlayers(registry, pakistan, india);
     
     // Create Match Officials
     Umpire* umpire1 = new Umpire("Aleem Dar", 55, "Pakistan", "UMP001", "On-field");
@@ -459,8 +471,17 @@ int main() {
     match->addBroadcaster(starSports);
     match->addBroadcaster(skySports);
     
-    // Create Scorebook
+    // Create Scorebook; deliveries and conflicts go out once on the match
+    // bus. Conflict messages reach the console through a notifier polled on
+    // this thread, so they print in order with the rest, and each
+    // broadcaster and commentator reads its own cursor when it catches up.
     Scorebook* scorebook = new Scorebook(match, supervisor);
+    EventBus matchBus;
+    ScorebookNotifier notifier(matchBus);
+    ConsoleConflictLogger consoleLogger;
+    scorebook->setEventBus(&matchBus);
+    notifier.addListener(&consoleLogger);
+    matchBus.attach(*match);
     
     // Display initial information
     cout << "\n";
@@ -486,21 +507,23 @@ int main() {
     india->displayTeam();
     
     // Simulate match
-    simulateMatch(match, scorebook);
+    simulateMatch(match, scorebook, notifier);
     
     // Display current state
     cout << "\n";
     match->displayMatchSummary();
     
     // Demonstrate conflict resolution
-    demonstrateConflictResolution(scorebook, supervisor);
+    demonstrateConflictResolution(scorebook, supervisor, notifier);
     
     // Display scorebook summary
     scorebook->displayScorebookSummary();
     
-    // Interactive menu
+    // Interactive menu; scorecards are rendered into one buffer per screen
+    ScorecardRenderer renderer;
     int choice;
     do {
+        notifier.pollOnce();
         displayMenu();
         cin >> choice;
         
@@ -516,10 +539,10 @@ int main() {
                 venue->displayVenueInfo();
                 break;
             case 4:
-                match->displayMatchSummary();
+                renderer.displaySummary(*match);
                 break;
             case 5:
-                match->displayFullMatch();
+                renderer.displayFullMatch(*match);
                 break;
             case 6:
                 scorebook->displayScorebookSummary();
@@ -535,9 +558,15 @@ int main() {
                 break;
             case 9:
                 cout << "\n--- Broadcasters ---" << endl;
-                ptvSports->displayInfo();
-                starSports->displayInfo();
-                skySports->displayInfo();
+                for(auto agency : match->getBroadcasters()) {
+                    matchBus.catchUp(*agency);
+                    agency->displayInfo();
+                }
+                cout << "\n--- Commentators ---" << endl;
+                for(auto commentator : match->getCommentators()) {
+                    matchBus.catchUp(*commentator);
+                    commentator->displayInfo();
+                }
                 break;
             case 0:
                 cout << "\nThank you for using FAST-SCOREBOOK!" << endl;
@@ -553,6 +582,7 @@ int main() {
     delete match; // This will also delete innings
     delete pakistan;
     delete india;
+    delete registry;
     delete venue;
     delete umpire1;
     delete umpire2;
@@ -0,0 +1,77 @@
+/*
+ * FAST-SCOREBOOK: Scoring Server
+ *
+ * Accepts scorer entries over a local socket and feeds them into a
+ * Scorebook, streaming deliveries, conflicts and resolutions back to
+ * subscribed clients. Runs until interrupted. With a scorer rate, each
+ * scorer is limited to that many entries per second (bursts of three
+ * seconds' worth) and the server to the global rate, and clients over
+ * their limit are told to back off.
+ *
+ * Usage: fast-scorebook-server <socket-path | port> [scorer-rate] [global-rate]
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include "../include/ScoringServer.h"
+
+using namespace std;
+
+#ifdef __linux__
+
+atomic<bool> stopRequested(false);
+
+void handleSignal(int) {
+    stopRequested.store(true);
+}
+
+int main(int argc, char* argv[]) {
+    if(argc < 2) {
+        cout << "Usage: " << argv[0] << " <socket-path | port> [scorer-rate] [global-rate]" << endl;
+        return 1;
+    }
+
+    Team home("Home XI", "Home");
+    Team away("Away XI", "Away");
+    Venue venue("Local Ground", "City", "Country", 10000);
+    T20Match match("LIVE_T20", &home, &away, &venue);
+    Supervisor supervisor("Match Supervisor", 45, "Country", "SUP1", "supervisor");
+    Scorebook scorebook(&match, &supervisor);
+
+    AdmissionControl admission;
+    if(argc > 2) {
+        double scorerRate = atof(argv[2]);
+        double globalRate = argc > 3 ? atof(argv[3]) : AdmissionPolicy().globalRate;
+        if(scorerRate <= 0 || globalRate <= 0) {
+            cout << "ERROR: rates must be positive" << endl;
+            return 1;
+        }
+        admission.setPolicy(AdmissionPolicy(scorerRate, scorerRate * 3, globalRate, globalRate * 3));
+        scorebook.setAdmissionControl(&admission);
+    }
+
+    ScoringServer server(scorebook);
+    if(!server.listen(argv[1])) {
+        cout << "ERROR: Could not listen on " << argv[1] << endl;
+        return 1;
+    }
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+    cout << "Scoring server listening on " << argv[1]
+         << (isTcpAddress(argv[1]) ? " (127.0.0.1)" : "") << ", Ctrl+C to stop" << endl;
+
+    server.run(stopRequested);
+    server.displayStats();
+    if(scorebook.getAdmissionControl()) admission.displayStats();
+    scorebook.displayScorebookSummary();
+    return 0;
+}
+
+#else
+
+int main() {
+    cout << "The scoring server needs epoll and is only available on Linux" << endl;
+    return 1;
+}
+
+#endif